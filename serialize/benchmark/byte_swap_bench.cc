@@ -0,0 +1,132 @@
+/*
+ * @Description: bulk byte swap of arithmetic arrays for swapped byte orders
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 11:40:05
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 11:40:05
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "detail/byte_swap.hpp"
+#include "serialize.hpp"
+
+namespace {
+
+struct big_endian_props {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment4;
+  static constexpr ByteOrderType kByteOrder = serialize::byte_order::kBigEndian;
+  static constexpr LengthFieldType kStringLengthField = 4u;
+  static constexpr LengthFieldType kArrayLengthField = 4u;
+  static constexpr LengthFieldType kUnionLengthField = 4u;
+  static constexpr LengthFieldType kStructLengthField = 0u;
+};
+
+template <typename T>
+std::vector<T> make_samples(std::size_t count) {
+  std::vector<T> ret(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    ret[i] = static_cast<T>(i);
+  }
+  return ret;
+}
+
+}  // namespace
+
+// the path taken before bulk kernels: one write_wrapper call per element
+template <typename T>
+static void BM_SwapPerElement(benchmark::State &state) {
+  using namespace serialize::detail;
+  auto src = make_samples<T>(static_cast<std::size_t>(state.range(0)));
+  std::vector<char> dst(src.size() * sizeof(T));
+  for (auto _ : state) {
+    memory_writer writer{dst.data()};
+    for (const auto &v : src) {
+      write_wrapper<!is_system_little_endian, sizeof(T)>(writer, (char *)&v);
+    }
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+      static_cast<int64_t>(static_cast<std::size_t>(state.iterations()) *
+                           dst.size()));
+}
+
+template <typename T>
+static void BM_SwapBulkScalar(benchmark::State &state) {
+  using namespace serialize::detail;
+  auto src = make_samples<T>(static_cast<std::size_t>(state.range(0)));
+  std::vector<char> dst(src.size() * sizeof(T));
+  for (auto _ : state) {
+    byte_swap_copy_scalar<sizeof(T)>(dst.data(), (const char *)src.data(),
+                                     src.size());
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+      static_cast<int64_t>(static_cast<std::size_t>(state.iterations()) *
+                           dst.size()));
+}
+
+template <typename T>
+static void BM_SwapBulk(benchmark::State &state) {
+  using namespace serialize::detail;
+  auto src = make_samples<T>(static_cast<std::size_t>(state.range(0)));
+  std::vector<char> dst(src.size() * sizeof(T));
+  for (auto _ : state) {
+    byte_swap_copy<sizeof(T)>(dst.data(), (const char *)src.data(),
+                              src.size());
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+      static_cast<int64_t>(static_cast<std::size_t>(state.iterations()) *
+                           dst.size()));
+}
+
+static void BM_SerializeBigEndianFloats(benchmark::State &state) {
+  auto samples = make_samples<float>(static_cast<std::size_t>(state.range(0)));
+  std::vector<char> buffer;
+  for (auto _ : state) {
+    buffer.clear();
+    serialize::serialize_to<big_endian_props>(buffer, samples);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(
+      static_cast<int64_t>(static_cast<std::size_t>(state.iterations()) *
+                           buffer.size()));
+}
+
+static void BM_DeserializeBigEndianFloats(benchmark::State &state) {
+  auto samples = make_samples<float>(static_cast<std::size_t>(state.range(0)));
+  auto buffer = serialize::serialize<big_endian_props>(samples);
+  std::vector<float> out;
+  for (auto _ : state) {
+    auto code = serialize::deserialize_to<big_endian_props>(out, buffer);
+    benchmark::DoNotOptimize(code);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(
+      static_cast<int64_t>(static_cast<std::size_t>(state.iterations()) *
+                           buffer.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_SwapPerElement, std::uint16_t)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_SwapBulkScalar, std::uint16_t)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_SwapBulk, std::uint16_t)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_SwapPerElement, float)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_SwapBulkScalar, float)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_SwapBulk, float)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_SwapPerElement, double)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_SwapBulkScalar, double)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_SwapBulk, double)->Arg(65536);
+BENCHMARK(BM_SerializeBigEndianFloats)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_DeserializeBigEndianFloats)->Arg(1024)->Arg(65536);
@@ -0,0 +1,249 @@
+/*
+ * @Description: encode and decode throughput of representative messages
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 22:30:17
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 22:30:17
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "serialize.hpp"
+#include "test/user_defined_struct.h"
+
+// every message is registered as
+//   BM_Encode/<byte order>/<length field>/<message>
+//   BM_Decode/<byte order>/<length field>/<message>
+// with one message per iteration, so the time column is ns/msg; bytes/s and
+// msgs/s (items_per_second) come from the counters. Compare one axis with
+// --benchmark_filter, e.g. --benchmark_filter='BM_Decode/le/.*/person3'.
+
+namespace {
+
+// one width for the string, array and union length fields
+template <serialize::byte_order order, std::uint8_t length_field,
+          std::uint8_t struct_length_field = 0u>
+struct codec_props {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment4;
+  static constexpr ByteOrderType kByteOrder = order;
+  static constexpr LengthFieldType kStringLengthField = length_field;
+  static constexpr LengthFieldType kArrayLengthField = length_field;
+  static constexpr LengthFieldType kUnionLengthField = length_field;
+  static constexpr LengthFieldType kStructLengthField = struct_length_field;
+};
+
+using variant_t = mpark::variant<std::int32_t, std::string, person1>;
+
+// payloads stay below 255 elements and characters, so every message can be
+// encoded with 1 byte length fields
+person1 make_person1() { return person1{42, 71.5, 7}; }
+
+A make_flat() { return A{1, 2, 3, B{4, 5}, 6}; }
+
+sensor_frame make_frame() {
+  return sensor_frame{1700000000123ull, {{0.5, -1.25, 9.81}}, 17, 3, 1, 255};
+}
+
+person3 make_nested() {
+  person3 ret{};
+  ret.p1 = make_person1();
+  ret.p2 = person2{30, 60.5, std::vector<int>(32, 9)};
+  return ret;
+}
+
+record_v2 make_record() {
+  return record_v2{99, "record-name", std::vector<int>(64, 3), make_person1()};
+}
+
+AA make_strings() {
+  return AA{1, std::string(24, 'b'), 2, std::string(96, 'e'), 3,
+            std::string(200, 'f')};
+}
+
+std::map<std::uint32_t, std::string> make_map() {
+  std::map<std::uint32_t, std::string> ret;
+  for (std::uint32_t i = 0; i < 64; ++i) {
+    ret.emplace(i * 7, "value-" + std::to_string(i));
+  }
+  return ret;
+}
+
+std::unordered_map<std::int32_t, person1> make_hash_map() {
+  std::unordered_map<std::int32_t, person1> ret;
+  for (std::int32_t i = 0; i < 64; ++i) {
+    ret.emplace(i, person1{i, i * 0.5, i + 1});
+  }
+  return ret;
+}
+
+std::vector<variant_t> make_variants() {
+  std::vector<variant_t> ret;
+  for (std::int32_t i = 0; i < 64; ++i) {
+    switch (i % 3) {
+      case 0:
+        ret.emplace_back(i);
+        break;
+      case 1:
+        ret.emplace_back("alt-" + std::to_string(i));
+        break;
+      default:
+        ret.emplace_back(person1{i, 1.0, i});
+        break;
+    }
+  }
+  return ret;
+}
+
+std::vector<tl::optional<person1>> make_optionals() {
+  std::vector<tl::optional<person1>> ret;
+  for (std::int32_t i = 0; i < 64; ++i) {
+    if (i % 2 == 0) {
+      ret.emplace_back(person1{i, 2.0, i});
+    } else {
+      ret.emplace_back(tl::nullopt);
+    }
+  }
+  return ret;
+}
+
+void report(benchmark::State &state, std::size_t size) {
+  auto iterations = static_cast<std::size_t>(state.iterations());
+  state.SetBytesProcessed(static_cast<int64_t>(iterations * size));
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.counters["bytes/msg"] = static_cast<double>(size);
+}
+
+// sizing plus writing into a buffer which is already allocated
+template <typename conf, typename T>
+void run_encode(benchmark::State &state, const T &item) {
+  auto size = serialize::get_needed_size<conf>(item);
+  std::vector<char> buffer(size);
+  for (auto _ : state) {
+    auto written =
+        serialize::serialize_to_buffer<conf>(buffer.data(), size, item);
+    benchmark::DoNotOptimize(written);
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  report(state, size);
+}
+
+// decoding over the previous result, as a receive loop does
+template <typename conf, typename T>
+void run_decode(benchmark::State &state, const T &item) {
+  auto buffer = serialize::serialize<conf>(item);
+  T out{};
+  if (serialize::deserialize_to<conf>(out, buffer) !=
+      serialize::return_code::ok) {
+    state.SkipWithError("decode failed");
+    return;
+  }
+  for (auto _ : state) {
+    auto code = serialize::deserialize_to<conf>(out, buffer);
+    benchmark::DoNotOptimize(code);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+  report(state, buffer.size());
+}
+
+template <typename conf, typename T>
+void register_message(const std::string &config, const std::string &name,
+                      T item) {
+  auto shared = std::make_shared<const T>(std::move(item));
+  benchmark::RegisterBenchmark(
+      ("BM_Encode/" + config + "/" + name).c_str(),
+      [shared](benchmark::State &state) { run_encode<conf>(state, *shared); });
+  benchmark::RegisterBenchmark(
+      ("BM_Decode/" + config + "/" + name).c_str(),
+      [shared](benchmark::State &state) { run_decode<conf>(state, *shared); });
+}
+
+template <typename conf>
+void register_config(const std::string &config) {
+  register_message<conf>(config, "person1", make_person1());
+  register_message<conf>(config, "flat", make_flat());
+  register_message<conf>(config, "sensor_frame", make_frame());
+  register_message<conf>(config, "person3", make_nested());
+  register_message<conf>(config, "record", make_record());
+  register_message<conf>(config, "strings", make_strings());
+  register_message<conf>(config, "map", make_map());
+  register_message<conf>(config, "hash_map", make_hash_map());
+  register_message<conf>(config, "variants", make_variants());
+  register_message<conf>(config, "optionals", make_optionals());
+}
+
+template <serialize::byte_order order>
+void register_widths(const std::string &prefix) {
+  register_config<codec_props<order, 1u>>(prefix + "/len1");
+  register_config<codec_props<order, 2u>>(prefix + "/len2");
+  register_config<codec_props<order, 4u>>(prefix + "/len4");
+  register_config<codec_props<order, 8u>>(prefix + "/len8");
+  register_config<codec_props<order, serialize::kVarintLengthField>>(
+      prefix + "/varint");
+  register_config<codec_props<order, 4u, 4u>>(prefix + "/len4_struct4");
+}
+
+template <typename conf>
+struct sorted_props : conf {
+  static constexpr bool kSortedKeys = true;
+};
+
+// a large routing table, as redistributed on topology changes. Decoding into
+// the ordered map is linear when the keys come sorted.
+using routing_table_t = std::unordered_map<std::uint32_t, std::string>;
+
+routing_table_t make_routing_table() {
+  routing_table_t ret;
+  for (std::uint32_t i = 0; i < 10000; ++i) {
+    ret.emplace(i * 2654435761u, "route-" + std::to_string(i));
+  }
+  return ret;
+}
+
+template <typename conf, typename Target>
+void run_decode_table(benchmark::State &state) {
+  auto buffer = serialize::serialize<conf>(make_routing_table());
+  Target out;
+  for (auto _ : state) {
+    auto code = serialize::deserialize_to<conf>(out, buffer);
+    benchmark::DoNotOptimize(code);
+    benchmark::ClobberMemory();
+  }
+  report(state, buffer.size());
+}
+
+template <typename conf>
+void register_routing_table(const std::string &config) {
+  using ordered_t = std::map<std::uint32_t, std::string>;
+  benchmark::RegisterBenchmark(
+      ("BM_DecodeRoutingTable/" + config + "/map").c_str(),
+      run_decode_table<conf, ordered_t>);
+  benchmark::RegisterBenchmark(
+      ("BM_DecodeRoutingTable/" + config + "/unordered_map").c_str(),
+      run_decode_table<conf, routing_table_t>);
+}
+
+const int registered = [] {
+  register_widths<serialize::byte_order::kLittleEndian>("le");
+  register_widths<serialize::byte_order::kBigEndian>("be");
+  using table_props = codec_props<serialize::byte_order::kLittleEndian, 4u>;
+  register_routing_table<table_props>("bucket_order");
+  register_routing_table<sorted_props<table_props>>("sorted_keys");
+  return 0;
+}();
+
+}  // namespace
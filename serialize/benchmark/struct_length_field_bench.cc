@@ -0,0 +1,125 @@
+/*
+ * @Description: nested struct encoding with kStructLengthField != 0
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 10:12:41
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 10:12:41
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "serialize.hpp"
+
+namespace {
+
+struct someip_props {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment4;
+  static constexpr ByteOrderType kByteOrder =
+      serialize::byte_order::kLittleEndian;
+  static constexpr LengthFieldType kStringLengthField = 4u;
+  static constexpr LengthFieldType kArrayLengthField = 4u;
+  static constexpr LengthFieldType kUnionLengthField = 4u;
+  static constexpr LengthFieldType kStructLengthField = 4u;
+};
+
+// only exposes write(), so the serializer has to size every struct up front
+struct forward_only_writer {
+  serialize::detail::memory_writer impl;
+  void write(const char *data, std::size_t len) { impl.write(data, len); }
+};
+
+}  // namespace
+
+struct bench_leaf {
+  std::uint32_t id;
+  double value;
+  std::string name;
+};
+SERIALIZE_REFL(bench_leaf, id, value, name);
+
+struct bench_level1 {
+  bench_leaf a;
+  bench_leaf b;
+  std::vector<std::int32_t> samples;
+};
+SERIALIZE_REFL(bench_level1, a, b, samples);
+
+struct bench_level2 {
+  bench_level1 a;
+  bench_level1 b;
+  std::uint64_t stamp;
+};
+SERIALIZE_REFL(bench_level2, a, b, stamp);
+
+struct bench_level3 {
+  bench_level2 a;
+  bench_level2 b;
+  std::string tag;
+};
+SERIALIZE_REFL(bench_level3, a, b, tag);
+
+struct bench_level4 {
+  bench_level3 a;
+  bench_level3 b;
+  std::uint16_t flags;
+};
+SERIALIZE_REFL(bench_level4, a, b, flags);
+
+namespace {
+
+bench_leaf make_leaf(std::uint32_t id) {
+  return bench_leaf{id, id * 0.5, "leaf-" + std::to_string(id)};
+}
+bench_level1 make_level1(std::uint32_t id) {
+  return bench_level1{make_leaf(id), make_leaf(id + 1),
+                      std::vector<std::int32_t>(16, static_cast<int>(id))};
+}
+bench_level2 make_level2(std::uint32_t id) {
+  return bench_level2{make_level1(id), make_level1(id + 2), id};
+}
+bench_level3 make_level3(std::uint32_t id) {
+  return bench_level3{make_level2(id), make_level2(id + 4), "level3"};
+}
+bench_level4 make_level4(std::uint32_t id) {
+  return bench_level4{make_level3(id), make_level3(id + 8), 0x5a5a};
+}
+
+template <typename Writer, typename T>
+void run_nested_struct(benchmark::State &state, const T &item) {
+  using namespace serialize::detail;
+  auto size = get_serialize_runtime_info<someip_props>(item);
+  std::vector<char> buffer(size);
+  for (auto _ : state) {
+    Writer writer{memory_writer{buffer.data()}};
+    serialize_to<someip_props>(writer, size, item);
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  auto iterations = static_cast<std::size_t>(state.iterations());
+  state.SetBytesProcessed(static_cast<int64_t>(iterations * size));
+}
+
+}  // namespace
+
+template <typename Writer>
+static void BM_NestedStruct2(benchmark::State &state) {
+  run_nested_struct<Writer>(state, make_level2(1));
+}
+template <typename Writer>
+static void BM_NestedStruct4(benchmark::State &state) {
+  run_nested_struct<Writer>(state, make_level4(1));
+}
+
+BENCHMARK_TEMPLATE(BM_NestedStruct2, forward_only_writer);
+BENCHMARK_TEMPLATE(BM_NestedStruct2, serialize::detail::memory_writer);
+BENCHMARK_TEMPLATE(BM_NestedStruct4, forward_only_writer);
+BENCHMARK_TEMPLATE(BM_NestedStruct4, serialize::detail::memory_writer);
@@ -18,6 +18,15 @@
 namespace serialize {
 namespace detail {
 
+// zero bytes which move `offset` to a multiple of min(align, kAlignment)
+template <typename conf>
+constexpr std::size_t inline aligned_padding_size(std::size_t offset,
+                                                  std::size_t align) {
+  std::size_t limit = static_cast<std::size_t>(conf::kAlignment);
+  std::size_t target = align < limit ? align : limit;
+  return (target - offset % target) % target;
+}
+
 template <alignment Align>
 constexpr std::size_t inline calculate_one_padding_size(std::size_t &offset) {
   return offset & (static_cast<std::size_t>(Align) - 1);
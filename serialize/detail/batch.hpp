@@ -0,0 +1,267 @@
+/*
+ * @Description: many values of one type in one buffer, with an offset index
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 21:40:52
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 21:40:52
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "detail/calculate_size.hpp"
+#include "detail/deserializer.hpp"
+#include "detail/endian_wrapper.hpp"
+#include "detail/fingerprint.hpp"
+#include "detail/macro.hpp"
+#include "detail/memory_reader.hpp"
+#include "detail/memory_writer.hpp"
+#include "detail/reflection.hpp"
+#include "detail/return_code.hpp"
+#include "detail/serializer.hpp"
+#include "ser_config.hpp"
+
+namespace serialize {
+namespace detail {
+
+// [type info] count:u64 index_width:u64 (stride:u64 | end offset * count)
+// then padding to 8 and the elements back to back. Every element is encoded
+// as if it was serialized alone, offsets count from the first element. Types
+// with a fixed size store one stride instead of the index.
+constexpr std::size_t kBatchHeaderSize = 2 * sizeof(std::uint64_t);
+constexpr std::size_t kBatchAlignment = 8;
+
+struct batch_layout {
+  std::uint64_t count = 0;
+  std::uint64_t index_width = 0;  // 0: every element takes `stride` bytes
+  std::uint64_t stride = 0;
+  const char *index = nullptr;
+  const char *elements = nullptr;
+  std::size_t elements_size = 0;
+};
+
+constexpr std::size_t batch_padding(std::size_t offset) {
+  return (kBatchAlignment - offset % kBatchAlignment) % kBatchAlignment;
+}
+
+// the aligned layout pads by position, so its sizes are only known per value
+template <typename conf, typename T>
+constexpr bool batch_fixed_stride =
+    fixed_size_v<conf, T> && !aligned_layout<conf>;
+
+// the stride every element of a batch of T takes, 0 when it needs an index
+template <typename conf, typename T,
+          std::enable_if_t<batch_fixed_stride<conf, T>, int> = 0>
+constexpr std::uint64_t batch_stride() {
+  constexpr auto plan = get_size_plan<conf, T>().size;
+  return plan.total + plan.length_field;
+}
+
+template <typename conf, typename T,
+          std::enable_if_t<!batch_fixed_stride<conf, T>, int> = 0>
+constexpr std::uint64_t batch_stride() {
+  return 0;
+}
+
+template <typename conf, typename T>
+std::size_t inline batch_value_size(const T &item) {
+  constexpr std::size_t header = type_info_enabled<conf> ? kTypeInfoSize : 0;
+  return get_serialize_runtime_info<conf>(item) - header;
+}
+
+template <typename conf, typename Container,
+          typename T = typename Container::value_type,
+          std::enable_if_t<batch_fixed_stride<conf, T>, int> = 0>
+std::uint64_t inline plan_batch(const Container &items, std::uint64_t &width,
+                                std::uint64_t &stride,
+                                std::vector<std::uint64_t> &) {
+  width = 0;
+  stride = batch_stride<conf, T>();
+  return stride * items.size();
+}
+
+template <typename conf, typename Container,
+          typename T = typename Container::value_type,
+          std::enable_if_t<!batch_fixed_stride<conf, T>, int> = 0>
+std::uint64_t inline plan_batch(const Container &items, std::uint64_t &width,
+                                std::uint64_t &stride,
+                                std::vector<std::uint64_t> &ends) {
+  std::uint64_t total = 0;
+  ends.reserve(items.size());
+  for (const auto &item : items) {
+    total += batch_value_size<conf>(item);
+    ends.push_back(total);
+  }
+  width = total > UINT32_MAX ? sizeof(std::uint64_t) : sizeof(std::uint32_t);
+  stride = 0;
+  return total;
+}
+
+template <typename conf, typename Buffer, typename Container>
+void serialize_batch_to(Buffer &buffer, const Container &items) {
+  using value_type = typename Container::value_type;
+  constexpr bool is_little_endian =
+      conf::kByteOrder == byte_order::kLittleEndian;
+  constexpr std::size_t header =
+      (type_info_enabled<conf> ? kTypeInfoSize : 0) + kBatchHeaderSize;
+  std::uint64_t count = items.size();
+  std::uint64_t width = 0;
+  std::uint64_t stride = 0;
+  std::vector<std::uint64_t> ends;
+  std::uint64_t total = plan_batch<conf>(items, width, stride, ends);
+  std::size_t index_size = width == 0 ? sizeof(stride) : count * width;
+  std::size_t padding = batch_padding(header + index_size);
+
+  auto base = buffer.size();
+  buffer.resize(base + header + index_size + padding + total);
+  memory_writer writer{(char *)buffer.data() + base};
+  if (type_info_enabled<conf>) {
+    constexpr std::uint64_t fingerprint = get_type_fingerprint<value_type>();
+    write_wrapper<is_little_endian, kTypeInfoSize>(writer,
+                                                   (char *)&fingerprint);
+  }
+  write_wrapper<is_little_endian, 8>(writer, (char *)&count);
+  write_wrapper<is_little_endian, 8>(writer, (char *)&width);
+  if (width == 0) {
+    write_wrapper<is_little_endian, 8>(writer, (char *)&stride);
+  } else if (width == sizeof(std::uint32_t)) {
+    for (auto end : ends) {
+      auto end32 = static_cast<std::uint32_t>(end);
+      write_wrapper<is_little_endian, 4>(writer, (char *)&end32);
+    }
+  } else {
+    for (auto end : ends) {
+      write_wrapper<is_little_endian, 8>(writer, (char *)&end);
+    }
+  }
+  constexpr std::array<char, kBatchAlignment> zeros{};
+  writer.write(zeros.data(), padding);
+
+  std::size_t info = stride;
+  std::size_t i = 0;
+  for (const auto &item : items) {
+    if (width != 0) {
+      info = ends[i] - (i == 0 ? 0 : ends[i - 1]);
+    }
+    Serializer<memory_writer, conf> o(writer, info);
+    o.serialize_values(item);
+    ++i;
+  }
+}
+
+template <typename conf, typename T>
+serialize::return_code parse_batch(const char *data, std::size_t size,
+                                   batch_layout &batch) {
+  constexpr bool is_little_endian =
+      conf::kByteOrder == byte_order::kLittleEndian;
+  memory_reader reader{data, data + size};
+  if (type_info_enabled<conf>) {
+    std::uint64_t fingerprint = 0;
+    if SER_UNLIKELY ((!read_wrapper<is_little_endian, kTypeInfoSize>(
+                         reader, (char *)&fingerprint))) {
+      return return_code::no_buffer_space;
+    }
+    if SER_UNLIKELY (fingerprint != get_type_fingerprint<T>()) {
+      return return_code::type_mismatch;
+    }
+  }
+  if SER_UNLIKELY (
+      (!read_wrapper<is_little_endian, 8>(reader, (char *)&batch.count) ||
+       !read_wrapper<is_little_endian, 8>(reader, (char *)&batch.index_width))) {
+    return return_code::no_buffer_space;
+  }
+  auto left = static_cast<std::size_t>(reader.end - reader.now);
+  if (batch.index_width == 0) {
+    if SER_UNLIKELY ((!read_wrapper<is_little_endian, 8>(
+                         reader, (char *)&batch.stride))) {
+      return return_code::no_buffer_space;
+    }
+    // only the stride bounds the count, so it has to be the one T is
+    // written with; a type without one always gets an index
+    if SER_UNLIKELY ((batch.stride == 0 ||
+                      batch.stride != batch_stride<conf, T>())) {
+      return return_code::invalid_buffer;
+    }
+  } else if SER_UNLIKELY (batch.index_width != sizeof(std::uint32_t) &&
+                          batch.index_width != sizeof(std::uint64_t)) {
+    return return_code::invalid_buffer;
+  } else if SER_UNLIKELY (batch.count > left / batch.index_width) {
+    return return_code::no_buffer_space;
+  } else {
+    batch.index = reader.read_view(batch.count * batch.index_width);
+  }
+  auto consumed = static_cast<std::size_t>(reader.now - data);
+  if SER_UNLIKELY (!reader.ignore(batch_padding(consumed))) {
+    return return_code::no_buffer_space;
+  }
+  batch.elements = reader.now;
+  batch.elements_size = static_cast<std::size_t>(reader.end - reader.now);
+  if SER_UNLIKELY (batch.index_width == 0 &&
+                   batch.count > batch.elements_size / batch.stride) {
+    return return_code::no_buffer_space;
+  }
+  return return_code::ok;
+}
+
+template <typename conf>
+std::uint64_t inline batch_end_offset(const batch_layout &batch,
+                                      std::size_t index) {
+  constexpr bool is_little_endian =
+      conf::kByteOrder == byte_order::kLittleEndian;
+  const char *at = batch.index + index * batch.index_width;
+  memory_reader reader{at, at + batch.index_width};
+  if (batch.index_width == sizeof(std::uint32_t)) {
+    std::uint32_t end32 = 0;
+    read_wrapper<is_little_endian, 4>(reader, (char *)&end32);
+    return end32;
+  }
+  std::uint64_t end64 = 0;
+  read_wrapper<is_little_endian, 8>(reader, (char *)&end64);
+  return end64;
+}
+
+// one index lookup, the elements in front are not touched
+template <typename conf>
+serialize::return_code batch_element(const batch_layout &batch,
+                                     std::size_t index, const char *&begin,
+                                     std::size_t &len) {
+  if SER_UNLIKELY (index >= batch.count) {
+    return return_code::out_of_range;
+  }
+  if (batch.index_width == 0) {
+    begin = batch.elements + index * batch.stride;
+    len = batch.stride;
+    return return_code::ok;
+  }
+  std::uint64_t start =
+      index == 0 ? 0 : batch_end_offset<conf>(batch, index - 1);
+  std::uint64_t end = batch_end_offset<conf>(batch, index);
+  if SER_UNLIKELY (start > end || end > batch.elements_size) {
+    return return_code::invalid_buffer;
+  }
+  begin = batch.elements + start;
+  len = end - start;
+  return return_code::ok;
+}
+
+template <typename conf, typename T>
+serialize::return_code deserialize_batch_element(const batch_layout &batch,
+                                                 std::size_t index, T &item) {
+  const char *begin = nullptr;
+  std::size_t len = 0;
+  auto code = batch_element<conf>(batch, index, begin, len);
+  if SER_UNLIKELY (code != return_code::ok) {
+    return code;
+  }
+  memory_reader reader{begin, begin + len};
+  Deserializer<memory_reader, conf> in(reader);
+  return in.deserialize_values(item);
+}
+
+}  // namespace detail
+}  // namespace serialize
@@ -0,0 +1,125 @@
+/*
+ * @Description: bulk byte swap kernels for arrays of 2/4/8 byte elements
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 11:02:17
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 11:02:17
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+namespace serialize {
+namespace detail {
+
+// element types which can be swapped as a plain block of bytes
+template <typename T>
+constexpr bool bulk_swappable =
+    (std::is_arithmetic<T>::value || std::is_enum<T>::value) &&
+    (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+template <std::size_t block_size>
+struct byte_swap_scalar;
+
+template <>
+struct byte_swap_scalar<2> {
+  static inline void run(char *dst, const char *src) {
+    std::uint16_t v;
+    std::memcpy(&v, src, sizeof(v));
+    v = __builtin_bswap16(v);
+    std::memcpy(dst, &v, sizeof(v));
+  }
+};
+
+template <>
+struct byte_swap_scalar<4> {
+  static inline void run(char *dst, const char *src) {
+    std::uint32_t v;
+    std::memcpy(&v, src, sizeof(v));
+    v = __builtin_bswap32(v);
+    std::memcpy(dst, &v, sizeof(v));
+  }
+};
+
+template <>
+struct byte_swap_scalar<8> {
+  static inline void run(char *dst, const char *src) {
+    std::uint64_t v;
+    std::memcpy(&v, src, sizeof(v));
+    v = __builtin_bswap64(v);
+    std::memcpy(dst, &v, sizeof(v));
+  }
+};
+
+/// @brief swap `count` elements of `block_size` bytes from src into dst one
+///        by one. dst may be equal to src.
+template <std::size_t block_size>
+inline void byte_swap_copy_scalar(char *dst, const char *src,
+                                  std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    byte_swap_scalar<block_size>::run(dst, src);
+    dst += block_size;
+    src += block_size;
+  }
+}
+
+#if defined(__SSSE3__)
+// pshufb control that reverses the bytes of every block inside a 16 byte lane
+template <std::size_t block_size>
+inline __m128i byte_swap_mask128() {
+  alignas(16) char mask[16];
+  for (std::size_t i = 0; i < 16; ++i) {
+    mask[i] = static_cast<char>(i - i % block_size + block_size - 1 -
+                                i % block_size);
+  }
+  return _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+}
+#endif
+
+/// @brief swap `count` elements of `block_size` bytes from src into dst using
+///        AVX2/SSSE3 shuffles when the target supports them, the tail is
+///        finished by the scalar loop. dst may be equal to src.
+template <std::size_t block_size>
+inline void byte_swap_copy(char *dst, const char *src, std::size_t count) {
+  static_assert(block_size == 2 || block_size == 4 || block_size == 8,
+                "illegal block size(should be 2,4,8)");
+  std::size_t bytes = count * block_size;
+  std::size_t done = 0;
+#if defined(__SSSE3__)
+  const __m128i mask128 = byte_swap_mask128<block_size>();
+#if defined(__AVX2__)
+  const __m256i mask256 = _mm256_broadcastsi128_si256(mask128);
+  for (; done + 64 <= bytes; done += 64) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+    __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                        _mm256_shuffle_epi8(a, mask256));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 32),
+                        _mm256_shuffle_epi8(b, mask256));
+    src += 64;
+    dst += 64;
+  }
+#endif
+  for (; done + 16 <= bytes; done += 16) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_shuffle_epi8(a, mask128));
+    src += 16;
+    dst += 16;
+  }
+#endif
+  byte_swap_copy_scalar<block_size>(dst, src, (bytes - done) / block_size);
+}
+
+}  // namespace detail
+}  // namespace serialize
@@ -11,9 +11,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <tuple>
+#include <utility>
 
 #include "append_types/apply.hpp"
+#include "endian_wrapper.hpp"
 #include "macro.hpp"
+#include "ser_config.hpp"
 #include "size_info.hpp"
 #include "type_id.hpp"
 
@@ -24,8 +29,202 @@ namespace detail {
 template <typename conf, typename... Args>
 constexpr size_info inline calculate_payload_size(const Args &...items);
 
+// bytes taken by a length field carrying `value`
+template <std::uint8_t length_field>
+constexpr std::size_t inline length_field_size(std::uint64_t value) {
+  return length_field == kVarintLengthField ? varint_size(value)
+                                            : length_field;
+}
+
+template <typename conf, typename T>
+constexpr size_plan get_size_plan();
+
+// member count, tags and member lengths of a tagged struct
+template <typename conf, typename T>
+constexpr std::size_t inline tagged_struct_overhead() {
+  if (!tagged_struct<conf>) {
+    return 0;
+  }
+  constexpr auto count = members_count<T>();
+  std::size_t size = varint_size(count);
+  for (std::size_t tag = 1; tag <= count; ++tag) {
+    size += varint_size(tag) + kTaggedMemberLengthField;
+  }
+  return size;
+}
+
+template <typename conf, typename... Args>
+constexpr size_plan inline get_size_plan_many() {
+  const size_plan plans[] = {size_plan{true, {0, 0}},
+                             get_size_plan<conf, Args>()...};
+  size_plan plan{true, {0, 0}};
+  for (const auto &one : plans) {
+    plan.fixed = plan.fixed && one.fixed;
+    plan.size += one.size;
+  }
+  return plan;
+}
+
+template <typename conf, typename T, std::size_t... I>
+constexpr size_plan inline get_size_plan_tuple(std::index_sequence<I...>) {
+  return get_size_plan_many<conf, std::tuple_element_t<I, T>...>();
+}
+
+template <typename conf, typename T, std::size_t N>
+constexpr size_plan inline get_size_plan_array() {
+  using value_type = std::remove_extent_t<remove_cvref_t<
+      decltype(*std::begin(std::declval<T &>()))>>;
+  // keep in step with Serializer: copyable arrays are written in one block
+  if (is_trivial_serializable<T>::value &&
+      is_little_endian_copyable<conf::kByteOrder == byte_order::kLittleEndian,
+                                sizeof(value_type)>) {
+    return size_plan{true, {sizeof(T), 0}};
+  }
+  auto plan = get_size_plan<conf, value_type>();
+  plan.size.total *= N;
+  plan.size.length_field *= N;
+  return plan;
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<
+              std::is_fundamental<T>::value || std::is_enum<T>::value ||
+                  id == type_id::int128_t || id == type_id::uint128_t ||
+                  id == type_id::bitset_t,
+              int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return size_plan{true, {sizeof(T), 0}};
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::array_t && array<T>, int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return get_size_plan_array<conf, T, std::tuple_size<T>::value>();
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::array_t && c_array<T>, int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return get_size_plan_array<conf, T, std::extent<T>::value>();
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::pair_t, int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return get_size_plan_many<conf, typename T::first_type,
+                            typename T::second_type>();
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::tuple_t, int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return get_size_plan_tuple<conf, T>(
+      std::make_index_sequence<std::tuple_size<T>::value>{});
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::struct_t, int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  using types = decltype(get_types<T>());
+  static_assert(conf::kStructLengthField != kVarintLengthField,
+                "struct length fields are backpatched, they can't be varints");
+  auto plan = get_size_plan_tuple<conf, types>(
+      std::make_index_sequence<std::tuple_size<types>::value>{});
+  plan.size.length_field +=
+      conf::kStructLengthField + tagged_struct_overhead<conf, T>();
+  return plan;
+}
+
+// shortest length field: a varint takes at least one byte
+template <std::uint8_t length_field>
+constexpr std::size_t inline min_length_field_size() {
+  return length_field == kVarintLengthField ? 1 : length_field;
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::string_t, int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return size_plan{false,
+                   {sizeof(typename T::value_type),
+                    min_length_field_size<conf::kStringLengthField>()}};
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::container_t ||
+                               id == type_id::map_container_t ||
+                               id == type_id::set_container_t,
+                           int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return size_plan{false,
+                   {0, min_length_field_size<conf::kArrayLengthField>()}};
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::variant_t, int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return size_plan{false,
+                   {0, min_length_field_size<conf::kUnionLengthField>()}};
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::optional_t ||
+                               id == type_id::expected_t || varint_type<T>,
+                           int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return size_plan{false, {1, 0}};
+}
+
+template <typename conf, typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<
+              !(std::is_fundamental<T>::value || std::is_enum<T>::value ||
+                id == type_id::int128_t || id == type_id::uint128_t ||
+                id == type_id::bitset_t || id == type_id::pair_t ||
+                id == type_id::tuple_t || id == type_id::struct_t ||
+                id == type_id::string_t || id == type_id::container_t ||
+                id == type_id::map_container_t ||
+                id == type_id::set_container_t || id == type_id::variant_t ||
+                id == type_id::optional_t || id == type_id::expected_t ||
+                varint_type<T> ||
+                (id == type_id::array_t && (array<T> || c_array<T>))),
+              int> = 0>
+constexpr size_plan inline get_size_plan_impl() {
+  return size_plan{false, {0, 0}};
+}
+
+template <typename conf, typename T>
+constexpr size_plan get_size_plan() {
+  return get_size_plan_impl<conf, remove_cvref_t<T>>();
+}
+
+template <typename conf, typename T>
+constexpr bool fixed_size_v = get_size_plan<conf, T>().fixed;
+
+// fewest bytes a value of T takes, bounds the element count a length field
+// can plausibly announce for the bytes left. Structs with a length field or
+// tags may come from an older writer with fewer members, so under such
+// configs anything that can't be empty only counts for one byte.
+template <typename conf, typename T>
+constexpr std::size_t min_encoded_size() {
+  constexpr auto plan = get_size_plan<conf, T>();
+  constexpr std::size_t size = plan.size.total + plan.size.length_field;
+  return conf::kStructLengthField == 0 && !tagged_struct<conf>
+             ? size
+             : (size != 0 ? 1 : 0);
+}
+
 template <typename conf>
 struct calculate_one_size {
+  // the encoded size of the type is known at compile time, skip the walk
+  template <typename T, typename type = remove_cvref_t<T>,
+            type_id id = get_type_id<remove_cvref_t<T>>(),
+            std::enable_if_t<(id == type_id::array_t || id == type_id::pair_t ||
+                              id == type_id::tuple_t ||
+                              id == type_id::struct_t) &&
+                                 fixed_size_v<conf, type>,
+                             int> = 0>
+  constexpr size_info inline operator()(const T &) {
+    return get_size_plan<conf, type>().size;
+  }
   template <typename T, typename type = remove_cvref_t<T>,
             type_id id = get_type_id<remove_cvref_t<T>>(),
             std::enable_if_t<
@@ -38,6 +237,14 @@ struct calculate_one_size {
     info.total = sizeof(remove_cvref_t<decltype(item)>);
     return info;
   }
+  template <typename T, typename type = remove_cvref_t<T>,
+            type_id id = get_type_id<remove_cvref_t<T>>(),
+            std::enable_if_t<varint_type<type>, int> = 0>
+  constexpr size_info inline operator()(const T &item) {
+    size_info info{};
+    info.total = varint_size(varint_encode_value(item.value));
+    return info;
+  }
   template <typename T, typename type = remove_cvref_t<T>,
             type_id id = get_type_id<remove_cvref_t<T>>(),
             std::enable_if_t<is_trivial_view_v<type>, int> = 0>
@@ -51,8 +258,9 @@ struct calculate_one_size {
             std::enable_if_t<id == type_id::string_t, int> = 0>
   constexpr size_info inline operator()(const T &item) {
     size_info ret{};
-    ret.length_field += conf::kStringLengthField;
-    ret.total = item.size() + 1;
+    ret.length_field +=
+        length_field_size<conf::kStringLengthField>(item.size() + 1);
+    ret.total = (item.size() + 1) * sizeof(typename type::value_type);
     return ret;
   }
 
@@ -66,7 +274,8 @@ struct calculate_one_size {
                              int> = 0>
   constexpr size_info inline operator()(const T &item) {
     size_info ret{};
-    ret.length_field += conf::kArrayLengthField;
+    ret.length_field +=
+        length_field_size<conf::kArrayLengthField>(item.size());
     using value_type = typename type::value_type;
     ret.total = item.size() * sizeof(value_type);
     return ret;
@@ -81,7 +290,8 @@ struct calculate_one_size {
                              int> = 0>
   constexpr size_info inline operator()(const T &item) {
     size_info ret{};
-    ret.length_field += conf::kArrayLengthField;
+    ret.length_field +=
+        length_field_size<conf::kArrayLengthField>(item.size());
     for (auto &&i : item) {
       ret += calculate_one_size()(i);
     }
@@ -91,7 +301,8 @@ struct calculate_one_size {
   template <typename T, typename type = remove_cvref_t<T>,
             type_id id = get_type_id<type>(),
             std::enable_if_t<(id == type_id::array_t &&
-                              is_trivial_serializable<type>::value),
+                              is_trivial_serializable<type>::value) &&
+                                 !fixed_size_v<conf, type>,
                              int> = 0>
   constexpr size_info inline operator()(const T &item) {
     size_info info{};
@@ -102,7 +313,8 @@ struct calculate_one_size {
   template <typename T, typename type = remove_cvref_t<T>,
             type_id id = get_type_id<type>(),
             std::enable_if_t<id == type_id::array_t &&
-                                 !is_trivial_serializable<type>::value,
+                                 !is_trivial_serializable<type>::value &&
+                                 !fixed_size_v<conf, type>,
                              int> = 0>
   constexpr size_info inline operator()(const T &item) {
     size_info info{};
@@ -115,7 +327,8 @@ struct calculate_one_size {
   // pair
   template <typename T, typename type = remove_cvref_t<T>,
             type_id id = get_type_id<remove_cvref_t<T>>(),
-            std::enable_if_t<id == type_id::pair_t, int> = 0>
+            std::enable_if_t<id == type_id::pair_t && !fixed_size_v<conf, type>,
+                             int> = 0>
   constexpr size_info inline operator()(const T &item) {
     size_info ret{};
     ret += calculate_one_size()(item.first);
@@ -126,7 +339,9 @@ struct calculate_one_size {
   // tuple
   template <typename T, typename type = remove_cvref_t<T>,
             type_id id = get_type_id<remove_cvref_t<T>>(),
-            std::enable_if_t<id == type_id::tuple_t, int> = 0>
+            std::enable_if_t<id == type_id::tuple_t &&
+                                 !fixed_size_v<conf, type>,
+                             int> = 0>
   constexpr size_info inline operator()(const T &item) {
     size_info ret{};
     tl::apply(
@@ -141,7 +356,8 @@ struct calculate_one_size {
             std::enable_if_t<id == type_id::variant_t, int> = 0>
   constexpr size_info inline operator()(const T &item) {
     size_info ret{};
-    ret.length_field += conf::kUnionLengthField;
+    ret.length_field +=
+        length_field_size<conf::kUnionLengthField>(item.index());
     ret += mpark::visit([](const auto &e) { return calculate_one_size()(e); },
                         item);
     return ret;
@@ -150,17 +366,48 @@ struct calculate_one_size {
   // struct
   template <typename T, typename type = remove_cvref_t<T>,
             type_id id = get_type_id<remove_cvref_t<T>>(),
-            std::enable_if_t<id == type_id::struct_t, int> = 0>
+            std::enable_if_t<id == type_id::struct_t &&
+                                 !fixed_size_v<conf, type>,
+                             int> = 0>
   constexpr size_info inline operator()(const T &item) {
     size_info ret{};
-    ret.length_field += conf::kStructLengthField;
+    ret.length_field +=
+        conf::kStructLengthField + tagged_struct_overhead<conf, type>();
     visit_members(item, [&](auto &&...items) {
       ret += calculate_payload_size<conf>(items...);
     });
     return ret;
   }
 
-  // struct
+  // optional: the has_value flag, then the value if there is one
+  template <typename T, typename type = remove_cvref_t<T>,
+            type_id id = get_type_id<remove_cvref_t<T>>(),
+            std::enable_if_t<id == type_id::optional_t, int> = 0>
+  constexpr size_info inline operator()(const T &item) {
+    size_info ret{};
+    ret.total = sizeof(bool);
+    if (item.has_value()) {
+      ret += calculate_one_size()(*item);
+    }
+    return ret;
+  }
+
+  // expected: the has_value flag, then the value or the error
+  template <typename T, typename type = remove_cvref_t<T>,
+            type_id id = get_type_id<remove_cvref_t<T>>(),
+            std::enable_if_t<id == type_id::expected_t, int> = 0>
+  constexpr size_info inline operator()(const T &item) {
+    size_info ret{};
+    ret.total = sizeof(bool);
+    if (item.has_value()) {
+      ret += calculate_one_size()(item.value());
+    } else {
+      ret += calculate_one_size()(item.error());
+    }
+    return ret;
+  }
+
+  // pointer
   template <typename T, typename type = remove_cvref_t<T>,
             type_id id = get_type_id<remove_cvref_t<T>>(),
             std::enable_if_t<id == type_id::pointer_t, int> = 0>
@@ -180,18 +427,30 @@ constexpr size_info inline calculate_payload_size(const Args &...items) {
 }
 
 template <typename conf, typename... Args>
-constexpr std::size_t get_serialize_runtime_info(const Args &...args);
+std::size_t get_aligned_serialize_size(const Args &...args);
 }  // namespace detail
 
 namespace detail {
 
-template <typename conf, typename... Args>
+template <typename conf, typename... Args,
+          std::enable_if_t<!aligned_layout<conf>, int> = 0>
 constexpr std::size_t get_serialize_runtime_info(const Args &...args) {
+  constexpr auto plan = get_size_plan_many<conf, Args...>();
+  constexpr std::size_t header = type_info_enabled<conf> ? kTypeInfoSize : 0;
+  if (plan.fixed) {
+    return header + plan.size.total + plan.size.length_field;
+  }
   std::size_t ret = 0;
   auto sz_info = calculate_payload_size<conf>(args...);
-  ret = sz_info.total + sz_info.length_field;
+  ret = header + sz_info.total + sz_info.length_field;
   return ret;
 }
 
+template <typename conf, typename... Args,
+          std::enable_if_t<aligned_layout<conf>, int> = 0>
+std::size_t get_serialize_runtime_info(const Args &...args) {
+  return get_aligned_serialize_size<conf>(args...);
+}
+
 }  // namespace detail
 }  // namespace serialize
\ No newline at end of file
@@ -13,11 +13,17 @@
 #include <cstdint>
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 #include "append_types/apply.hpp"
 #include "append_types/optional.hpp"
+#include "detail/alignment.hpp"
+#include "detail/calculate_size.hpp"
 #include "detail/endian_wrapper.hpp"
+#include "detail/fingerprint.hpp"
 #include "detail/macro.hpp"
 #include "detail/reflection.hpp"
 #include "detail/return_code.hpp"
@@ -34,17 +40,50 @@ class Deserializer {
   Deserializer(const Deserializer &) = delete;
   Deserializer &operator=(const Deserializer &) = delete;
 
-  Deserializer(Reader &reader) : reader_(reader) {
+  Deserializer(Reader &reader) : reader_(reader), start_(reader.tellg()) {
     static_assert(reader_t<Reader>,
                   "The reader type must satisfy requirements!");
   }
 
   template <typename T, typename... Args>
   serialize::return_code deserialize(T &t, Args &...args) {
+    auto code = check_type_info<T, Args...>();
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
     return deserialize_many(t, args...);
   }
 
+  // values only, the type info header was checked by the caller
+  template <typename... Args>
+  serialize::return_code deserialize_values(Args &...args) {
+    return deserialize_many(args...);
+  }
+
  private:
+  template <typename... Args, typename conf = serialize_conf,
+            std::enable_if_t<!type_info_enabled<conf>, int> = 0>
+  constexpr serialize::return_code check_type_info() {
+    return return_code::ok;
+  }
+
+  // one integer compare instead of decoding into a mismatched layout
+  template <typename... Args, typename conf = serialize_conf,
+            std::enable_if_t<type_info_enabled<conf>, int> = 0>
+  constexpr serialize::return_code check_type_info() {
+    std::uint64_t fingerprint = 0;
+    if SER_UNLIKELY ((!read_wrapper<serialize_conf::kByteOrder ==
+                                        byte_order::kLittleEndian,
+                                    kTypeInfoSize>(reader_,
+                                                   (char *)&fingerprint))) {
+      return return_code::no_buffer_space;
+    }
+    if SER_UNLIKELY (fingerprint != get_type_fingerprint<Args...>()) {
+      return return_code::type_mismatch;
+    }
+    return return_code::ok;
+  }
+
   constexpr serialize::return_code deserialize_many() {
     return return_code::ok;
   }
@@ -74,18 +113,56 @@ class Deserializer {
                        std::is_enum<remove_cvref_t<decltype(item)>>::value ||
                        id == type_id::int128_t || id == type_id::uint128_t,
                    int> = 0) {
-    if SER_UNLIKELY ((!read_wrapper<serialize_conf::kByteOrder ==
-                                        byte_order::kLittleEndian,
-                                    sizeof(remove_cvref_t<decltype(item)>)>(
-                         reader_, (char *)&item))) {
+    auto code = align_to(alignof(T));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    if SER_UNLIKELY (!read_scalar(item)) {
       return return_code::no_buffer_space;
     }
 
     return return_code::ok;
   }
+
+  template <typename T, typename conf = serialize_conf, typename R = Reader,
+            std::enable_if_t<aligned_layout<conf> && view_reader_t<R>, int> = 0>
+  bool inline read_scalar(T &item) {
+    return read_aligned_wrapper<serialize_conf::kByteOrder ==
+                                    byte_order::kLittleEndian,
+                                sizeof(T)>(reader_, (char *)&item);
+  }
+
+  template <typename T, typename conf = serialize_conf, typename R = Reader,
+            std::enable_if_t<!(aligned_layout<conf> && view_reader_t<R>),
+                             int> = 0>
+  bool inline read_scalar(T &item) {
+    return read_wrapper<serialize_conf::kByteOrder == byte_order::kLittleEndian,
+                        sizeof(T)>(reader_, (char *)&item);
+  }
+  template <type_id id, typename T>
+  constexpr serialize::return_code inline deserialize_one_helper(
+      T &item,
+      std::enable_if_t<id == type_id::v_int32_t || id == type_id::v_int64_t ||
+                           id == type_id::v_uint32_t ||
+                           id == type_id::v_uint64_t,
+                       int> = 0) {
+    std::uint64_t raw = 0;
+    auto code = varint_return_code(read_varint(reader_, raw));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    if SER_UNLIKELY (!varint_decode_value(raw, item.value)) {
+      return return_code::invalid_buffer;
+    }
+    return return_code::ok;
+  }
   template <type_id id, typename T>
   constexpr serialize::return_code inline deserialize_one_helper(
       T &item, std::enable_if_t<id == type_id::bitset_t, int> = 0) {
+    auto code = align_to(alignof(T));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
     if SER_UNLIKELY (!read_bytes_array(
                          reader_, (char *)&item,
                          sizeof(remove_cvref_t<decltype(item)>))) {
@@ -104,6 +181,10 @@ class Deserializer {
                                             byte_order::kLittleEndian,
                                         sizeof(item[0])>,
           int> = 0) {
+    auto code = align_to(alignof(T));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
     if SER_UNLIKELY (!read_bytes_array(reader_, (char *)&item, sizeof(item))) {
       return return_code::no_buffer_space;
     }
@@ -118,7 +199,10 @@ class Deserializer {
                     remove_cvref_t<decltype(item)>>::value &&
                 is_little_endian_copyable<serialize_conf::kByteOrder ==
                                               byte_order::kLittleEndian,
-                                          sizeof(item[0])>),
+                                          sizeof(item[0])>) &&
+              !bulk_swap_needed<serialize_conf::kByteOrder ==
+                                    byte_order::kLittleEndian,
+                                remove_cvref_t<decltype(item[0])>>,
           int> = 0) {
     return_code code{};
     for (auto &i : item) {
@@ -130,6 +214,26 @@ class Deserializer {
     return return_code::ok;
   }
   template <type_id id, typename T>
+  constexpr serialize::return_code inline deserialize_one_helper(
+      T &item,
+      std::enable_if_t<
+          id == type_id::array_t &&
+              bulk_swap_needed<serialize_conf::kByteOrder ==
+                                   byte_order::kLittleEndian,
+                               remove_cvref_t<decltype(item[0])>>,
+          int> = 0) {
+    auto count = static_cast<std::size_t>(std::end(item) - std::begin(item));
+    auto code = align_to(alignof(T));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    if SER_UNLIKELY (!read_swapped_array<sizeof(item[0])>(
+                         reader_, (char *)&item[0], count)) {
+      return return_code::no_buffer_space;
+    }
+    return return_code::ok;
+  }
+  template <type_id id, typename T>
   constexpr serialize::return_code inline deserialize_one_helper(
       T &item, std::enable_if_t<id == type_id::pair_t, int> = 0) {
     return_code code{};
@@ -157,11 +261,8 @@ class Deserializer {
     }
     if SER_UNLIKELY (index >= mpark::variant_size_v<remove_cvref_t<T>>) {
       return return_code::invalid_buffer;
-    } else {
-      template_switch<variant_construct_helper>(index, *this, item);
     }
-
-    return return_code::ok;
+    return template_switch<variant_construct_helper>(index, *this, item);
   }
 
   template <type_id id, typename T>
@@ -173,18 +274,138 @@ class Deserializer {
                        serialize_conf::kStructLengthField == 4 ||
                        serialize_conf::kStructLengthField == 8),
                   "");
-    return_code code{};
     std::uint64_t size = 0;
+    auto code = align_to(serialize_conf::kStructLengthField);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    auto start = reader_.tellg();
     code = deserialize_length_field<serialize_conf::kStructLengthField>(size);
     if SER_UNLIKELY (code != return_code::ok) {
       return code;
     }
-    visit_members(item, [&](auto &&...items) {
-      bool ret = true;
+    code = align_to(alignof(T));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    code = deserialize_members(item);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    code = align_to(alignof(T));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    if (serialize_conf::kStructLengthField != 0) {
+      // skip members appended by a newer producer
+      std::size_t consumed = reader_.tellg() - start;
+      if SER_UNLIKELY (consumed > size) {
+        return return_code::invalid_buffer;
+      }
+      if SER_UNLIKELY (!reader_.ignore(size - consumed)) {
+        return return_code::no_buffer_space;
+      }
+    }
+    return return_code::ok;
+  }
+
+  template <typename T, typename conf = serialize_conf,
+            std::enable_if_t<!tagged_struct<conf>, int> = 0>
+  constexpr serialize::return_code inline deserialize_members(T &item) {
+    return_code code{};
+    visit_members(item,
+                  [&](auto &&...items) { code = deserialize_many(items...); });
+    return code;
+  }
+
+  // members are matched by tag: unknown tags are skipped by their length and
+  // members which were not sent are value-initialized, so a reused target
+  // doesn't keep them from the previous message.
+  template <typename T, typename conf = serialize_conf,
+            std::enable_if_t<tagged_struct<conf>, int> = 0>
+  constexpr serialize::return_code inline deserialize_members(T &item) {
+    static_assert(members_count<T>() <= 64, "one bit per member");
+    std::uint64_t received = 0;
+    std::uint64_t count = 0;
+    auto code = varint_return_code(read_varint(reader_, count));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    for (std::uint64_t i = 0; i < count; ++i) {
+      std::uint64_t tag = 0;
+      std::uint32_t length = 0;
+      code = varint_return_code(read_varint(reader_, tag));
+      if SER_UNLIKELY (code != return_code::ok) {
+        return code;
+      }
+      code = align_to(kTaggedMemberLengthField);
+      if SER_UNLIKELY (code != return_code::ok) {
+        return code;
+      }
+      if SER_UNLIKELY ((!read_wrapper<serialize_conf::kByteOrder ==
+                                          byte_order::kLittleEndian,
+                                      kTaggedMemberLengthField>(
+                           reader_, (char *)&length))) {
+        return return_code::no_buffer_space;
+      }
+      if SER_UNLIKELY (tag == 0) {
+        return return_code::invalid_buffer;
+      }
+      if (tag > members_count<T>()) {
+        if SER_UNLIKELY (!reader_.ignore(length)) {
+          return return_code::no_buffer_space;
+        }
+        continue;
+      }
+      auto start = reader_.tellg();
+      visit_members(item, [&](auto &&...items) {
+        code = deserialize_member_at(tag - 1, items...);
+      });
+      if SER_UNLIKELY (code != return_code::ok) {
+        return code;
+      }
+      // a newer producer may have grown the member, e.g. a nested struct
+      std::size_t consumed = reader_.tellg() - start;
+      if SER_UNLIKELY (consumed > length) {
+        return return_code::invalid_buffer;
+      }
+      if SER_UNLIKELY (!reader_.ignore(length - consumed)) {
+        return return_code::no_buffer_space;
+      }
+      received |= std::uint64_t{1} << (tag - 1);
+    }
+    visit_members(item, [received](auto &&...items) {
+      std::size_t index = 0;
       static_cast<void>(std::initializer_list<int>{
-          (ret &= (deserialize_one(items) == return_code::ok), 0)...});
+          (((received >> index++) & 1u) == 0 ? reset_member(items) : void(),
+           0)...});
     });
-    return code;
+    return return_code::ok;
+  }
+
+  template <typename T, std::enable_if_t<!std::is_array<T>::value, int> = 0>
+  static void inline reset_member(T &item) {
+    item = T{};
+  }
+
+  template <typename T, std::size_t N>
+  static void inline reset_member(T (&item)[N]) {
+    for (auto &i : item) {
+      reset_member(i);
+    }
+  }
+
+  constexpr serialize::return_code deserialize_member_at(std::size_t) {
+    return return_code::invalid_buffer;
+  }
+  template <typename First, typename... Args>
+  constexpr serialize::return_code deserialize_member_at(std::size_t index,
+                                                         First &first_item,
+                                                         Args &...items) {
+    if (index == 0) {
+      return deserialize_one(first_item);
+    }
+    return deserialize_member_at(index - 1, items...);
   }
 
   template <type_id id, typename T>
@@ -200,21 +421,22 @@ class Deserializer {
   constexpr serialize::return_code inline deserialize_one_helper(
       T &item,
       std::enable_if_t<id == type_id::pointer_t && unique_ptr<T>, int> = 0) {
-    return_code code{};
     using type = remove_cvref_t<decltype(item)>;
-    item = std::make_unique<typename type::element_type>();
-    deserialize_one(*item);
-    return code;
+    if (item == nullptr) {
+      item = std::make_unique<typename type::element_type>();
+    }
+    return deserialize_one(*item);
   }
   template <type_id id, typename T>
   constexpr serialize::return_code inline deserialize_one_helper(
       T &item,
       std::enable_if_t<id == type_id::pointer_t && shared_ptr<T>, int> = 0) {
-    return_code code{};
     using type = remove_cvref_t<decltype(item)>;
-    item = std::make_shared<typename type::element_type>();
-    deserialize_one(*item);
-    return code;
+    // a pointee which is shared with others must not change under them
+    if (item == nullptr || item.use_count() != 1) {
+      item = std::make_shared<typename type::element_type>();
+    }
+    return deserialize_one(*item);
   }
 
   template <type_id id, typename T>
@@ -229,12 +451,14 @@ class Deserializer {
       return return_code::no_buffer_space;
     }
     if SER_UNLIKELY (!has_value) {
+      item = type{};
       return return_code::ok;
-    } else {
+    }
+    // decode over a held value, so it keeps what it allocated
+    if (!item.has_value()) {
       item = type{tl::in_place_t{}};
-      deserialize_one(*item);
     }
-    return return_code::ok;
+    return deserialize_one(*item);
   }
   template <type_id id, typename T>
   constexpr serialize::return_code inline deserialize_one_helper(
@@ -248,13 +472,16 @@ class Deserializer {
       return return_code::no_buffer_space;
     }
     if SER_UNLIKELY (!has_value) {
-      item = typename type::unexpected_type{typename type::error_type{}};
-      deserialize_one(item.error());
-    } else {
-      // TODO check void
-      deserialize_one(item.value());
+      if (item.has_value()) {
+        item = typename type::unexpected_type{typename type::error_type{}};
+      }
+      return deserialize_one(item.error());
     }
-    return return_code::ok;
+    // TODO check void
+    if (!item.has_value()) {
+      item = type{};
+    }
+    return deserialize_one(item.value());
   }
 
   template <type_id id, typename T>
@@ -264,7 +491,9 @@ class Deserializer {
                       (serialize_conf::kArrayLengthField == 1 ||
                        serialize_conf::kArrayLengthField == 2 ||
                        serialize_conf::kArrayLengthField == 4 ||
-                       serialize_conf::kArrayLengthField == 8),
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
                   "");
     return_code code{};
     std::uint64_t size = 0;
@@ -273,15 +502,31 @@ class Deserializer {
       return code;
     }
     using type = remove_cvref_t<decltype(item)>;
-    std::pair<typename type::key_type, typename type::mapped_type> value{};
+    using value_type =
+        std::pair<typename type::key_type, typename type::mapped_type>;
+    code = check_container_length<value_type>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    typename type::key_type key{};
+    reset_for(item, size);
 
+    // the mapped value is decoded in its node rather than moved there. With
+    // the end() hint an ordered map inserts in O(1) while the keys arrive
+    // sorted, as they do from ordered maps and under kSortedKeys; unordered
+    // maps ignore the hint and were reserved above.
     for (std::size_t i = 0; i < size; ++i) {
-      code = deserialize_one(value);
+      code = deserialize_one(key);
+      if SER_UNLIKELY (code != return_code::ok) {
+        return code;
+      }
+      auto it = item.emplace_hint(item.end(), std::piecewise_construct,
+                                  std::forward_as_tuple(std::move(key)),
+                                  std::forward_as_tuple());
+      code = deserialize_one(it->second);
       if SER_UNLIKELY (code != return_code::ok) {
         return code;
       }
-      // TODO: mapped_type can deserialize without be moved
-      item.emplace(std::move(value));
     }
 
     return return_code::ok;
@@ -293,7 +538,9 @@ class Deserializer {
                       (serialize_conf::kArrayLengthField == 1 ||
                        serialize_conf::kArrayLengthField == 2 ||
                        serialize_conf::kArrayLengthField == 4 ||
-                       serialize_conf::kArrayLengthField == 8),
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
                   "");
     return_code code{};
     std::uint64_t size = 0;
@@ -302,7 +549,12 @@ class Deserializer {
       return code;
     }
     using type = remove_cvref_t<decltype(item)>;
+    code = check_container_length<typename type::value_type>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
     typename type::value_type value{};
+    reset_for(item, size);
 
     for (std::size_t i = 0; i < size; ++i) {
       code = deserialize_one(value);
@@ -310,7 +562,7 @@ class Deserializer {
         return code;
       }
       // TODO: set_type can deserialize without be moved
-      item.emplace(std::move(value));
+      item.emplace_hint(item.end(), std::move(value));
     }
 
     return return_code::ok;
@@ -318,12 +570,16 @@ class Deserializer {
 
   template <type_id id, typename T>
   constexpr serialize::return_code inline deserialize_one_helper(
-      T &item, std::enable_if_t<id == type_id::string_t, int> = 0) {
+      T &item, std::enable_if_t<id == type_id::string_t &&
+                                    !string_view<remove_cvref_t<T>>,
+                                int> = 0) {
     static_assert((serialize_conf::kStringLengthField > 0) &&
                       (serialize_conf::kStringLengthField == 1 ||
                        serialize_conf::kStringLengthField == 2 ||
                        serialize_conf::kStringLengthField == 4 ||
-                       serialize_conf::kStringLengthField == 8),
+                       serialize_conf::kStringLengthField == 8 ||
+                       serialize_conf::kStringLengthField ==
+                           kVarintLengthField),
                   "");
     return_code code{};
     std::uint64_t size = 0;
@@ -334,14 +590,23 @@ class Deserializer {
 
     using type = remove_cvref_t<decltype(item)>;
     using value_type = typename type::value_type;
+    code = check_string_length<value_type>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
     uint64_t mem_sz = size * sizeof(value_type);
+    code = align_to(alignof(value_type));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
 
     if SER_UNLIKELY (mem_sz >= PTRDIFF_MAX) {
-      unreachable();
+      return return_code::length_error;
     } else {
       item.resize(size - 1);
       if SER_UNLIKELY (!read_bytes_array(reader_, (char *)item.data(),
-                                         (size - 1) * sizeof(value_type))) {
+                                         (size - 1) * sizeof(value_type)) ||
+                       !reader_.ignore(sizeof(value_type))) {
         return return_code::no_buffer_space;
       }
     }
@@ -354,6 +619,7 @@ class Deserializer {
       T &item,
       std::enable_if_t<
           (id == type_id::container_t) &&
+              !dynamic_span<remove_cvref_t<decltype(item)>> &&
               (trivially_copyable_container<remove_cvref_t<decltype(item)>> &&
                is_little_endian_copyable<
                    serialize_conf::kByteOrder == byte_order::kLittleEndian,
@@ -364,7 +630,9 @@ class Deserializer {
                       (serialize_conf::kArrayLengthField == 1 ||
                        serialize_conf::kArrayLengthField == 2 ||
                        serialize_conf::kArrayLengthField == 4 ||
-                       serialize_conf::kArrayLengthField == 8),
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
                   "");
     return_code code{};
     std::uint64_t size = 0;
@@ -375,10 +643,18 @@ class Deserializer {
 
     using type = remove_cvref_t<decltype(item)>;
     using value_type = typename type::value_type;
+    code = check_container_length<value_type>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
     uint64_t mem_sz = size * sizeof(value_type);
+    code = align_to(alignof(value_type));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
 
     if SER_UNLIKELY (mem_sz >= PTRDIFF_MAX) {
-      unreachable();
+      return return_code::length_error;
     } else {
       item.resize(size);
       if SER_UNLIKELY (!read_bytes_array(reader_, (char *)item.data(),
@@ -394,17 +670,24 @@ class Deserializer {
       T &item,
       std::enable_if_t<
           (id == type_id::container_t) &&
+              !dynamic_span<remove_cvref_t<decltype(item)>> &&
               !(trivially_copyable_container<remove_cvref_t<decltype(item)>> &&
                 is_little_endian_copyable<
                     serialize_conf::kByteOrder == byte_order::kLittleEndian,
                     sizeof(
-                        typename remove_cvref_t<decltype(item)>::value_type)>),
+                        typename remove_cvref_t<decltype(item)>::value_type)>) &&
+              !(trivially_copyable_container<remove_cvref_t<decltype(item)>> &&
+                bulk_swap_needed<
+                    serialize_conf::kByteOrder == byte_order::kLittleEndian,
+                    typename remove_cvref_t<decltype(item)>::value_type>),
           int> = 0) {
     static_assert((serialize_conf::kArrayLengthField > 0) &&
                       (serialize_conf::kArrayLengthField == 1 ||
                        serialize_conf::kArrayLengthField == 2 ||
                        serialize_conf::kArrayLengthField == 4 ||
-                       serialize_conf::kArrayLengthField == 8),
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
                   "");
     return_code code{};
     std::uint64_t size = 0;
@@ -413,6 +696,11 @@ class Deserializer {
       return code;
     }
 
+    code = check_container_length<
+        typename remove_cvref_t<decltype(item)>::value_type>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
     item.resize(size);
     for (auto &i : item) {
       code = deserialize_one(i);
@@ -424,14 +712,253 @@ class Deserializer {
     return return_code::ok;
   }
 
+  template <type_id id, typename T>
+  constexpr serialize::return_code inline deserialize_one_helper(
+      T &item,
+      std::enable_if_t<
+          (id == type_id::container_t) &&
+              !dynamic_span<remove_cvref_t<decltype(item)>> &&
+              trivially_copyable_container<remove_cvref_t<decltype(item)>> &&
+              bulk_swap_needed<
+                  serialize_conf::kByteOrder == byte_order::kLittleEndian,
+                  typename remove_cvref_t<decltype(item)>::value_type>,
+          int> = 0) {
+    static_assert((serialize_conf::kArrayLengthField > 0) &&
+                      (serialize_conf::kArrayLengthField == 1 ||
+                       serialize_conf::kArrayLengthField == 2 ||
+                       serialize_conf::kArrayLengthField == 4 ||
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
+                  "");
+    return_code code{};
+    std::uint64_t size = 0;
+    code = deserialize_length_field<serialize_conf::kArrayLengthField>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+
+    using type = remove_cvref_t<decltype(item)>;
+    using value_type = typename type::value_type;
+    code = check_container_length<value_type>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    uint64_t mem_sz = size * sizeof(value_type);
+    code = align_to(alignof(value_type));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+
+    if SER_UNLIKELY (mem_sz >= PTRDIFF_MAX) {
+      return return_code::length_error;
+    } else {
+      item.resize(size);
+      if SER_UNLIKELY (!read_swapped_array<sizeof(value_type)>(
+                           reader_, (char *)item.data(), size)) {
+        return return_code::no_buffer_space;
+      }
+    }
+    return return_code::ok;
+  }
+
+  // views point into the source buffer, so the reader has to hand out views
+  // and the encoded bytes have to be usable as they are.
+  template <type_id id, typename T>
+  constexpr serialize::return_code inline deserialize_one_helper(
+      T &item, std::enable_if_t<id == type_id::string_t &&
+                                    string_view<remove_cvref_t<T>>,
+                                int> = 0) {
+    static_assert((serialize_conf::kStringLengthField > 0) &&
+                      (serialize_conf::kStringLengthField == 1 ||
+                       serialize_conf::kStringLengthField == 2 ||
+                       serialize_conf::kStringLengthField == 4 ||
+                       serialize_conf::kStringLengthField == 8 ||
+                       serialize_conf::kStringLengthField ==
+                           kVarintLengthField),
+                  "");
+    static_assert(view_reader_t<Reader>,
+                  "deserialize to a string view needs a reader with read_view");
+    return_code code{};
+    std::uint64_t size = 0;
+    code = deserialize_length_field<serialize_conf::kStringLengthField>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+
+    using type = remove_cvref_t<decltype(item)>;
+    using value_type = typename type::value_type;
+    code = check_string_length<value_type>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    code = align_to(alignof(value_type));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    code = read_view_into(item, size - 1, sizeof(value_type),
+                          alignof(value_type));
+    if SER_UNLIKELY (code == return_code::ok &&
+                     !reader_.ignore(sizeof(value_type))) {
+      return return_code::no_buffer_space;
+    }
+    return code;
+  }
+
+  template <type_id id, typename T>
+  constexpr serialize::return_code inline deserialize_one_helper(
+      T &item, std::enable_if_t<(id == type_id::container_t) &&
+                                    dynamic_span<remove_cvref_t<T>>,
+                                int> = 0) {
+    static_assert((serialize_conf::kArrayLengthField > 0) &&
+                      (serialize_conf::kArrayLengthField == 1 ||
+                       serialize_conf::kArrayLengthField == 2 ||
+                       serialize_conf::kArrayLengthField == 4 ||
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
+                  "");
+    using type = remove_cvref_t<decltype(item)>;
+    using value_type = typename type::value_type;
+    static_assert(view_reader_t<Reader>,
+                  "deserialize to a span needs a reader with read_view");
+    static_assert(trivially_copyable_container<type> &&
+                      is_little_endian_copyable<serialize_conf::kByteOrder ==
+                                                    byte_order::kLittleEndian,
+                                                sizeof(value_type)>,
+                  "a span can only view elements which are stored as they are "
+                  "encoded, decode into a std::vector instead");
+    return_code code{};
+    std::uint64_t size = 0;
+    code = deserialize_length_field<serialize_conf::kArrayLengthField>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    code = check_container_length<value_type>(size);
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    code = align_to(alignof(value_type));
+    if SER_UNLIKELY (code != return_code::ok) {
+      return code;
+    }
+    return read_view_into(item, size, sizeof(value_type), alignof(value_type));
+  }
+
+  // length fields come from the buffer, so they are checked before anything
+  // is allocated for them: against the config's cap first, then against the
+  // bytes the reader has left. A string's length counts its terminator, which
+  // is always written, so it is never 0.
+  template <typename value_type>
+  constexpr serialize::return_code inline check_string_length(
+      std::uint64_t size) {
+    if SER_UNLIKELY (size == 0 ||
+                     size - 1 > max_string_length<serialize_conf>) {
+      return return_code::length_error;
+    }
+    return check_remaining(size, sizeof(value_type));
+  }
+
+  template <typename value_type>
+  constexpr serialize::return_code inline check_container_length(
+      std::uint64_t size) {
+    if SER_UNLIKELY (size > max_container_length<serialize_conf>) {
+      return return_code::length_error;
+    }
+    return check_remaining(size,
+                           min_encoded_size<serialize_conf, value_type>());
+  }
+
+  template <typename R = Reader,
+            std::enable_if_t<bounded_reader_t<R>, int> = 0>
+  constexpr serialize::return_code inline check_remaining(
+      std::uint64_t count, std::size_t min_size) {
+    if SER_UNLIKELY (min_size != 0 && count > reader_.remaining() / min_size) {
+      return return_code::no_buffer_space;
+    }
+    return return_code::ok;
+  }
+
+  template <typename R = Reader,
+            std::enable_if_t<!bounded_reader_t<R>, int> = 0>
+  constexpr serialize::return_code inline check_remaining(std::uint64_t,
+                                                          std::size_t) {
+    return return_code::ok;
+  }
+
+  // decoding replaces what the target held, but keeps its buckets. Sequences
+  // are resized instead, which keeps the elements and their capacity too.
+  template <typename T, std::enable_if_t<reservable<T>, int> = 0>
+  static void inline reset_for(T &item, std::uint64_t size) {
+    item.clear();
+    item.reserve(size);
+  }
+
+  template <typename T, std::enable_if_t<!reservable<T>, int> = 0>
+  static void inline reset_for(T &item, std::uint64_t) {
+    item.clear();
+  }
+
+  template <typename View>
+  constexpr serialize::return_code inline read_view_into(
+      View &item, std::uint64_t count, std::size_t elem_size,
+      std::size_t elem_align) {
+    using pointer = decltype(item.data());
+    uint64_t mem_sz = count * elem_size;
+    if SER_UNLIKELY (mem_sz >= PTRDIFF_MAX) {
+      return return_code::length_error;
+    }
+    auto data = reader_.read_view(mem_sz);
+    if SER_UNLIKELY (data == nullptr) {
+      return return_code::no_buffer_space;
+    }
+    if SER_UNLIKELY ((std::uintptr_t)data % elem_align != 0) {
+      return return_code::unaligned_view;
+    }
+    item = View{(pointer)data, static_cast<std::size_t>(count)};
+    return return_code::ok;
+  }
+
+  template <typename conf = serialize_conf,
+            std::enable_if_t<!aligned_layout<conf>, int> = 0>
+  constexpr serialize::return_code inline align_to(std::size_t) {
+    return return_code::ok;
+  }
+
+  template <typename conf = serialize_conf,
+            std::enable_if_t<aligned_layout<conf>, int> = 0>
+  constexpr serialize::return_code inline align_to(std::size_t align) {
+    auto padding = aligned_padding_size<serialize_conf>(
+        reader_.tellg() - start_, align == 0 ? 1 : align);
+    if SER_UNLIKELY (!reader_.ignore(padding)) {
+      return return_code::no_buffer_space;
+    }
+    return return_code::ok;
+  }
+
+  static constexpr serialize::return_code inline varint_return_code(
+      varint_status status) {
+    return status == varint_status::ok ? return_code::ok
+           : status == varint_status::short_read
+               ? return_code::no_buffer_space
+               : return_code::invalid_buffer;
+  }
+
   template <std::uint8_t length_field>
   constexpr serialize::return_code inline deserialize_length_field(
       std::uint64_t &size64) {
     std::uint8_t size8 = 0;
     std::uint16_t size16 = 0;
     std::uint32_t size32 = 0;
+    return_code code{};
     constexpr bool is_little_endian =
         serialize_conf::kByteOrder == byte_order::kLittleEndian;
+    if (length_field != kVarintLengthField) {
+      code = align_to(length_field);
+      if SER_UNLIKELY (code != return_code::ok) {
+        return code;
+      }
+    }
     switch (length_field) {
       case 0:
         break;
@@ -462,12 +989,15 @@ class Deserializer {
           return return_code::no_buffer_space;
         }
         break;
+      case kVarintLengthField:
+        code = varint_return_code(read_varint(reader_, size64));
+        if SER_UNLIKELY (code != return_code::ok) {
+          return code;
+        }
+        break;
       default:
         unreachable();
     }
-    if SER_UNLIKELY (length_field != 0 && size64 == 0) {
-      return return_code::length_error;
-    }
     return return_code::ok;
   }
 
@@ -475,23 +1005,28 @@ class Deserializer {
   struct variant_construct_helper {
     template <size_t index, typename deserializer, typename variant_t,
               std::enable_if_t<index<mpark::variant_size_v<variant_t>, int> =
-                                   0> static inline constexpr void
+                                   0> static inline constexpr return_code
                   run(deserializer &des, variant_t &v) {
-      v = variant_t{mpark::in_place_index_t<index>{}};
-      des.template deserialize_one(mpark::get<index>(v));
+      // same alternative as before: decode over it
+      if (v.index() != index) {
+        v = variant_t{mpark::in_place_index_t<index>{}};
+      }
+      return des.template deserialize_one(mpark::get<index>(v));
     }
 
     template <
         size_t index, typename deserializer, typename variant_t,
         std::enable_if_t<index >= mpark::variant_size_v<variant_t>, int> = 0>
-    static inline constexpr void run(deserializer &, variant_t &) {
+    static inline constexpr return_code run(deserializer &, variant_t &) {
       unreachable();
-      return;
+      return return_code::invalid_buffer;
     }
   };
 
  private:
   Reader &reader_;
+  // padding is computed against offsets from here
+  std::size_t start_;
 };
 
 }  // namespace detail
@@ -5,9 +5,11 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <type_traits>
 
+#include "byte_swap.hpp"
 #include "macro.hpp"
 #include "utils.hpp"
 
@@ -22,6 +24,12 @@ template <bool is_little_endian_config, std::size_t block_size>
 constexpr bool is_little_endian_copyable =
     (is_system_little_endian && is_little_endian_config) || block_size == 1;
 
+// arrays of T whose wire order differs from the host's, swapped in one pass.
+// Under a matching order they take the plain copy path instead.
+template <bool is_little_endian_config, typename T>
+constexpr bool bulk_swap_needed =
+    is_little_endian_config != is_system_little_endian && bulk_swappable<T>;
+
 inline uint16_t bswap16(uint16_t raw) { return __builtin_bswap16(raw); };
 
 inline uint32_t bswap32(uint32_t raw) { return __builtin_bswap32(raw); };
@@ -29,39 +37,49 @@ inline uint32_t bswap32(uint32_t raw) { return __builtin_bswap32(raw); };
 inline uint64_t bswap64(uint64_t raw) { return __builtin_bswap64(raw); };
 
 template <bool is_little_endian, std::size_t block_size, typename writer_t,
-          std::enable_if_t<!is_little_endian || block_size == 1, int> = 0>
+          std::enable_if_t<is_little_endian == is_system_little_endian ||
+                               block_size == 1,
+                           int> = 0>
 void write_wrapper(writer_t& writer, const char* data) {
   writer.write(data, block_size);
 }
 
 template <bool is_little_endian, std::size_t block_size, typename writer_t,
-          std::enable_if_t<is_little_endian && block_size == 2, int> = 0>
+          std::enable_if_t<is_little_endian != is_system_little_endian &&
+                               block_size == 2,
+                           int> = 0>
 void write_wrapper(writer_t& writer, const char* data) {
   auto tmp = bswap16(*(std::uint16_t*)data);
   writer.write((char*)&tmp, block_size);
 }
 
 template <bool is_little_endian, std::size_t block_size, typename writer_t,
-          std::enable_if_t<is_little_endian && block_size == 4, int> = 0>
+          std::enable_if_t<is_little_endian != is_system_little_endian &&
+                               block_size == 4,
+                           int> = 0>
 void write_wrapper(writer_t& writer, const char* data) {
   auto tmp = bswap32(*(std::uint32_t*)data);
   writer.write((char*)&tmp, block_size);
 }
 
 template <bool is_little_endian, std::size_t block_size, typename writer_t,
-          std::enable_if_t<is_little_endian && block_size == 8, int> = 0>
+          std::enable_if_t<is_little_endian != is_system_little_endian &&
+                               block_size == 8,
+                           int> = 0>
 void write_wrapper(writer_t& writer, const char* data) {
   auto tmp = bswap64(*(std::uint64_t*)data);
   writer.write((char*)&tmp, block_size);
 }
 
 template <bool is_little_endian, std::size_t block_size, typename writer_t,
-          std::enable_if_t<is_little_endian && block_size == 16, int> = 0>
+          std::enable_if_t<is_little_endian != is_system_little_endian &&
+                               block_size == 16,
+                           int> = 0>
 void write_wrapper(writer_t& writer, const char* data) {
   auto tmp1 = bswap64(*(std::uint64_t*)data),
        tmp2 = bswap64(*(std::uint64_t*)(data + 8));
-  writer.write((char*)&tmp2, block_size);
-  writer.write((char*)&tmp1, block_size);
+  writer.write((char*)&tmp2, sizeof(tmp2));
+  writer.write((char*)&tmp1, sizeof(tmp1));
 }
 
 template <
@@ -82,15 +100,36 @@ void write_bytes_array(writer_t& writer, const char* data, std::size_t length) {
   }
 }
 
+// write `count` elements of `block_size` bytes with their byte order
+// reversed, swapping through a small stack buffer in bulk.
+template <std::size_t block_size, typename writer_t>
+void write_swapped_array(writer_t& writer, const char* data,
+                         std::size_t count) {
+  constexpr std::size_t kChunkBytes = 1024;
+  constexpr std::size_t kChunkCount = kChunkBytes / block_size;
+  alignas(32) std::array<char, kChunkBytes> tmp;
+  while (count > 0) {
+    std::size_t n = count < kChunkCount ? count : kChunkCount;
+    byte_swap_copy<block_size>(tmp.data(), data, n);
+    writer.write(tmp.data(), n * block_size);
+    data += n * block_size;
+    count -= n;
+  }
+}
+
 template <bool is_little_endian, std::size_t block_size, typename reader_t,
-          std::enable_if_t<!is_little_endian || block_size == 1, int> = 0>
+          std::enable_if_t<is_little_endian == is_system_little_endian ||
+                               block_size == 1,
+                           int> = 0>
 bool read_wrapper(reader_t& reader, char* data) {
   return static_cast<bool>(reader.read(data, block_size));
   return true;
 }
 
 template <bool is_little_endian, std::size_t block_size, typename reader_t,
-          std::enable_if_t<is_little_endian && block_size == 2, int> = 0>
+          std::enable_if_t<is_little_endian != is_system_little_endian &&
+                               block_size == 2,
+                           int> = 0>
 bool read_wrapper(reader_t& reader, char* data) {
   std::array<char, block_size> tmp;
   bool res = static_cast<bool>(reader.read((char*)&tmp, block_size));
@@ -102,7 +141,9 @@ bool read_wrapper(reader_t& reader, char* data) {
 }
 
 template <bool is_little_endian, std::size_t block_size, typename reader_t,
-          std::enable_if_t<is_little_endian && block_size == 4, int> = 0>
+          std::enable_if_t<is_little_endian != is_system_little_endian &&
+                               block_size == 4,
+                           int> = 0>
 bool read_wrapper(reader_t& reader, char* data) {
   std::array<char, block_size> tmp;
   bool res = static_cast<bool>(reader.read((char*)&tmp, block_size));
@@ -115,7 +156,9 @@ bool read_wrapper(reader_t& reader, char* data) {
 }
 
 template <bool is_little_endian, std::size_t block_size, typename reader_t,
-          std::enable_if_t<is_little_endian && block_size == 8, int> = 0>
+          std::enable_if_t<is_little_endian != is_system_little_endian &&
+                               block_size == 8,
+                           int> = 0>
 bool read_wrapper(reader_t& reader, char* data) {
   std::array<char, block_size> tmp;
   bool res = static_cast<bool>(reader.read((char*)&tmp, block_size));
@@ -128,15 +171,17 @@ bool read_wrapper(reader_t& reader, char* data) {
 }
 
 template <bool is_little_endian, std::size_t block_size, typename reader_t,
-          std::enable_if_t<is_little_endian && block_size == 16, int> = 0>
+          std::enable_if_t<is_little_endian != is_system_little_endian &&
+                               block_size == 16,
+                           int> = 0>
 bool read_wrapper(reader_t& reader, char* data) {
   std::array<char, block_size> tmp;
   bool res = static_cast<bool>(reader.read((char*)&tmp, block_size));
   if SER_UNLIKELY (!res) {
     return res;
   }
-  *(uint64_t*)(data + 8) = bswap64(*(uint64_t*)&tmp);
-  *(uint64_t*)data = bswap64(*(uint64_t*)(&tmp + 8));
+  *(uint64_t*)(data + 8) = bswap64(*(uint64_t*)tmp.data());
+  *(uint64_t*)data = bswap64(*(uint64_t*)(tmp.data() + 8));
   return true;
 }
 
@@ -150,6 +195,58 @@ bool read_wrapper(reader_t& reader, char*) {
   return false;
 }
 
+template <std::size_t block_size>
+struct uint_of_size;
+template <>
+struct uint_of_size<1> {
+  using type = std::uint8_t;
+};
+template <>
+struct uint_of_size<2> {
+  using type = std::uint16_t;
+};
+template <>
+struct uint_of_size<4> {
+  using type = std::uint32_t;
+};
+template <>
+struct uint_of_size<8> {
+  using type = std::uint64_t;
+};
+
+inline std::uint8_t bswap(std::uint8_t raw) { return raw; }
+inline std::uint16_t bswap(std::uint16_t raw) { return bswap16(raw); }
+inline std::uint32_t bswap(std::uint32_t raw) { return bswap32(raw); }
+inline std::uint64_t bswap(std::uint64_t raw) { return bswap64(raw); }
+
+// load a scalar straight out of the reader's buffer. In the aligned layout
+// it sits at an aligned offset, and the fixed size memcpy compiles to a
+// single move either way.
+template <bool is_little_endian, std::size_t block_size, typename reader_t,
+          std::enable_if_t<block_size == 1 || block_size == 2 ||
+                               block_size == 4 || block_size == 8,
+                           int> = 0>
+bool read_aligned_wrapper(reader_t& reader, char* data) {
+  using uint_t = typename uint_of_size<block_size>::type;
+  const char* view = reader.read_view(block_size);
+  if SER_UNLIKELY (view == nullptr) {
+    return false;
+  }
+  uint_t value;
+  std::memcpy(&value, view, block_size);
+  if (is_little_endian != is_system_little_endian) {
+    value = bswap(value);
+  }
+  std::memcpy(data, &value, block_size);
+  return true;
+}
+
+template <bool is_little_endian, std::size_t block_size, typename reader_t,
+          std::enable_if_t<block_size == 16, int> = 0>
+bool read_aligned_wrapper(reader_t& reader, char* data) {
+  return read_wrapper<is_little_endian, block_size>(reader, data);
+}
+
 template <typename reader_t>
 bool read_bytes_array(reader_t& reader, char* data, std::size_t length) {
   if (length >= PTRDIFF_MAX) {
@@ -159,6 +256,17 @@ bool read_bytes_array(reader_t& reader, char* data, std::size_t length) {
   }
 }
 
+// read `count` elements of `block_size` bytes and reverse their byte order in
+// place.
+template <std::size_t block_size, typename reader_t>
+bool read_swapped_array(reader_t& reader, char* data, std::size_t count) {
+  if SER_UNLIKELY (!read_bytes_array(reader, data, count * block_size)) {
+    return false;
+  }
+  byte_swap_copy<block_size>(data, data, count);
+  return true;
+}
+
 }  // namespace detail
 }  // namespace serialize
 
@@ -0,0 +1,123 @@
+/*
+ * @Description: buffered stream of messages read from a file descriptor
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 23:05:44
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 23:05:44
+ */
+
+#pragma once
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "macro.hpp"
+#include "return_code.hpp"
+
+namespace serialize {
+namespace detail {
+
+// reads messages from a pipe, socket or file without loading all of it. The
+// bytes read but not consumed yet form the window deserialize_next() decodes
+// from; a message only leaves the window once it decoded completely, so a
+// short read never loses its beginning. Each fetch asks for enough to double
+// the window, so from a file the attempts to decode one message stay linear
+// in its size. The window never grows beyond `max_message` bytes, which
+// bounds what a corrupted length field can make it buffer.
+//
+// On a non-blocking fd, fetch() returns need_more_data when the fd would
+// block; call deserialize_next() again once it is readable. Views decoded
+// from the window stay valid until the next fetch().
+class fd_reader {
+ public:
+  static constexpr std::size_t kDefaultCapacity = 64 * 1024;
+  static constexpr std::size_t kDefaultMaxMessage = 256 * 1024 * 1024;
+
+  explicit fd_reader(int fd, std::size_t capacity = kDefaultCapacity,
+                     std::size_t max_message = kDefaultMaxMessage)
+      : fd_(fd),
+        capacity_(capacity == 0 ? 1 : capacity),
+        max_message_(max_message) {}
+
+  const char *data() const { return buffer_.data() + begin_; }
+  std::size_t size() const { return end_ - begin_; }
+
+  void consume(std::size_t len) {
+    begin_ += len;
+    if (begin_ == end_) {
+      begin_ = end_ = 0;
+    }
+  }
+
+  // extend the window: ok when it grew, need_more_data when the fd would
+  // block, no_buffer_space at the end of the stream, length_error when the
+  // window already holds `max_message` bytes
+  return_code fetch() {
+    if SER_UNLIKELY (size() >= max_message_) {
+      return return_code::length_error;
+    }
+    std::size_t target = size() * 2 < capacity_ ? capacity_ : size() * 2;
+    if (target > max_message_) {
+      target = max_message_;
+    }
+    reserve_window(target);
+
+    // one read: a pipe hands out what it has instead of blocking until the
+    // window is full, though the message may already be complete
+    for (;;) {
+      ssize_t got = ::read(fd_, &buffer_[end_], target - size());
+      if (got > 0) {
+        end_ += static_cast<std::size_t>(got);
+        return return_code::ok;
+      }
+      if (got == 0) {
+        eof_ = true;
+        return return_code::no_buffer_space;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return return_code::need_more_data;
+      }
+      return return_code::read_failed;
+    }
+  }
+
+  // every message was consumed and the stream has ended
+  bool at_end() {
+    if (size() == 0 && !eof_) {
+      fetch();
+    }
+    return size() == 0 && eof_;
+  }
+
+ private:
+  // move the window to the front of the buffer, with room for `target` bytes
+  void reserve_window(std::size_t target) {
+    if (begin_ != 0) {
+      std::memmove(buffer_.data(), buffer_.data() + begin_, size());
+      end_ -= begin_;
+      begin_ = 0;
+    }
+    if (buffer_.size() < target) {
+      buffer_.resize(target);
+    }
+  }
+
+  int fd_;
+  std::size_t capacity_;
+  std::size_t max_message_;
+  std::vector<char> buffer_;
+  std::size_t begin_ = 0;
+  std::size_t end_ = 0;
+  bool eof_ = false;
+};
+
+}  // namespace detail
+}  // namespace serialize
@@ -0,0 +1,169 @@
+/*
+ * @Description: compile-time layout fingerprint built from type_id
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 17:05:12
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 17:05:12
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "reflection.hpp"
+#include "type_id.hpp"
+
+namespace serialize {
+namespace detail {
+
+// FNV-1a over the recursive type_id sequence of a type. Two types share a
+// fingerprint when they encode to the same layout, e.g. std::string and
+// serialize::string_view, or two structs with the same member types.
+constexpr std::uint64_t kFingerprintBasis = 14695981039346656037ull;
+constexpr std::uint64_t kFingerprintPrime = 1099511628211ull;
+
+constexpr std::uint64_t fingerprint_mix(std::uint64_t hash,
+                                        std::uint64_t value) {
+  for (std::size_t i = 0; i < sizeof(value); ++i) {
+    hash ^= (value >> (8 * i)) & 0xff;
+    hash *= kFingerprintPrime;
+  }
+  return hash;
+}
+
+constexpr std::uint64_t fingerprint_mix(std::uint64_t hash, type_id id) {
+  return fingerprint_mix(hash, static_cast<std::uint64_t>(id));
+}
+
+template <typename T>
+constexpr std::uint64_t fingerprint_of(std::uint64_t hash);
+
+template <typename... Args>
+constexpr std::uint64_t fingerprint_many(std::uint64_t hash) {
+  const std::uint64_t steps[] = {hash, (hash = fingerprint_of<Args>(hash))...};
+  static_cast<void>(steps);
+  return hash;
+}
+
+template <typename T, std::size_t... I>
+constexpr std::uint64_t fingerprint_tuple(std::uint64_t hash,
+                                          std::index_sequence<I...>) {
+  hash = fingerprint_mix(hash, sizeof...(I));
+  return fingerprint_many<std::tuple_element_t<I, T>...>(hash);
+}
+
+template <typename T, std::size_t... I>
+constexpr std::uint64_t fingerprint_variant(std::uint64_t hash,
+                                            std::index_sequence<I...>) {
+  hash = fingerprint_mix(hash, sizeof...(I));
+  return fingerprint_many<mpark::variant_alternative_t<I, T>...>(hash);
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<
+              std::is_fundamental<T>::value || std::is_enum<T>::value ||
+                  id == type_id::int128_t || id == type_id::uint128_t ||
+                  varint_type<T> || id == type_id::monostate_t,
+              int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  return fingerprint_mix(hash, id);
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::bitset_t, int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  return fingerprint_mix(fingerprint_mix(hash, id), sizeof(T));
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::string_t ||
+                               id == type_id::container_t ||
+                               id == type_id::set_container_t ||
+                               id == type_id::optional_t,
+                           int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  return fingerprint_of<typename T::value_type>(fingerprint_mix(hash, id));
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::array_t, int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  using value_type = remove_cvref_t<decltype(*std::begin(std::declval<T &>()))>;
+  constexpr std::size_t count = sizeof(T) / sizeof(value_type);
+  hash = fingerprint_mix(fingerprint_mix(hash, id), count);
+  return fingerprint_of<value_type>(hash);
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::map_container_t, int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  return fingerprint_many<typename T::key_type, typename T::mapped_type>(
+      fingerprint_mix(hash, id));
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::pair_t, int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  return fingerprint_many<typename T::first_type, typename T::second_type>(
+      fingerprint_mix(hash, id));
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::tuple_t, int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  return fingerprint_tuple<T>(
+      fingerprint_mix(hash, id),
+      std::make_index_sequence<std::tuple_size<T>::value>{});
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::variant_t, int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  return fingerprint_variant<T>(
+      fingerprint_mix(hash, id),
+      std::make_index_sequence<mpark::variant_size_v<T>>{});
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::expected_t, int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  return fingerprint_many<typename T::value_type, typename T::error_type>(
+      fingerprint_mix(hash, id));
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::pointer_t, int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  return fingerprint_of<typename std::pointer_traits<T>::element_type>(
+      fingerprint_mix(hash, id));
+}
+
+template <typename T, type_id id = get_type_id<T>(),
+          std::enable_if_t<id == type_id::struct_t, int> = 0>
+constexpr std::uint64_t fingerprint_impl(std::uint64_t hash) {
+  using types = decltype(get_types<T>());
+  hash = fingerprint_tuple<types>(
+      fingerprint_mix(hash, id),
+      std::make_index_sequence<std::tuple_size<types>::value>{});
+  return fingerprint_mix(hash, type_id::type_end_flag);
+}
+
+template <typename T>
+constexpr std::uint64_t fingerprint_of(std::uint64_t hash) {
+  return fingerprint_impl<remove_cvref_t<T>>(hash);
+}
+
+template <typename... Args>
+constexpr std::uint64_t get_type_fingerprint() {
+  return fingerprint_of<get_args_type<Args...>>(kFingerprintBasis);
+}
+
+}  // namespace detail
+}  // namespace serialize
@@ -0,0 +1,203 @@
+/*
+ * @Description: in-place access to encodings which match the memory layout
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 19:12:40
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 19:12:40
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "detail/alignment.hpp"
+#include "detail/calculate_size.hpp"
+#include "detail/endian_wrapper.hpp"
+#include "detail/fingerprint.hpp"
+#include "detail/macro.hpp"
+#include "detail/reflection.hpp"
+#include "detail/return_code.hpp"
+#include "detail/type_id.hpp"
+#include "ser_config.hpp"
+
+namespace serialize {
+namespace detail {
+
+// padding the encoding puts in front of a value of alignment `align`
+template <typename conf, std::enable_if_t<!aligned_layout<conf>, int> = 0>
+constexpr std::size_t inline flat_padding(std::size_t, std::size_t) {
+  return 0;
+}
+
+template <typename conf, std::enable_if_t<aligned_layout<conf>, int> = 0>
+constexpr std::size_t inline flat_padding(std::size_t offset,
+                                          std::size_t align) {
+  return aligned_padding_size<conf>(offset, align);
+}
+
+// offset the encoding of T ends at when it starts at `offset`, for types
+// which are written as they are laid out in memory
+template <typename conf, typename T>
+constexpr std::size_t flat_encoded_end(std::size_t offset);
+
+template <typename conf, typename T,
+          std::enable_if_t<get_type_id<T>() != type_id::struct_t, int> = 0>
+constexpr std::size_t inline flat_encoded_end_impl(std::size_t offset) {
+  return offset + flat_padding<conf>(offset, alignof(T)) + sizeof(T);
+}
+
+template <typename conf, typename types, std::size_t... I>
+constexpr std::size_t inline flat_members_end(std::size_t offset,
+                                              std::index_sequence<I...>) {
+  static_cast<void>(std::initializer_list<int>{
+      (offset = flat_encoded_end<conf, std::tuple_element_t<I, types>>(offset),
+       0)...});
+  return offset;
+}
+
+template <typename conf, typename T,
+          std::enable_if_t<get_type_id<T>() == type_id::struct_t, int> = 0>
+constexpr std::size_t inline flat_encoded_end_impl(std::size_t offset) {
+  using types = decltype(get_types<T>());
+  offset += flat_padding<conf>(offset, alignof(T));
+  offset = flat_members_end<conf, types>(
+      offset, std::make_index_sequence<std::tuple_size<types>::value>{});
+  return offset + flat_padding<conf>(offset, alignof(T));
+}
+
+template <typename conf, typename T>
+constexpr std::size_t flat_encoded_end(std::size_t offset) {
+  return flat_encoded_end_impl<conf, remove_cvref_t<T>>(offset);
+}
+
+// packed: the encoding has no room for padding, so it only matches a type
+// which has none
+template <typename conf, typename T,
+          std::enable_if_t<!aligned_layout<conf>, int> = 0>
+constexpr bool flat_padding_matches() {
+  constexpr auto plan = get_size_plan<conf, T>();
+  return plan.fixed &&
+         plan.size.total + plan.size.length_field == sizeof(T);
+}
+
+// aligned: every member lands on its natural alignment once kAlignment
+// covers the strictest one, and the padding then adds up to sizeof(T)
+// unless the reflected members leave bytes of T out
+template <typename conf, typename T,
+          std::enable_if_t<aligned_layout<conf>, int> = 0>
+constexpr bool flat_padding_matches() {
+  return static_cast<std::size_t>(conf::kAlignment) >= alignof(T) &&
+         flat_encoded_end<conf, T>(0) == sizeof(T);
+}
+
+template <typename conf, typename T,
+          std::enable_if_t<is_trivial_serializable<T>::value &&
+                               !is_trivial_view_v<T> &&
+                               std::is_trivially_copyable<T>::value,
+                           int> = 0>
+constexpr bool flat_layout_impl() {
+  return ((conf::kByteOrder == byte_order::kLittleEndian) ==
+          is_system_little_endian) &&
+         conf::kStructLengthField == 0 && !tagged_struct<conf> &&
+         flat_padding_matches<conf, T>();
+}
+
+template <typename conf, typename T,
+          std::enable_if_t<!(is_trivial_serializable<T>::value &&
+                             !is_trivial_view_v<T> &&
+                             std::is_trivially_copyable<T>::value),
+                           int> = 0>
+constexpr bool flat_layout_impl() {
+  return false;
+}
+
+// T is encoded under conf byte for byte as it is laid out in memory
+template <typename conf, typename T>
+constexpr bool flat_layout = flat_layout_impl<conf, remove_cvref_t<T>>();
+
+template <typename conf, typename T,
+          std::enable_if_t<!type_info_enabled<conf>, int> = 0>
+constexpr return_code check_flat_header(const char *) {
+  return return_code::ok;
+}
+
+template <typename conf, typename T,
+          std::enable_if_t<type_info_enabled<conf>, int> = 0>
+return_code check_flat_header(const char *data) {
+  // flat_layout implies native byte order
+  std::uint64_t fingerprint = 0;
+  std::memcpy(&fingerprint, data, kTypeInfoSize);
+  if SER_UNLIKELY (fingerprint != get_type_fingerprint<T>()) {
+    return return_code::type_mismatch;
+  }
+  return return_code::ok;
+}
+
+// sizes can't tell SERIALIZE_REFL listing the members out of declaration
+// order, so every member has to sit at the offset the encoding puts it at
+template <typename conf, typename T,
+          std::enable_if_t<get_type_id<T>() != type_id::struct_t, int> = 0>
+bool flat_offsets_match(const T &item, const char *base, std::size_t &offset) {
+  offset += flat_padding<conf>(offset, alignof(T));
+  bool ret = static_cast<std::size_t>((const char *)&item - base) == offset;
+  offset += sizeof(T);
+  return ret;
+}
+
+template <typename conf, typename T,
+          std::enable_if_t<get_type_id<T>() == type_id::struct_t, int> = 0>
+bool flat_offsets_match(const T &item, const char *base, std::size_t &offset) {
+  offset += flat_padding<conf>(offset, alignof(T));
+  bool ret = true;
+  visit_members(item, [&](const auto &...members) {
+    static_cast<void>(std::initializer_list<int>{
+        (ret &= flat_offsets_match<conf>(members, base, offset), 0)...});
+  });
+  offset += flat_padding<conf>(offset, alignof(T));
+  return ret;
+}
+
+// the offsets are the same for every object of T, check them once
+template <typename conf, typename T>
+bool flat_members_in_place(const T &item) {
+  static const bool ret = [&item] {
+    std::size_t offset = 0;
+    return flat_offsets_match<conf>(item, (const char *)&item, offset);
+  }();
+  return ret;
+}
+
+// the checks deserialize would make, without the copy
+template <typename conf, typename T>
+return_code view_flat(const char *data, std::size_t size, const T *&out) {
+  static_assert(flat_layout<conf, T>,
+                "T is not encoded with its memory layout under this config, "
+                "use deserialize instead");
+  constexpr std::size_t header = type_info_enabled<conf> ? kTypeInfoSize : 0;
+  if SER_UNLIKELY (data == nullptr || size < header + sizeof(T)) {
+    return return_code::no_buffer_space;
+  }
+  auto code = check_flat_header<conf, T>(data);
+  if SER_UNLIKELY (code != return_code::ok) {
+    return code;
+  }
+  if SER_UNLIKELY ((std::uintptr_t)(data + header) % alignof(T) != 0) {
+    return return_code::unaligned_view;
+  }
+  auto ptr = reinterpret_cast<const T *>(data + header);
+  if SER_UNLIKELY (!flat_members_in_place<conf>(*ptr)) {
+    return return_code::type_mismatch;
+  }
+  out = ptr;
+  return return_code::ok;
+}
+
+}  // namespace detail
+}  // namespace serialize
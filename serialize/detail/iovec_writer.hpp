@@ -0,0 +1,164 @@
+/*
+ * @Description: scatter-gather writer which references large blocks
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 20:31:08
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 20:31:08
+ */
+
+#pragma once
+
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "macro.hpp"
+
+namespace serialize {
+namespace detail {
+
+// writer which records the encoding as a list of iovecs. Small writes (length
+// fields, scalars, padding) are copied into storage the writer owns; blocks
+// of at least `threshold` bytes which the serializer takes straight out of
+// the serialized object (string, array and trivially copyable container
+// payloads) are only referenced. The serialized objects must therefore stay
+// alive and unchanged until the iovecs are flushed with writev() or gathered
+// into one buffer, e.g. a shared memory chunk.
+class iovec_writer {
+ public:
+  static constexpr std::size_t kDefaultThreshold = 4096;
+
+  explicit iovec_writer(std::size_t threshold = kDefaultThreshold)
+      : threshold_(threshold) {}
+
+  void write(const char *data, std::size_t len) {
+    if (len == 0) {
+      return;
+    }
+    if (segments_.empty() || segments_.back().ref != nullptr) {
+      segments_.push_back(segment{nullptr, owned_.size(), 0});
+    }
+    owned_.insert(owned_.end(), data, data + len);
+    segments_.back().len += len;
+    size_ += len;
+  }
+
+  void write_ref(const char *data, std::size_t len) {
+    if (len < threshold_) {
+      write(data, len);
+      return;
+    }
+    segments_.push_back(segment{data, 0, len});
+    size_ += len;
+  }
+
+  std::size_t tellp() const { return size_; }
+
+  // backpatched slots were reserved with write(), so each one lies in a
+  // single owned segment, most often one of the last
+  void write_at(std::size_t pos, const char *data, std::size_t len) {
+    std::size_t end = size_;
+    for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+      std::size_t begin = end - it->len;
+      if (pos >= begin) {
+        std::memcpy(owned_.data() + it->offset + (pos - begin), data, len);
+        return;
+      }
+      end = begin;
+    }
+  }
+
+  std::size_t size() const { return size_; }
+
+  // references the owned storage: valid until the next write or clear()
+  const std::vector<struct iovec> &iov() {
+    iov_.clear();
+    for (const auto &seg : segments_) {
+      const char *base = seg.ref ? seg.ref : owned_.data() + seg.offset;
+      iov_.push_back(iovec{const_cast<char *>(base), seg.len});
+    }
+    return iov_;
+  }
+
+  // copy the encoding into `dst`, which holds at least size() bytes
+  void gather(char *dst) const {
+    for (const auto &seg : segments_) {
+      const char *base = seg.ref ? seg.ref : owned_.data() + seg.offset;
+      std::memcpy(dst, base, seg.len);
+      dst += seg.len;
+    }
+  }
+
+  // write everything to `fd`, resuming after short writes. false with errno
+  // set on failure, EIO when the fd takes no bytes at all.
+  bool writev(int fd) {
+    iov();
+    auto &vec = iov_;
+    std::size_t index = 0;
+    while (index < vec.size()) {
+      int count = static_cast<int>(
+          vec.size() - index < IOV_MAX ? vec.size() - index : IOV_MAX);
+      ssize_t written = ::writev(fd, &vec[index], count);
+      if SER_UNLIKELY (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      if SER_UNLIKELY (written == 0 && pending(index) > 0) {
+        // nothing taken although bytes are left, retrying would spin
+        errno = EIO;
+        return false;
+      }
+      auto left = static_cast<std::size_t>(written);
+      while (index < vec.size() && left >= vec[index].iov_len) {
+        left -= vec[index].iov_len;
+        ++index;
+      }
+      if (left > 0) {
+        vec[index].iov_base = static_cast<char *>(vec[index].iov_base) + left;
+        vec[index].iov_len -= left;
+      }
+    }
+    return true;
+  }
+
+  // forget the encoding but keep the allocations for the next message
+  void clear() {
+    owned_.clear();
+    segments_.clear();
+    iov_.clear();
+    size_ = 0;
+  }
+
+ private:
+  // bytes of the iovecs from `index` on
+  std::size_t pending(std::size_t index) const {
+    std::size_t len = 0;
+    for (; index < iov_.size(); ++index) {
+      len += iov_[index].iov_len;
+    }
+    return len;
+  }
+
+  struct segment {
+    const char *ref;  // nullptr: `len` owned bytes at `offset`
+    std::size_t offset;
+    std::size_t len;
+  };
+
+  std::size_t threshold_;
+  std::size_t size_ = 0;
+  std::vector<char> owned_;
+  std::vector<segment> segments_;
+  std::vector<struct iovec> iov_;
+};
+
+}  // namespace detail
+}  // namespace serialize
@@ -22,17 +22,21 @@ struct memory_reader {
   const char *end;
   constexpr memory_reader(const char *b, const char *e) noexcept
       : now(b), end(e) {}
+  // lengths come from the buffer, so they are compared with what is left
+  // instead of being added to `now`, which could overflow
   bool read(char *target, std::size_t len) {
-    if (now + len > end) {
+    if (len > remaining()) {
       return false;
     }
-    std::memcpy(target, now, len);
+    if (len != 0) {
+      std::memcpy(target, now, len);
+    }
 
     now += len;
     return true;
   }
   const char *read_view(std::size_t len) {
-    if (now + len > end) {
+    if (len > remaining()) {
       return nullptr;
     }
     auto ret = now;
@@ -40,13 +44,16 @@ struct memory_reader {
     return ret;
   }
   bool ignore(std::size_t len) {
-    if (now + len > end) {
+    if (len > remaining()) {
       return false;
     }
     now += len;
     return true;
   }
   std::size_t tellg() { return (std::size_t)now; }
+  std::size_t remaining() const {
+    return static_cast<std::size_t>(end - now);
+  }
 };
 }  // namespace detail
 }  // namespace serialize
\ No newline at end of file
@@ -12,6 +12,8 @@
 #include <cstring>
 #include <iostream>
 
+#include "macro.hpp"
+
 namespace serialize {
 namespace detail {
 struct memory_writer {
@@ -20,6 +22,47 @@ struct memory_writer {
     std::memcpy(buffer, data, len);
     buffer += len;
   }
+  std::size_t tellp() const { return (std::size_t)buffer; }
+  void write_at(std::size_t pos, const char *data, std::size_t len) {
+    std::memcpy((char *)pos, data, len);
+  }
+};
+
+// writer over a buffer of fixed capacity, e.g. the user-payload of a loaned
+// shared memory chunk. A write which does not fit is dropped and flagged in
+// `overflow` instead of running past `end`; the flag sticks, so the writes
+// after it don't land at the offsets the dropped one should have taken.
+struct bounded_writer {
+  char *buffer;
+  char *end;
+  bool overflow = false;
+  void write(const char *data, std::size_t len) {
+    if SER_UNLIKELY (overflow) {
+      return;
+    }
+    if SER_UNLIKELY (len > static_cast<std::size_t>(end - buffer)) {
+      overflow = true;
+      return;
+    }
+    std::memcpy(buffer, data, len);
+    buffer += len;
+  }
+  std::size_t tellp() const { return (std::size_t)buffer; }
+  void write_at(std::size_t pos, const char *data, std::size_t len) {
+    if SER_UNLIKELY (overflow) {
+      return;
+    }
+    std::memcpy((char *)pos, data, len);
+  }
+};
+
+// writer which only counts, it sizes encodings whose length depends on the
+// offsets they are written at (the aligned layout).
+struct size_counting_writer {
+  std::size_t size = 0;
+  void write(const char *, std::size_t len) { size += len; }
+  std::size_t tellp() const { return size; }
+  void write_at(std::size_t, const char *, std::size_t) {}
 };
 
 }  // namespace detail
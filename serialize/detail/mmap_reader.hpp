@@ -0,0 +1,128 @@
+/*
+ * @Description: stream of messages read from a memory mapped file
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 23:18:02
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 23:18:02
+ */
+
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+
+#include "macro.hpp"
+#include "return_code.hpp"
+
+namespace serialize {
+namespace detail {
+
+// reads messages straight out of a mapped file: the window is everything
+// from the current position to the end of the mapping, so nothing is copied
+// or buffered. fetch() remaps when the file grew, e.g. a recording which is
+// still being written, and returns need_more_data otherwise; a message cut
+// off at the end stays in the window until the rest arrives.
+//
+// The fd is not owned and has to stay open for fetch(). Pages already passed
+// are dropped every kReleaseStep bytes, so replaying a file larger than
+// memory doesn't keep all of it resident. Views decoded from the window stay
+// valid until the next fetch().
+class mmap_reader {
+ public:
+  static constexpr std::size_t kReleaseStep = 64 * 1024 * 1024;
+
+  explicit mmap_reader(int fd) : fd_(fd) { map(); }
+
+  mmap_reader(const mmap_reader &) = delete;
+  mmap_reader &operator=(const mmap_reader &) = delete;
+
+  ~mmap_reader() { unmap(); }
+
+  // false when the file could not be mapped, errno tells why
+  bool valid() const { return !failed_; }
+
+  const char *data() const { return base_ + pos_; }
+  std::size_t size() const { return mapped_ - pos_; }
+
+  void consume(std::size_t len) {
+    pos_ += len;
+    if (pos_ - released_ >= kReleaseStep) {
+      release();
+    }
+  }
+
+  return_code fetch() {
+    std::size_t before = mapped_;
+    if SER_UNLIKELY (!map()) {
+      return return_code::read_failed;
+    }
+    return mapped_ > before ? return_code::ok : return_code::need_more_data;
+  }
+
+  // every message up to the current end of the file was consumed
+  bool at_end() {
+    if (size() == 0) {
+      fetch();
+    }
+    return size() == 0;
+  }
+
+ private:
+  bool map() {
+    struct stat st {};
+    if SER_UNLIKELY (::fstat(fd_, &st) != 0) {
+      failed_ = true;
+      return false;
+    }
+    auto file_size = static_cast<std::size_t>(st.st_size);
+    if (file_size <= mapped_) {
+      return true;
+    }
+    void *addr = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd_, 0);
+    if SER_UNLIKELY (addr == MAP_FAILED) {
+      failed_ = true;
+      return false;
+    }
+    ::madvise(addr, file_size, MADV_SEQUENTIAL);
+    unmap();
+    base_ = static_cast<const char *>(addr);
+    mapped_ = file_size;
+    released_ = 0;
+    failed_ = false;
+    return true;
+  }
+
+  void unmap() {
+    if (base_ != nullptr) {
+      ::munmap(const_cast<char *>(base_), mapped_);
+      base_ = nullptr;
+    }
+  }
+
+  // drop the whole pages before the current position, they are clean and
+  // fault back in from the file if they are ever touched again
+  void release() {
+    auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t end = pos_ / page * page;
+    if (end > released_) {
+      ::madvise(const_cast<char *>(base_) + released_, end - released_,
+                MADV_DONTNEED);
+      released_ = end;
+    }
+  }
+
+  int fd_;
+  const char *base_ = nullptr;
+  std::size_t mapped_ = 0;
+  std::size_t pos_ = 0;
+  std::size_t released_ = 0;
+  bool failed_ = false;
+};
+
+}  // namespace detail
+}  // namespace serialize
@@ -9,11 +9,14 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -21,9 +24,12 @@
 #include "../append_types/expected.hpp"
 #include "../append_types/optional.hpp"
 #include "../append_types/variant.hpp"
+#include "../ser_config.hpp"
 #include "for_each_macro.hpp"
 #include "trivial_view.hpp"
 #include "utils.hpp"
+#include "varint.hpp"
+#include "view.hpp"
 
 namespace serialize {
 namespace detail {
@@ -46,6 +52,90 @@ struct props_t_impl<T, std::void_t<typename remove_cvref_t<T>::LengthFieldType,
 template <typename T>
 constexpr bool props_t = props_t_impl<T>::value;
 
+// configs without kStructLayout keep the sequential layout
+template <typename T, typename = void>
+struct tagged_struct_impl : std::false_type {};
+
+template <typename T>
+struct tagged_struct_impl<
+    T, std::void_t<std::enable_if_t<remove_cvref_t<T>::kStructLayout ==
+                                    struct_layout::kTagged>>>
+    : std::true_type {};
+
+template <typename T>
+constexpr bool tagged_struct = tagged_struct_impl<T>::value;
+
+// width of the member length in front of each tagged struct member
+constexpr std::size_t kTaggedMemberLengthField = 4;
+
+// configs without kTypeInfo don't write the layout fingerprint
+template <typename T, typename = void>
+struct type_info_enabled_impl : std::false_type {};
+
+template <typename T>
+struct type_info_enabled_impl<
+    T, std::void_t<std::enable_if_t<remove_cvref_t<T>::kTypeInfo ==
+                                    ENABLE_TYPE_INFO>>> : std::true_type {};
+
+template <typename T>
+constexpr bool type_info_enabled = type_info_enabled_impl<T>::value;
+
+constexpr std::size_t kTypeInfoSize = sizeof(std::uint64_t);
+
+// caps on what a length field may announce, checked before anything is
+// allocated: kMaxStringLength (characters) and kMaxContainerLength (elements).
+// Configs without them accept any length the buffer can hold.
+template <typename T, typename = void>
+struct max_string_length_impl
+    : std::integral_constant<std::uint64_t, UINT64_MAX> {};
+
+template <typename T>
+struct max_string_length_impl<
+    T, std::void_t<decltype(remove_cvref_t<T>::kMaxStringLength)>>
+    : std::integral_constant<std::uint64_t,
+                             remove_cvref_t<T>::kMaxStringLength> {};
+
+template <typename T>
+constexpr std::uint64_t max_string_length = max_string_length_impl<T>::value;
+
+template <typename T, typename = void>
+struct max_container_length_impl
+    : std::integral_constant<std::uint64_t, UINT64_MAX> {};
+
+template <typename T>
+struct max_container_length_impl<
+    T, std::void_t<decltype(remove_cvref_t<T>::kMaxContainerLength)>>
+    : std::integral_constant<std::uint64_t,
+                             remove_cvref_t<T>::kMaxContainerLength> {};
+
+template <typename T>
+constexpr std::uint64_t max_container_length =
+    max_container_length_impl<T>::value;
+
+// configs without kAlignedLayout write members back to back
+template <typename T, typename = void>
+struct aligned_layout_impl : std::false_type {};
+
+template <typename T>
+struct aligned_layout_impl<
+    T, std::void_t<std::enable_if_t<remove_cvref_t<T>::kAlignedLayout>>>
+    : std::true_type {};
+
+template <typename T>
+constexpr bool aligned_layout = aligned_layout_impl<T>::value;
+
+// configs without kSortedKeys write unordered maps and sets in bucket order
+template <typename T, typename = void>
+struct sorted_keys_impl : std::false_type {};
+
+template <typename T>
+struct sorted_keys_impl<
+    T, std::void_t<std::enable_if_t<remove_cvref_t<T>::kSortedKeys>>>
+    : std::true_type {};
+
+template <typename T>
+constexpr bool sorted_keys = sorted_keys_impl<T>::value;
+
 // writer
 template <typename T, typename = void>
 struct writer_t_impl : std::false_type {};
@@ -58,6 +148,33 @@ struct writer_t_impl<T, std::void_t<decltype(std::declval<T>().write(
 template <typename T>
 constexpr bool writer_t = writer_t_impl<T>::value;
 
+template <typename T, typename = void>
+struct backpatch_writer_t_impl : std::false_type {};
+
+template <typename T>
+struct backpatch_writer_t_impl<
+    T, std::void_t<decltype(std::declval<T>().tellp()),
+                   decltype(std::declval<T>().write_at(
+                       std::size_t{}, (const char *)nullptr, std::size_t{}))>>
+    : std::true_type {};
+
+template <typename T>
+constexpr bool backpatch_writer_t =
+    writer_t<T> &&backpatch_writer_t_impl<T>::value;
+
+// writers which can reference a block of the serialized object instead of
+// copying it
+template <typename T, typename = void>
+struct ref_writer_t_impl : std::false_type {};
+
+template <typename T>
+struct ref_writer_t_impl<T, std::void_t<decltype(std::declval<T>().write_ref(
+                                (const char *)nullptr, std::size_t{}))>>
+    : std::true_type {};
+
+template <typename T>
+constexpr bool ref_writer_t = writer_t<T> &&ref_writer_t_impl<T>::value;
+
 // reader
 template <typename T, typename = void>
 struct reader_t_impl : std::false_type {};
@@ -83,6 +200,33 @@ struct view_reader_t_impl<
 template <typename T>
 constexpr bool view_reader_t = reader_t<T> &&view_reader_t_impl<T>::value;
 
+// readers which know how many bytes are left
+template <typename T, typename = void>
+struct bounded_reader_t_impl : std::false_type {};
+
+template <typename T>
+struct bounded_reader_t_impl<
+    T, std::void_t<decltype(std::declval<T>().remaining())>>
+    : std::true_type {};
+
+template <typename T>
+constexpr bool bounded_reader_t = reader_t<T> &&bounded_reader_t_impl<T>::value;
+
+// sources of a stream of messages: a window of buffered bytes which the
+// consumer takes from the front, and fetch() to extend it
+template <typename T, typename = void>
+struct stream_reader_t_impl : std::false_type {};
+
+template <typename T>
+struct stream_reader_t_impl<
+    T, std::void_t<decltype(std::declval<T>().data()),
+                   decltype(std::declval<T>().size()),
+                   decltype(std::declval<T>().consume(std::size_t{})),
+                   decltype(std::declval<T>().fetch())>> : std::true_type {};
+
+template <typename T>
+constexpr bool stream_reader_t = stream_reader_t_impl<T>::value;
+
 template <typename T, typename = void>
 struct seek_reader_t_impl : std::false_type {};
 
@@ -209,7 +353,7 @@ static constexpr bool is_std_vector_v<std::vector<args...>> = true;
 
 template <typename Type>
 static constexpr bool continuous_container =
-    string<Type> ||
+    string<Type> || dynamic_span<Type> ||
     (container<Type> && (is_std_vector_v<Type> || is_std_basic_string_v<Type>));
 
 // map
@@ -260,7 +404,8 @@ template <typename T>
 struct expected_or_optional_impl<
     T, std::void_t<typename remove_cvref_t<T>::value_type,
                    decltype(std::declval<T>().has_value()),
-                   decltype(std::declval<T>().value_or()),
+                   decltype(std::declval<T>().value_or(
+                       std::declval<typename remove_cvref_t<T>::value_type>())),
                    decltype(std::declval<T>().value())>> : std::true_type {};
 // TODO: check e.value()
 template <typename T>
@@ -288,6 +433,30 @@ struct bitset_impl<T, std::void_t<decltype(std::declval<T>().flip()),
 template <typename T>
 constexpr bool bitset = bitset_impl<T>::value;
 
+// containers which preallocate, e.g. vector, string and the unordered ones
+template <typename T, typename = void>
+struct reservable_impl : std::false_type {};
+
+template <typename T>
+struct reservable_impl<
+    T, std::void_t<decltype(std::declval<T &>().reserve(std::size_t{}))>>
+    : std::true_type {};
+
+template <typename T>
+constexpr bool reservable = reservable_impl<T>::value;
+
+// associative containers which keep their keys ordered, e.g. map and set
+template <typename T, typename = void>
+struct ordered_associative_impl : std::false_type {};
+
+template <typename T>
+struct ordered_associative_impl<
+    T, std::void_t<typename remove_cvref_t<T>::key_compare>>
+    : std::true_type {};
+
+template <typename T>
+constexpr bool ordered_associative = ordered_associative_impl<T>::value;
+
 // tuple
 
 template <template <typename...> class Template, typename T>
@@ -355,11 +524,16 @@ struct pair_impl<T, std::void_t<typename remove_cvref_t<T>::first_type,
 template <typename T>
 constexpr bool pair = pair_impl<T>::value;
 
+// varint
+template <typename T>
+constexpr bool varint_type = is_instantiation_of<serialize::varint, T>::value;
+
 // user struct
 template <typename T>
 constexpr bool user_struct =
     !container<T> && !bitset<T> && !pair<T> && !tuple<T> && !array<T> &&
-    !variant<T> && !pointer<T> && std::is_class<T>::value;
+    !variant<T> && !pointer<T> && !varint_type<T> && !optional<T> &&
+    !expected<T> && std::is_class<T>::value;
 
 template <typename T, typename = void>
 struct user_defined_refl_impl : std::false_type {};
@@ -673,6 +847,10 @@ struct is_trivial_serializable {
   static constexpr bool solve() {
     return false;
   }
+  template <typename T = Ty, std::enable_if_t<varint_type<T>, int> = 0>
+  static constexpr bool solve() {
+    return false;
+  }
 
   // map set string vector list deque queue optional expected
   template <typename T = Ty,
@@ -715,6 +893,9 @@ struct is_trivial_serializable {
   static constexpr bool value = is_trivial_serializable::solve();
 };
 
+template <typename Ty>
+constexpr bool is_trivial_serializable<Ty>::value;
+
 template <typename T, typename = void>
 struct trivially_copyable_container_impl : std::false_type {};
 
@@ -733,9 +914,17 @@ constexpr bool serialize_byte =
     std::is_same<char, T>::value || std::is_same<unsigned char, T>::value ||
     std::is_same<signed char, T>::value;
 
+template <typename T, typename = void>
+struct serialize_buffer_impl : std::false_type {};
+
+template <typename T>
+struct serialize_buffer_impl<
+    T, std::void_t<std::enable_if_t<serialize_byte<typename T::value_type>>>>
+    : std::true_type {};
+
 template <typename T>
 constexpr bool serialize_buffer =
-    trivially_copyable_container<T> &&serialize_byte<typename T::value_type>;
+    trivially_copyable_container<T> &&serialize_buffer_impl<T>::value;
 
 template <typename Func, typename... Args>
 constexpr decltype(auto) inline template_switch(std::size_t index,
@@ -1312,13 +1501,3 @@ friend const auto& SERIALIZE_GET(const Type& c);\
 template <std::size_t I> \
 friend struct SERIALIZE_CONCAT(Type,RETURN_ELEMENT);
 
-struct person1 {
-  int age;
-  double weight;
-  int add;
-
-  constexpr bool operator==(const person1& other) const {
-    return age == other.age && weight == other.weight && add == other.add;
-  }
-};
-SERIALIZE_REFL(person1, age, weight, add);
\ No newline at end of file
@@ -18,6 +18,11 @@ enum class return_code {
   invalid_buffer,
   seek_failed,
   length_error,
+  unaligned_view,
+  type_mismatch,
+  out_of_range,
+  need_more_data,
+  read_failed,
 };
 
 namespace detail {
@@ -36,6 +41,16 @@ class serialize_category : public std::error_category {
         return "no buffer space";
       case return_code::invalid_buffer:
         return "invalid argument";
+      case return_code::unaligned_view:
+        return "view target is not aligned for its element type";
+      case return_code::type_mismatch:
+        return "layout fingerprint does not match the target type";
+      case return_code::out_of_range:
+        return "index out of range";
+      case return_code::need_more_data:
+        return "the message is not complete yet";
+      case return_code::read_failed:
+        return "reading the source failed";
 
       default:
         return "(unrecognized error)";
@@ -8,37 +8,73 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <type_traits>
+#include <vector>
 
 #include "append_types/apply.hpp"
+#include "detail/alignment.hpp"
 #include "detail/calculate_size.hpp"
 #include "detail/endian_wrapper.hpp"
+#include "detail/fingerprint.hpp"
+#include "detail/memory_writer.hpp"
 #include "detail/reflection.hpp"
 #include "ser_config.hpp"
 
 namespace serialize {
 namespace detail {
 
+// unordered maps and sets which kSortedKeys writes in key order
+template <typename conf, type_id id, typename T>
+constexpr bool sorted_unordered =
+    sorted_keys<conf> &&
+    (id == type_id::map_container_t || id == type_id::set_container_t) &&
+    !ordered_associative<T>;
+
 template <typename writer, typename serialize_conf>
 class Serializer {
  public:
-  Serializer(writer &w, const std::size_t &in) : writer_(w), info_(in) {
+  Serializer(writer &w, const std::size_t &in)
+      : writer_(w), info_(in), start_(initial_offset(w)) {
     static_assert(writer_t<writer>,
                   "The writer type must satisfy requirements!");
+    static_assert(!aligned_layout<serialize_conf> || backpatch_writer_t<writer>,
+                  "The aligned layout needs a writer with tellp!");
   }
   Serializer(const Serializer &) = delete;
   Serializer &operator=(const Serializer &) = delete;
 
   template <typename T, typename... Args>
   inline void serialize(const T &t, const Args &...args) {
+    serialize_type_info<T, Args...>();
     serialize_many(t, args...);
   }
 
+  // values only, for containers which carry one type info header for many
+  template <typename... Args>
+  inline void serialize_values(const Args &...args) {
+    serialize_many(args...);
+  }
+
  private:
+  template <typename... Args, typename conf = serialize_conf,
+            std::enable_if_t<!type_info_enabled<conf>, int> = 0>
+  constexpr void serialize_type_info() {}
+
+  template <typename... Args, typename conf = serialize_conf,
+            std::enable_if_t<type_info_enabled<conf>, int> = 0>
+  constexpr void serialize_type_info() {
+    constexpr std::uint64_t fingerprint = get_type_fingerprint<Args...>();
+    write_wrapper<serialize_conf::kByteOrder == byte_order::kLittleEndian,
+                  kTypeInfoSize>(writer_, (char *)&fingerprint);
+  }
+
   constexpr void serialize_many() {}
 
   template <typename First, typename... Args>
@@ -56,12 +92,23 @@ class Serializer {
                            std::is_fundamental<T>::value ||
                            std::is_enum<T>::value,
                        int> = 0) {
+    align_to(alignof(T));
     write_wrapper<serialize_conf::kByteOrder == byte_order::kLittleEndian,
                   sizeof(item)>(writer_, (char *)&item);
   }
   template <type_id id, typename T>
+  constexpr void inline serialize_one_helper(
+      const T &item,
+      std::enable_if_t<id == type_id::v_int32_t || id == type_id::v_int64_t ||
+                           id == type_id::v_uint32_t ||
+                           id == type_id::v_uint64_t,
+                       int> = 0) {
+    write_varint(writer_, varint_encode_value(item.value));
+  }
+  template <type_id id, typename T>
   constexpr void inline serialize_one_helper(
       const T &item, std::enable_if_t<id == type_id::bitset_t, int> = 0) {
+    align_to(alignof(T));
     write_bytes_array(writer_, (char *)&item, sizeof(item));
   }
 
@@ -75,8 +122,8 @@ class Serializer {
                                              byte_order::kLittleEndian,
                                          sizeof(item[0])>),
           int> = 0) {
-    write_bytes_array(writer_, (char *)&item,
-                      sizeof(remove_cvref_t<decltype(item)>));
+    align_to(alignof(T));
+    write_blob((const char *)&item, sizeof(remove_cvref_t<decltype(item)>));
   }
   template <type_id id, typename T>
   constexpr void inline serialize_one_helper(
@@ -86,12 +133,29 @@ class Serializer {
               !(is_trivial_serializable<T>::value &&
                 is_little_endian_copyable<serialize_conf::kByteOrder ==
                                               byte_order::kLittleEndian,
-                                          sizeof(item[0])>),
+                                          sizeof(item[0])>) &&
+              !bulk_swap_needed<serialize_conf::kByteOrder ==
+                                    byte_order::kLittleEndian,
+                                remove_cvref_t<decltype(item[0])>>,
           int> = 0) {
     for (const auto &i : item) {
       serialize_one(i);
     }
   }
+  template <type_id id, typename T>
+  constexpr void inline serialize_one_helper(
+      const T &item,
+      std::enable_if_t<
+          id == type_id::array_t &&
+              bulk_swap_needed<serialize_conf::kByteOrder ==
+                                   byte_order::kLittleEndian,
+                               remove_cvref_t<decltype(item[0])>>,
+          int> = 0) {
+    auto count = static_cast<std::size_t>(std::end(item) - std::begin(item));
+    align_to(alignof(T));
+    write_swapped_array<sizeof(item[0])>(writer_, (const char *)&item[0],
+                                         count);
+  }
 
   template <type_id id, typename T>
   constexpr void inline serialize_one_helper(
@@ -100,13 +164,18 @@ class Serializer {
                       (serialize_conf::kStringLengthField == 1 ||
                        serialize_conf::kStringLengthField == 2 ||
                        serialize_conf::kStringLengthField == 4 ||
-                       serialize_conf::kStringLengthField == 8),
+                       serialize_conf::kStringLengthField == 8 ||
+                       serialize_conf::kStringLengthField ==
+                           kVarintLengthField),
                   "");
     uint64_t size = item.size() + 1;
     serialize_length_field<serialize_conf::kStringLengthField>(size);
     using value_type = typename T::value_type;
-    write_bytes_array(writer_, (char *)item.data(),
-                      item.size() * sizeof(value_type));
+    align_to(alignof(value_type));
+    write_blob((const char *)item.data(), item.size() * sizeof(value_type));
+    // the length field counts the terminator, so it is on the wire as well
+    value_type terminator{};
+    write_bytes_array(writer_, (char *)&terminator, sizeof(value_type));
   }
 
   template <type_id id, typename T>
@@ -124,13 +193,15 @@ class Serializer {
                       (serialize_conf::kArrayLengthField == 1 ||
                        serialize_conf::kArrayLengthField == 2 ||
                        serialize_conf::kArrayLengthField == 4 ||
-                       serialize_conf::kArrayLengthField == 8),
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
                   "");
     uint64_t size = item.size();
     serialize_length_field<serialize_conf::kArrayLengthField>(size);
     using value_type = typename T::value_type;
-    write_bytes_array(writer_, (char *)item.data(),
-                      item.size() * sizeof(value_type));
+    align_to(alignof(value_type));
+    write_blob((const char *)item.data(), item.size() * sizeof(value_type));
   }
 
   template <type_id id, typename T>
@@ -142,13 +213,20 @@ class Serializer {
               !(trivially_copyable_container<T> &&
                 is_little_endian_copyable<serialize_conf::kByteOrder ==
                                               byte_order::kLittleEndian,
-                                          sizeof(typename T::value_type)>),
+                                          sizeof(typename T::value_type)>) &&
+              !(trivially_copyable_container<T> &&
+                bulk_swap_needed<serialize_conf::kByteOrder ==
+                                     byte_order::kLittleEndian,
+                                 typename T::value_type>) &&
+              !sorted_unordered<serialize_conf, id, T>,
           int> = 0) {
     static_assert((serialize_conf::kArrayLengthField > 0) &&
                       (serialize_conf::kArrayLengthField == 1 ||
                        serialize_conf::kArrayLengthField == 2 ||
                        serialize_conf::kArrayLengthField == 4 ||
-                       serialize_conf::kArrayLengthField == 8),
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
                   "");
     uint64_t size = item.size();
     serialize_length_field<serialize_conf::kArrayLengthField>(size);
@@ -157,6 +235,75 @@ class Serializer {
     }
   }
 
+  // unordered maps and sets under kSortedKeys: the elements are visited in
+  // key order through a sorted list of pointers to them
+  template <type_id id, typename T>
+  void inline serialize_one_helper(
+      const T &item, std::enable_if_t<sorted_unordered<serialize_conf, id, T>, int> = 0) {
+    static_assert((serialize_conf::kArrayLengthField > 0) &&
+                      (serialize_conf::kArrayLengthField == 1 ||
+                       serialize_conf::kArrayLengthField == 2 ||
+                       serialize_conf::kArrayLengthField == 4 ||
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
+                  "");
+    uint64_t size = item.size();
+    serialize_length_field<serialize_conf::kArrayLengthField>(size);
+    std::vector<const typename T::value_type *> sorted;
+    sorted.reserve(item.size());
+    for (const auto &i : item) {
+      sorted.push_back(&i);
+    }
+    std::less<typename T::key_type> less;
+    std::sort(sorted.begin(), sorted.end(),
+              [&less](const auto *a, const auto *b) {
+                return less(sort_key<id>(*a), sort_key<id>(*b));
+              });
+    for (const auto *i : sorted) {
+      serialize_one(*i);
+    }
+  }
+
+  template <type_id id, typename V,
+            std::enable_if_t<id == type_id::map_container_t, int> = 0>
+  static constexpr const auto &sort_key(const V &value) {
+    return value.first;
+  }
+
+  template <type_id id, typename V,
+            std::enable_if_t<id == type_id::set_container_t, int> = 0>
+  static constexpr const V &sort_key(const V &value) {
+    return value;
+  }
+
+  template <type_id id, typename T>
+  constexpr void inline serialize_one_helper(
+      const T &item,
+      std::enable_if_t<
+          (id == type_id::container_t || id == type_id::map_container_t ||
+           id == type_id::set_container_t) &&
+              trivially_copyable_container<T> &&
+              bulk_swap_needed<serialize_conf::kByteOrder ==
+                                   byte_order::kLittleEndian,
+                               typename T::value_type>,
+          int> = 0) {
+    static_assert((serialize_conf::kArrayLengthField > 0) &&
+                      (serialize_conf::kArrayLengthField == 1 ||
+                       serialize_conf::kArrayLengthField == 2 ||
+                       serialize_conf::kArrayLengthField == 4 ||
+                       serialize_conf::kArrayLengthField == 8 ||
+                       serialize_conf::kArrayLengthField ==
+                           kVarintLengthField),
+                  "");
+    uint64_t size = item.size();
+    serialize_length_field<serialize_conf::kArrayLengthField>(size);
+    using value_type = typename T::value_type;
+    align_to(alignof(value_type));
+    write_swapped_array<sizeof(value_type)>(writer_, (const char *)item.data(),
+                                            item.size());
+  }
+
   template <type_id id, typename T>
   constexpr void inline serialize_one_helper(
       const T &item, std::enable_if_t<id == type_id::pair_t, int> = 0) {
@@ -228,12 +375,53 @@ class Serializer {
   constexpr void inline serialize_one_helper(
       const T &item,
       std::enable_if_t<(id == type_id::struct_t) &&
-                           serialize_conf::kStructLengthField != 0,
+                           serialize_conf::kStructLengthField != 0 &&
+                           !fixed_size_v<serialize_conf, T> &&
+                           !backpatch_writer_t<writer>,
                        int> = 0) {
     auto size_info = calculate_payload_size<serialize_conf>(item);
     uint64_t size = size_info.total + size_info.length_field;
     serialize_length_field<serialize_conf::kStructLengthField>(size);
-    visit_members(item, [this](auto &&...items) { serialize_many(items...); });
+    serialize_struct_body(item);
+  }
+
+  template <type_id id, typename T>
+  constexpr void inline serialize_one_helper(
+      const T &item,
+      std::enable_if_t<(id == type_id::struct_t) &&
+                           serialize_conf::kStructLengthField != 0 &&
+                           fixed_size_v<serialize_conf, T> &&
+                           !aligned_layout<serialize_conf>,
+                       int> = 0) {
+    constexpr auto size_info = get_size_plan<serialize_conf, T>().size;
+    uint64_t size = size_info.total + size_info.length_field;
+    serialize_length_field<serialize_conf::kStructLengthField>(size);
+    serialize_struct_body(item);
+  }
+
+  // reserve the length slot, write the members, then patch the measured
+  // length back, so nested structs are not walked once per nesting level.
+  // Padding makes the planned size of the aligned layout offset dependent, so
+  // it always measures.
+  template <type_id id, typename T>
+  constexpr void inline serialize_one_helper(
+      const T &item,
+      std::enable_if_t<(id == type_id::struct_t) &&
+                           serialize_conf::kStructLengthField != 0 &&
+                           (!fixed_size_v<serialize_conf, T> ||
+                            aligned_layout<serialize_conf>) &&
+                           backpatch_writer_t<writer>,
+                       int> = 0) {
+    constexpr auto length_field = serialize_conf::kStructLengthField;
+    std::array<char, 8> slot{};
+    align_to(length_field);
+    auto pos = writer_.tellp();
+    writer_.write(slot.data(), length_field);
+    serialize_struct_body(item);
+    uint64_t size = writer_.tellp() - pos;
+    memory_writer slot_writer{slot.data()};
+    serialize_length_field<length_field>(slot_writer, size);
+    writer_.write_at(pos, slot.data(), length_field);
   }
 
   template <type_id id, typename T>
@@ -242,11 +430,85 @@ class Serializer {
       std::enable_if_t<(id == type_id::struct_t) &&
                            serialize_conf::kStructLengthField == 0,
                        int> = 0) {
+    serialize_struct_body(item);
+  }
+
+  // the aligned layout pads a struct to its alignment on both ends, like an
+  // element of an array of it
+  template <typename T>
+  constexpr void inline serialize_struct_body(const T &item) {
+    align_to(alignof(T));
+    serialize_members(item);
+    align_to(alignof(T));
+  }
+
+  template <typename T, typename conf = serialize_conf,
+            std::enable_if_t<!tagged_struct<conf>, int> = 0>
+  constexpr void inline serialize_members(const T &item) {
     visit_members(item, [this](auto &&...items) { serialize_many(items...); });
   }
 
+  // member count, then tag, length and payload of every member
+  template <typename T, typename conf = serialize_conf,
+            std::enable_if_t<tagged_struct<conf>, int> = 0>
+  constexpr void inline serialize_members(const T &item) {
+    write_varint(writer_, members_count<T>());
+    visit_members(item, [this](auto &&...items) {
+      std::uint64_t tag = 0;
+      static_cast<void>(std::initializer_list<int>{
+          (serialize_tagged_member(++tag, items), 0)...});
+    });
+  }
+
+  template <typename T, typename w = writer,
+            std::enable_if_t<backpatch_writer_t<w>, int> = 0>
+  constexpr void inline serialize_tagged_member(std::uint64_t tag,
+                                                const T &item) {
+    write_varint(writer_, tag);
+    std::array<char, kTaggedMemberLengthField> slot{};
+    align_to(kTaggedMemberLengthField);
+    auto pos = writer_.tellp();
+    writer_.write(slot.data(), slot.size());
+    serialize_one(item);
+    uint64_t size = writer_.tellp() - pos - slot.size();
+    memory_writer slot_writer{slot.data()};
+    serialize_length_field<kTaggedMemberLengthField>(slot_writer, size);
+    writer_.write_at(pos, slot.data(), slot.size());
+  }
+
+  template <typename T, typename w = writer,
+            std::enable_if_t<!backpatch_writer_t<w>, int> = 0>
+  constexpr void inline serialize_tagged_member(std::uint64_t tag,
+                                                const T &item) {
+    write_varint(writer_, tag);
+    auto size_info = calculate_one_size<serialize_conf>()(item);
+    uint64_t size = size_info.total + size_info.length_field;
+    serialize_length_field<kTaggedMemberLengthField>(size);
+    serialize_one(item);
+  }
+
+  // a block of the serialized object itself, which a ref writer may reference
+  template <typename w = writer, std::enable_if_t<ref_writer_t<w>, int> = 0>
+  void inline write_blob(const char *data, std::size_t len) {
+    writer_.write_ref(data, len);
+  }
+
+  template <typename w = writer, std::enable_if_t<!ref_writer_t<w>, int> = 0>
+  void inline write_blob(const char *data, std::size_t len) {
+    write_bytes_array(writer_, data, len);
+  }
+
   template <std::uint8_t length_field>
   constexpr auto inline serialize_length_field(std::uint64_t &size64) {
+    if (length_field != kVarintLengthField) {
+      align_to(length_field);
+    }
+    serialize_length_field<length_field>(writer_, size64);
+  }
+
+  template <std::uint8_t length_field, typename Writer>
+  constexpr auto inline serialize_length_field(Writer &w,
+                                               std::uint64_t &size64) {
     std::uint8_t size8 = 0;
     std::uint16_t size16 = 0;
     std::uint32_t size32 = 0;
@@ -256,27 +518,57 @@ class Serializer {
       case 1:
         size8 = static_cast<uint8_t>(size64);
         write_wrapper<serialize_conf::kByteOrder == byte_order::kLittleEndian,
-                      1>(writer_, (char *)&size8);
+                      1>(w, (char *)&size8);
         break;
       case 2:
         size16 = static_cast<uint16_t>(size64);
         write_wrapper<serialize_conf::kByteOrder == byte_order::kLittleEndian,
-                      2>(writer_, (char *)&size16);
+                      2>(w, (char *)&size16);
         break;
       case 4:
         size32 = static_cast<uint32_t>(size64);
         write_wrapper<serialize_conf::kByteOrder == byte_order::kLittleEndian,
-                      4>(writer_, (char *)&size32);
+                      4>(w, (char *)&size32);
         break;
       case 8:
         write_wrapper<serialize_conf::kByteOrder == byte_order::kLittleEndian,
-                      8>(writer_, (char *)&size64);
+                      8>(w, (char *)&size64);
+        break;
+      case kVarintLengthField:
+        write_varint(w, size64);
         break;
       default:
         unreachable();
     }
   }
 
+  template <typename conf = serialize_conf,
+            std::enable_if_t<!aligned_layout<conf>, int> = 0>
+  constexpr void inline align_to(std::size_t) {}
+
+  template <typename conf = serialize_conf,
+            std::enable_if_t<aligned_layout<conf>, int> = 0>
+  constexpr void inline align_to(std::size_t align) {
+    constexpr std::array<char, 8> zeros{};
+    auto padding = aligned_padding_size<serialize_conf>(
+        writer_.tellp() - start_, align == 0 ? 1 : align);
+    if (padding != 0) {
+      writer_.write(zeros.data(), padding);
+    }
+  }
+
+  template <typename w = writer,
+            std::enable_if_t<backpatch_writer_t<w>, int> = 0>
+  static std::size_t inline initial_offset(w &wr) {
+    return wr.tellp();
+  }
+
+  template <typename w = writer,
+            std::enable_if_t<!backpatch_writer_t<w>, int> = 0>
+  static std::size_t inline initial_offset(w &) {
+    return 0;
+  }
+
   template <typename T>
   constexpr void inline serialize_one(const T &item) {
     using type = remove_cvref_t<decltype(item)>;
@@ -287,9 +579,24 @@ class Serializer {
 
  private:
   writer &writer_;
+  // size the buffer was allocated with. Not read: fixed-size types are sized
+  // by get_size_plan and variable ones backpatch their struct length fields.
   const std::size_t &info_;
+  // padding is computed against offsets from here
+  std::size_t start_;
 };
 
+// the aligned layout is sized by running the serializer over a counting
+// writer, its padding depends on where every field lands.
+template <typename conf, typename... Args>
+std::size_t get_aligned_serialize_size(const Args &...args) {
+  size_counting_writer counter{};
+  std::size_t info = 0;
+  Serializer<size_counting_writer, conf> o(counter, info);
+  o.template serialize(args...);
+  return counter.size;
+}
+
 template <typename conf, typename Writer, typename... Args>
 void serialize_to(Writer &writer, const std::size_t &info,
                   const Args &...args) {
@@ -27,5 +27,15 @@ struct size_info {
   }
 };
 
+// compile-time sizing of a type: when `fixed` is set, every value of the type
+// encodes to exactly `size` bytes and no runtime walk is needed. Otherwise
+// `size` is a lower bound: the fixed parts plus the shortest encoding of the
+// variable ones. Where their length fields land depends on the values, so the
+// plan doesn't record it and such types are still walked to be sized.
+struct size_plan {
+  bool fixed;
+  size_info size;
+};
+
 }  // namespace detail
 }  // namespace serialize
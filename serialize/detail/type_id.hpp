@@ -362,6 +362,16 @@ constexpr type_id get_type_id() {
   return type_id::pair_t;
 }
 
+template <typename T, std::enable_if_t<varint_type<T>, int> = 0>
+constexpr type_id get_type_id() {
+  static_assert(CHAR_BIT == 8, "");
+  using value_type = typename T::value_type;
+  return std::is_same<value_type, std::int32_t>::value    ? type_id::v_int32_t
+         : std::is_same<value_type, std::int64_t>::value  ? type_id::v_int64_t
+         : std::is_same<value_type, std::uint32_t>::value ? type_id::v_uint32_t
+                                                          : type_id::v_uint64_t;
+}
+
 // TODO unsupported
 
 }  // namespace detail
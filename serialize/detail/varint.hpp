@@ -0,0 +1,157 @@
+/*
+ * @Description: LEB128 variable length integers and zigzag mapping
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 15:42:31
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 15:42:31
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "macro.hpp"
+
+namespace serialize {
+
+// integer which is encoded as LEB128, signed values are zigzag mapped first so
+// that small negative numbers stay short.
+template <typename T>
+struct varint {
+  static_assert(std::is_same<T, std::int32_t>::value ||
+                    std::is_same<T, std::int64_t>::value ||
+                    std::is_same<T, std::uint32_t>::value ||
+                    std::is_same<T, std::uint64_t>::value,
+                "varint only wraps 32 and 64 bit integers");
+  using value_type = T;
+
+  T value;
+
+  constexpr varint() noexcept : value(0) {}
+  constexpr varint(T v) noexcept : value(v) {}
+  constexpr operator T() const noexcept { return value; }
+
+  constexpr bool operator==(const varint &other) const {
+    return value == other.value;
+  }
+  constexpr bool operator!=(const varint &other) const {
+    return value != other.value;
+  }
+};
+
+using var_int32_t = varint<std::int32_t>;
+using var_int64_t = varint<std::int64_t>;
+using var_uint32_t = varint<std::uint32_t>;
+using var_uint64_t = varint<std::uint64_t>;
+
+namespace detail {
+
+constexpr std::size_t kMaxVarintSize = 10;
+
+constexpr std::size_t varint_size(std::uint64_t value) {
+  std::size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+constexpr std::uint64_t zigzag_encode(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+constexpr std::int64_t zigzag_decode(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^
+         -static_cast<std::int64_t>(value & 1);
+}
+
+template <typename T, std::enable_if_t<std::is_signed<T>::value, int> = 0>
+constexpr std::uint64_t varint_encode_value(T value) {
+  return zigzag_encode(value);
+}
+
+template <typename T, std::enable_if_t<std::is_unsigned<T>::value, int> = 0>
+constexpr std::uint64_t varint_encode_value(T value) {
+  return value;
+}
+
+// false if `raw` is out of range for T
+template <typename T, std::enable_if_t<std::is_signed<T>::value, int> = 0>
+constexpr bool varint_decode_value(std::uint64_t raw, T &value) {
+  auto decoded = zigzag_decode(raw);
+  if (decoded < std::numeric_limits<T>::min() ||
+      decoded > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  value = static_cast<T>(decoded);
+  return true;
+}
+
+template <typename T, std::enable_if_t<std::is_unsigned<T>::value, int> = 0>
+constexpr bool varint_decode_value(std::uint64_t raw, T &value) {
+  if (raw > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  value = static_cast<T>(raw);
+  return true;
+}
+
+template <typename writer_t>
+void write_varint(writer_t &writer, std::uint64_t value) {
+  char buffer[kMaxVarintSize];
+  std::size_t size = 0;
+  while (value >= 0x80) {
+    buffer[size++] = static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  buffer[size++] = static_cast<char>(value);
+  writer.write(buffer, size);
+}
+
+enum class varint_status { ok, short_read, malformed };
+
+// one and two byte values (everything below 16384) return before the loop
+template <typename reader_t>
+varint_status read_varint(reader_t &reader, std::uint64_t &value) {
+  std::uint8_t byte = 0;
+  if SER_UNLIKELY (!reader.read((char *)&byte, 1)) {
+    return varint_status::short_read;
+  }
+  if SER_LIKELY (byte < 0x80) {
+    value = byte;
+    return varint_status::ok;
+  }
+  std::uint64_t result = byte & 0x7f;
+  if SER_UNLIKELY (!reader.read((char *)&byte, 1)) {
+    return varint_status::short_read;
+  }
+  if SER_LIKELY (byte < 0x80) {
+    value = result | (static_cast<std::uint64_t>(byte) << 7);
+    return varint_status::ok;
+  }
+  result |= static_cast<std::uint64_t>(byte & 0x7f) << 7;
+  for (unsigned shift = 14; shift < 64; shift += 7) {
+    if SER_UNLIKELY (!reader.read((char *)&byte, 1)) {
+      return varint_status::short_read;
+    }
+    result |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      // the tenth byte only carries the top bit of a 64 bit value
+      if SER_UNLIKELY (shift == 63 && byte > 1) {
+        return varint_status::malformed;
+      }
+      value = result;
+      return varint_status::ok;
+    }
+  }
+  return varint_status::malformed;
+}
+
+}  // namespace detail
+}  // namespace serialize
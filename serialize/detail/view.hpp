@@ -0,0 +1,116 @@
+/*
+ * @Description: non-owning string and span views for zero-copy decoding
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 14:20:05
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 14:20:05
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace serialize {
+
+// read-only view over a run of characters. When it is the deserialize target
+// it points into the source buffer instead of owning a copy.
+template <typename CharT>
+class basic_string_view {
+ public:
+  using value_type = CharT;
+  using const_pointer = const CharT *;
+  using const_iterator = const CharT *;
+  using iterator = const_iterator;
+  using size_type = std::size_t;
+
+  constexpr basic_string_view() noexcept : data_(nullptr), size_(0) {}
+  constexpr basic_string_view(const CharT *data, std::size_t size) noexcept
+      : data_(data), size_(size) {}
+  template <typename Traits, typename Alloc>
+  basic_string_view(const std::basic_string<CharT, Traits, Alloc> &str) noexcept
+      : data_(str.data()), size_(str.size()) {}
+
+  constexpr const CharT *data() const noexcept { return data_; }
+  constexpr std::size_t size() const noexcept { return size_; }
+  constexpr std::size_t length() const noexcept { return size_; }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+  constexpr const_iterator begin() const noexcept { return data_; }
+  constexpr const_iterator end() const noexcept { return data_ + size_; }
+  constexpr const CharT &operator[](std::size_t pos) const {
+    return data_[pos];
+  }
+
+  std::basic_string<CharT> to_string() const {
+    return std::basic_string<CharT>(data_, size_);
+  }
+
+  friend bool operator==(const basic_string_view &lhs,
+                         const basic_string_view &rhs) noexcept {
+    if (lhs.size_ != rhs.size_) {
+      return false;
+    }
+    for (std::size_t i = 0; i < lhs.size_; ++i) {
+      if (lhs.data_[i] != rhs.data_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+  friend bool operator!=(const basic_string_view &lhs,
+                         const basic_string_view &rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+ private:
+  const CharT *data_;
+  std::size_t size_;
+};
+
+using string_view = basic_string_view<char>;
+
+// contiguous view over trivially copyable elements, dynamic extent only. When
+// it is the deserialize target it points into the source buffer.
+template <typename T>
+class span {
+ public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T *;
+  using iterator = T *;
+  using const_iterator = const T *;
+  using size_type = std::size_t;
+  static constexpr std::size_t extent = SIZE_MAX;
+
+  constexpr span() noexcept : data_(nullptr), size_(0) {}
+  constexpr span(T *data, std::size_t size) noexcept
+      : data_(data), size_(size) {}
+  template <typename Container,
+            typename = decltype(std::declval<Container &>().data())>
+  constexpr span(Container &c) noexcept : data_(c.data()), size_(c.size()) {}
+
+  constexpr T *data() const noexcept { return data_; }
+  constexpr std::size_t size() const noexcept { return size_; }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+  constexpr iterator begin() const noexcept { return data_; }
+  constexpr iterator end() const noexcept { return data_ + size_; }
+  constexpr T &operator[](std::size_t pos) const { return data_[pos]; }
+
+  constexpr span subspan(std::size_t offset, std::size_t count) const {
+    assert(offset + count <= size_);
+    return span{data_ + offset, count};
+  }
+
+ private:
+  T *data_;
+  std::size_t size_;
+};
+
+template <typename T>
+constexpr std::size_t span<T>::extent;
+
+}  // namespace serialize
@@ -0,0 +1,108 @@
+/*
+ * @Description: libFuzzer harness decoding untrusted bytes as the test types
+ * @Version: 2.0
+ * @Author: chen, hua
+ * @Date: 2026-10-16 21:48:26
+ * @LastEditors: chen, hua
+ * @LastEditTime: 2026-10-16 21:48:26
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "serialize.hpp"
+#include "test/user_defined_struct.h"
+
+#ifdef SERIALIZE_FUZZ_STANDALONE
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#endif
+
+namespace {
+
+using mixed_t =
+    std::tuple<std::vector<std::string>, std::map<int, std::string>,
+               std::set<std::uint64_t>, mpark::variant<int, std::string>,
+               std::unique_ptr<person1>, std::unordered_map<int, person2>>;
+
+// every input is decoded as each type, through a fresh and a reused target.
+// Results are ignored: the harness only looks for crashes, leaks and the
+// oversized allocations a corrupted length field used to cause.
+template <typename conf, typename T>
+void decode_as(const char *data, std::size_t size) {
+  T fresh{};
+  serialize::deserialize_to<conf>(fresh, data, size);
+  serialize::deserialize_to<conf>(fresh, data, size);
+}
+
+template <typename conf>
+void decode_all(const char *data, std::size_t size) {
+  decode_as<conf, person1>(data, size);
+  decode_as<conf, person2>(data, size);
+  decode_as<conf, person3>(data, size);
+  decode_as<conf, A>(data, size);
+  decode_as<conf, AA>(data, size);
+  decode_as<conf, sample_msg>(data, size);
+  decode_as<conf, record_v1>(data, size);
+  decode_as<conf, record_v2>(data, size);
+  decode_as<conf, mixed_t>(data, size);
+}
+
+template <typename conf>
+void decode_batches(const char *data, std::size_t size) {
+  std::vector<person1> fixed;
+  serialize::deserialize_batch_to<conf>(fixed, data, size);
+  std::vector<record_v2> records;
+  serialize::deserialize_batch_to<conf>(records, data, size);
+  record_v2 one{};
+  serialize::deserialize_batch_at<conf>(one, data, size, 1);
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *bytes,
+                                      std::size_t size) {
+  auto data = reinterpret_cast<const char *>(bytes);
+  decode_all<serialize::serialize_props_default>(data, size);
+  decode_all<serialize_props>(data, size);
+  decode_all<serialize_props_varint>(data, size);
+  decode_all<serialize_props_tagged>(data, size);
+  decode_all<serialize_props_aligned>(data, size);
+  decode_all<serialize_props_aligned_framed>(data, size);
+  decode_all<serialize_props_type_info>(data, size);
+  decode_all<serialize_props_limited>(data, size);
+
+  decode_as<serialize_props_type_info, sample_msg_view>(data, size);
+  serialize::view<serialize_props_aligned_typed, sensor_frame>(data, size);
+  decode_batches<serialize_props_type_info>(data, size);
+  decode_batches<serialize_props_aligned>(data, size);
+  return 0;
+}
+
+#ifdef SERIALIZE_FUZZ_STANDALONE
+// without libFuzzer: replay the inputs named on the command line, e.g. a
+// corpus or a crash reproducer
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    if (!file) {
+      std::cerr << "can't open " << argv[i] << std::endl;
+      return 1;
+    }
+    std::vector<char> input{std::istreambuf_iterator<char>(file),
+                            std::istreambuf_iterator<char>()};
+    LLVMFuzzerTestOneInput(
+        reinterpret_cast<const std::uint8_t *>(input.data()), input.size());
+  }
+  return 0;
+}
+#endif
@@ -12,6 +12,9 @@
 #include <cstdint>
 namespace serialize {
 
+// a config with `static constexpr ser_config kTypeInfo = ENABLE_TYPE_INFO`
+// puts the 8 byte layout fingerprint of the serialized types in front of the
+// payload, and deserialize rejects a buffer whose fingerprint differs.
 enum ser_config {
   DEFAULT = 0,
   DISABLE_TYPE_INFO = 0b1,
@@ -39,6 +42,21 @@ enum class length_field_size : std::uint8_t {
   k16 = 16,
 };
 
+// kSequential writes struct members back to back. kTagged prefixes each member
+// with its tag (index + 1, varint) and a 4 byte length, so readers skip tags
+// they don't know and value-initialize members they don't receive, also in a
+// reused target. Configs select it with
+// `static constexpr struct_layout kStructLayout`.
+enum class struct_layout : std::uint8_t {
+  kSequential = 0,
+  kTagged = 1,
+};
+
+// length field value which selects a LEB128 varint prefix instead of a fixed
+// width one. Valid for kStringLengthField, kArrayLengthField and
+// kUnionLengthField.
+constexpr std::uint8_t kVarintLengthField = 0xffu;
+
 struct serialize_props_default {
   using LengthFieldType = std::uint8_t;
   using AlignmentType = alignment;
@@ -49,6 +67,17 @@ struct serialize_props_default {
   static constexpr LengthFieldType kArrayLengthField = 4u;
   static constexpr LengthFieldType kUnionLengthField = 4u;
   static constexpr LengthFieldType kStructLengthField = 0u;
+  static constexpr struct_layout kStructLayout = struct_layout::kSequential;
+  static constexpr ser_config kTypeInfo = DEFAULT;
+  // true pads every scalar, length field and trivially copyable block to an
+  // offset (from the start of the payload) aligned to min(alignof, kAlignment),
+  // and structs to their own alignment on both ends, so a trivially
+  // serializable struct is encoded with its in-memory layout.
+  static constexpr bool kAlignedLayout = false;
+  // true writes the elements of unordered maps and sets in key order, as
+  // ordered ones always are. The encoding is then the same whichever kind of
+  // map it came from, and ordered maps decode from it in linear time.
+  static constexpr bool kSortedKeys = false;
 };
 
 }  // namespace serialize
@@ -16,10 +16,15 @@
 #include <type_traits>
 
 #include "append_types/expected.hpp"
+#include "detail/batch.hpp"
 #include "detail/calculate_size.hpp"
 #include "detail/deserializer.hpp"
+#include "detail/fd_reader.hpp"
+#include "detail/flat_view.hpp"
+#include "detail/iovec_writer.hpp"
 #include "detail/memory_reader.hpp"
 #include "detail/memory_writer.hpp"
+#include "detail/mmap_reader.hpp"
 #include "detail/reflection.hpp"
 #include "detail/return_code.hpp"
 #include "detail/serializer.hpp"
@@ -68,6 +73,67 @@ void serialize_to(Writer &, const Args &...) {
                 "serialize_buffer requirement!");
 }
 
+// layout fingerprint of the arguments, the value written in front of the
+// payload by configs with ENABLE_TYPE_INFO.
+template <typename... Args>
+constexpr std::uint64_t get_type_fingerprint() {
+  static_assert(sizeof...(Args) > 0, "");
+  return detail::get_type_fingerprint<Args...>();
+}
+
+template <typename... Args>
+constexpr std::uint32_t get_type_fingerprint32() {
+  constexpr auto fingerprint = get_type_fingerprint<Args...>();
+  return static_cast<std::uint32_t>(fingerprint ^ (fingerprint >> 32));
+}
+
+template <typename conf = serialize_props_default, typename... Args>
+std::size_t get_needed_size(const Args &...args) {
+  static_assert(sizeof...(args) > 0, "");
+  return detail::get_serialize_runtime_info<conf>(args...);
+}
+
+// serialize into a caller owned buffer of `capacity` bytes, such as the
+// user-payload of a loaned chunk. Nothing is written if the encoding does not
+// fit, the caller can then retry with get_needed_size() bytes.
+template <typename conf = serialize_props_default, typename... Args>
+expected<std::size_t, return_code> serialize_to_buffer(char *data,
+                                                       std::size_t capacity,
+                                                       const Args &...args) {
+  static_assert(sizeof...(args) > 0, "");
+  auto info = detail::get_serialize_runtime_info<conf>(args...);
+  if SER_UNLIKELY (info > capacity) {
+    return unexpected<return_code>{return_code::no_buffer_space};
+  }
+  detail::bounded_writer writer{data, data + capacity};
+  detail::serialize_to<conf>(writer, info, args...);
+  if SER_UNLIKELY (writer.overflow) {
+    return unexpected<return_code>{return_code::no_buffer_space};
+  }
+  return info;
+}
+
+// serialize into memory handed out by `loan`, which is called once with the
+// exact encoded size and returns a pointer to at least that many writable
+// bytes, or nullptr when no such memory is available.
+template <typename conf = serialize_props_default, typename Loan,
+          typename... Args>
+expected<std::size_t, return_code> serialize_to_loan(Loan &&loan,
+                                                     const Args &...args) {
+  static_assert(sizeof...(args) > 0, "");
+  auto info = detail::get_serialize_runtime_info<conf>(args...);
+  char *data = (char *)loan(info);
+  if SER_UNLIKELY (data == nullptr) {
+    return unexpected<return_code>{return_code::no_buffer_space};
+  }
+  detail::bounded_writer writer{data, data + info};
+  detail::serialize_to<conf>(writer, info, args...);
+  if SER_UNLIKELY (writer.overflow) {
+    return unexpected<return_code>{return_code::no_buffer_space};
+  }
+  return info;
+}
+
 template <typename conf = serialize_props_default,
           typename Buffer = std::vector<char>, typename... Args>
 Buffer serialize(const Args &...args) {
@@ -115,25 +181,42 @@ template <typename conf = serialize_props_default, typename T, typename... Args,
           typename = std::enable_if_t<detail::reader_t<Reader>>>
 serialize::return_code deserialize_to(T &t, Reader &reader, Args &...args) {
   detail::Deserializer<Reader, conf> in(reader);
-  std::size_t consume_len;
   auto old_pos = reader.tellg();
-  auto ret = in.deserialize_with_len(consume_len, t, args...);
-  std::size_t delta = reader.tellg() - old_pos;
-  if SER_LIKELY (ret == return_code{}) {
-    if SER_LIKELY (consume_len > 0) {
-      if SER_UNLIKELY (delta > consume_len) {
-        ret = serialize::return_code::invalid_buffer;
-        seek_reader_helper<Reader>(reader, old_pos, ret);
-      } else {
-        reader.ignore(consume_len - delta);
-      }
-    }
-  } else {
+  auto ret = in.deserialize(t, args...);
+  if SER_UNLIKELY (ret != return_code::ok) {
     seek_reader_helper<Reader>(reader, old_pos, ret);
   }
   return ret;
 }
 
+// decode the next message of a stream, e.g. a detail::fd_reader or
+// detail::mmap_reader. The message is consumed once it decoded; while it is
+// cut short the stream fetches more, and when nothing more is available yet
+// need_more_data is returned with the stream left where it was, so the call
+// is simply repeated later. no_buffer_space means the stream ended inside a
+// message.
+template <typename conf = serialize_props_default, typename T,
+          typename Stream,
+          std::enable_if_t<detail::stream_reader_t<Stream>, int> = 0>
+serialize::return_code deserialize_next(T &t, Stream &stream) {
+  for (;;) {
+    detail::memory_reader reader{stream.data(), stream.data() + stream.size()};
+    detail::Deserializer<detail::memory_reader, conf> in(reader);
+    auto errc = in.deserialize(t);
+    if SER_LIKELY (errc == return_code::ok) {
+      stream.consume(static_cast<std::size_t>(reader.now - stream.data()));
+      return errc;
+    }
+    if (errc != return_code::no_buffer_space) {
+      return errc;
+    }
+    errc = stream.fetch();
+    if (errc != return_code::ok) {
+      return errc;
+    }
+  }
+}
+
 template <typename conf, typename... Args, typename View,
           std::enable_if_t<
               detail::deserialize_view<View> && detail::props_t<conf>, int> = 0>
@@ -209,4 +292,122 @@ auto deserialize(Reader &v) {
   return ret;
 }
 
+// pointer to the T encoded in a received buffer (a std::vector<char>, a shared
+// memory chunk payload...) without copying it out. Only for types which are
+// encoded with their memory layout under conf, see detail::flat_layout. Size,
+// fingerprint, alignment and member offsets are checked once; the pointer
+// lives as long as the buffer.
+template <typename conf, typename T,
+          std::enable_if_t<detail::props_t<conf>, int> = 0>
+expected<const T *, return_code> view(const char *data, size_t size) {
+  const T *ptr = nullptr;
+  auto errc = detail::view_flat<conf>(data, size, ptr);
+  if SER_UNLIKELY (errc != serialize::return_code::ok) {
+    return unexpected<serialize::return_code>{errc};
+  }
+  return ptr;
+}
+
+template <typename T, std::enable_if_t<!detail::props_t<T>, int> = 0>
+expected<const T *, return_code> view(const char *data, size_t size) {
+  return view<serialize_props_default, T>(data, size);
+}
+
+template <typename conf, typename T, typename View,
+          std::enable_if_t<
+              detail::deserialize_view<View> && detail::props_t<conf>, int> = 0>
+expected<const T *, return_code> view(const View &v) {
+  return view<conf, T>((const char *)v.data(), v.size());
+}
+
+template <typename T, typename View,
+          std::enable_if_t<
+              detail::deserialize_view<View> && !detail::props_t<T>, int> = 0>
+expected<const T *, return_code> view(const View &v) {
+  return view<serialize_props_default, T>((const char *)v.data(), v.size());
+}
+
+// many values of one type in one buffer: the type info header and the size
+// plan of fixed size types are handled once per batch, and an offset index
+// lets deserialize_batch_at decode any element without parsing the others.
+template <typename conf = serialize_props_default, typename Buffer,
+          typename Container,
+          std::enable_if_t<detail::serialize_buffer<Buffer>, int> = 0>
+void serialize_batch_to(Buffer &buffer, const Container &items) {
+  detail::serialize_batch_to<conf>(buffer, items);
+}
+
+template <typename conf = serialize_props_default,
+          typename Buffer = std::vector<char>, typename Container>
+Buffer serialize_batch(const Container &items) {
+  static_assert(detail::serialize_buffer<Buffer>,
+                "The buffer is not satisfied serialize_buffer requirement!");
+  Buffer buffer;
+  detail::serialize_batch_to<conf>(buffer, items);
+  return buffer;
+}
+
+template <typename conf, typename T,
+          std::enable_if_t<detail::props_t<conf>, int> = 0>
+expected<std::size_t, return_code> get_batch_count(const char *data,
+                                                   size_t size) {
+  detail::batch_layout batch;
+  auto errc = detail::parse_batch<conf, T>(data, size, batch);
+  if SER_UNLIKELY (errc != serialize::return_code::ok) {
+    return unexpected<serialize::return_code>{errc};
+  }
+  return static_cast<std::size_t>(batch.count);
+}
+
+template <typename T, std::enable_if_t<!detail::props_t<T>, int> = 0>
+expected<std::size_t, return_code> get_batch_count(const char *data,
+                                                   size_t size) {
+  return get_batch_count<serialize_props_default, T>(data, size);
+}
+
+// `items` is resized to the batch, so its elements are decoded over
+template <typename conf = serialize_props_default, typename T>
+serialize::return_code deserialize_batch_to(std::vector<T> &items,
+                                            const char *data, size_t size) {
+  detail::batch_layout batch;
+  auto errc = detail::parse_batch<conf, T>(data, size, batch);
+  if SER_UNLIKELY (errc != serialize::return_code::ok) {
+    return errc;
+  }
+  items.resize(batch.count);
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    errc = detail::deserialize_batch_element<conf>(batch, i, items[i]);
+    if SER_UNLIKELY (errc != serialize::return_code::ok) {
+      return errc;
+    }
+  }
+  return serialize::return_code::ok;
+}
+
+template <typename conf = serialize_props_default, typename T, typename View,
+          typename = std::enable_if_t<detail::deserialize_view<View>>>
+serialize::return_code deserialize_batch_to(std::vector<T> &items,
+                                            const View &v) {
+  return deserialize_batch_to<conf>(items, (const char *)v.data(), v.size());
+}
+
+template <typename conf = serialize_props_default, typename T>
+serialize::return_code deserialize_batch_at(T &item, const char *data,
+                                            size_t size, std::size_t index) {
+  detail::batch_layout batch;
+  auto errc = detail::parse_batch<conf, T>(data, size, batch);
+  if SER_UNLIKELY (errc != serialize::return_code::ok) {
+    return errc;
+  }
+  return detail::deserialize_batch_element<conf>(batch, index, item);
+}
+
+template <typename conf = serialize_props_default, typename T, typename View,
+          typename = std::enable_if_t<detail::deserialize_view<View>>>
+serialize::return_code deserialize_batch_at(T &item, const View &v,
+                                            std::size_t index) {
+  return deserialize_batch_at<conf>(item, (const char *)v.data(), v.size(),
+                                    index);
+}
+
 }  // namespace serialize
\ No newline at end of file
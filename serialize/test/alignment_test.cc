@@ -13,44 +13,46 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <string>
+#include <cstring>
+#include <tuple>
 
 #include "detail/reflection.hpp"
 #include "serialize.hpp"
 #include "user_defined_struct.h"
 
-namespace {
-// constexpr std::size_t kAlignment1 = 1u;
-constexpr std::size_t kAlignment2 = 2u;
-constexpr std::size_t kAlignment4 = 4u;
-constexpr std::size_t kAlignment8 = 8u;
-}  // namespace
-
 TEST(SerializerTest, AlignmentTest) {
   using namespace serialize::detail;
 
-  //   members_count<std::string>();
-  //   members_count<AA>();
-
-  auto res12 = calculate_padding_size<AA>(kAlignment8);
-  for (auto res : res12) {
-    std::cout << res << " ";
-  }
-  std::cout << "size: " << res12.size() << "\n";
-
-  auto res2 = calculate_padding_size<A>(kAlignment2);
-  for (auto res : res2) {
-    std::cout << res << " ";
-  }
-  std::cout << "\n";
-  auto res4 = calculate_padding_size<A>(kAlignment4);
-  for (auto res : res4) {
-    std::cout << res << " ";
-  }
-  std::cout << "\n";
-  auto res8 = calculate_padding_size<A>(kAlignment8);
-  for (auto res : res8) {
-    std::cout << res << " ";
-  }
-  std::cout << "\n";
-}
\ No newline at end of file
+  // padding to min(align, kAlignment), counted from the payload start
+  EXPECT_EQ(aligned_padding_size<serialize_props_aligned>(0, 8), 0u);
+  EXPECT_EQ(aligned_padding_size<serialize_props_aligned>(1, 2), 1u);
+  EXPECT_EQ(aligned_padding_size<serialize_props_aligned>(3, 4), 1u);
+  EXPECT_EQ(aligned_padding_size<serialize_props_aligned>(4, 8), 4u);
+  EXPECT_EQ(aligned_padding_size<serialize_props_aligned>(5, 16), 3u);
+  EXPECT_EQ(aligned_padding_size<serialize_props_aligned>(7, 1), 0u);
+
+  // a trivially serializable struct is encoded with its memory layout,
+  // padding included
+  A a;
+  std::memset(&a, 0, sizeof(a));
+  a.a = 1;
+  a.b = 2;
+  a.c = 3;
+  a.bb.a = 4;
+  a.bb.b = 5;
+  a.d = 6;
+  auto buffer = serialize::serialize<serialize_props_aligned>(a);
+  ASSERT_EQ(buffer.size(), sizeof(A));
+  EXPECT_EQ(std::memcmp(buffer.data(), &a, sizeof(A)), 0);
+
+  // a lead byte moves the struct to its alignment
+  auto led = serialize::serialize<serialize_props_aligned>(std::uint8_t{9}, a);
+  ASSERT_EQ(led.size(), alignof(A) + sizeof(A));
+  EXPECT_EQ(std::memcmp(led.data() + alignof(A), &a, sizeof(A)), 0);
+  auto res = serialize::deserialize<serialize_props_aligned, std::uint8_t, A>(
+      led);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(std::get<0>(res.value()), 9u);
+  EXPECT_EQ(std::get<1>(res.value()).d, a.d);
+  EXPECT_EQ(std::get<1>(res.value()).bb.b, a.bb.b);
+}
@@ -11,6 +11,7 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <bitset>
 #include <cstdint>
 #include <deque>
@@ -20,6 +21,7 @@
 
 #include "detail/reflection.hpp"
 #include "ser_config.hpp"
+#include "serialize.hpp"
 #include "user_defined_struct.h"
 
 TEST(SerializerTest, CalculateSizeTest) {
@@ -199,3 +201,36 @@ TEST(SerializerTest, CalculateSizeTest) {
   int* int_ptr = &int_a;
   EXPECT_EQ(detail::calculate_payload_size<serialize_props>(int_ptr).total, 4);
 }
+
+TEST(SerializerTest, SizePlanTest) {
+  using namespace serialize;
+  constexpr auto int_plan = detail::get_size_plan<serialize_props, int>();
+  static_assert(int_plan.fixed && int_plan.size.total == sizeof(int), "");
+
+  constexpr auto p1_plan = detail::get_size_plan<serialize_props, person1>();
+  static_assert(p1_plan.fixed, "");
+  EXPECT_EQ(p1_plan.size.total, 16);
+  EXPECT_EQ(p1_plan.size.length_field, 8);
+  person1 p1{1, 1.2, 2};
+  EXPECT_EQ(detail::get_serialize_runtime_info<serialize_props>(p1),
+            p1_plan.size.total + p1_plan.size.length_field);
+
+  using arr_p1 = std::array<person1, 3>;
+  constexpr auto arr_plan = detail::get_size_plan<serialize_props, arr_p1>();
+  static_assert(arr_plan.fixed, "");
+  arr_p1 a_p1{p1, p1, p1};
+  EXPECT_EQ(detail::get_serialize_runtime_info<serialize_props>(a_p1),
+            serialize::serialize<serialize_props>(a_p1).size());
+
+  constexpr auto tuple_plan =
+      detail::get_size_plan_many<serialize_props, int, std::pair<int, double>,
+                                 std::bitset<64>>();
+  static_assert(tuple_plan.fixed, "");
+  EXPECT_EQ(tuple_plan.size.total, 4 + 12 + sizeof(std::bitset<64>));
+
+  EXPECT_FALSE((detail::fixed_size_v<serialize_props, person2>));
+  EXPECT_FALSE((detail::fixed_size_v<serialize_props, person3>));
+  EXPECT_FALSE((detail::fixed_size_v<serialize_props, std::string>));
+  EXPECT_FALSE(
+      (detail::fixed_size_v<serialize_props, mpark::variant<int, double>>));
+}
@@ -7,17 +7,23 @@
  * @LastEditTime: 2024-01-12 13:21:02
  */
 
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <list>
 #include <map>
 #include <set>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -229,4 +235,576 @@ TEST(SerializerTest, DeserializeTest) {
   } else {
     std::cout << "error" << std::endl;
   }
-}
\ No newline at end of file
+}
+TEST(SerializerTest, DeserializeViewTest) {
+  sample_msg msg{7, {1, 2, 3, 4}, "hello view"};
+  auto buffer = serialize::serialize<serialize_props>(msg);
+
+  auto res = serialize::deserialize<serialize_props, sample_msg_view>(buffer);
+  ASSERT_TRUE(res.has_value());
+  auto& view = res.value();
+  EXPECT_EQ(view.id, msg.id);
+  ASSERT_EQ(view.values.size(), msg.values.size());
+  EXPECT_TRUE(std::equal(msg.values.begin(), msg.values.end(),
+                         view.values.begin()));
+  EXPECT_EQ(view.name, serialize::string_view(msg.name));
+  // both views point into the source buffer
+  EXPECT_GE((const char*)view.values.data(), buffer.data());
+  EXPECT_LT((const char*)view.values.data(), buffer.data() + buffer.size());
+  EXPECT_GE(view.name.data(), buffer.data());
+  EXPECT_LT(view.name.data(), buffer.data() + buffer.size());
+
+  // views encode to the same bytes as the owning types
+  EXPECT_EQ(serialize::serialize<serialize_props>(view), buffer);
+
+  // the span payload is shifted off its alignment by a leading byte
+  std::vector<int> ints{1, 2, 3};
+  auto shifted = serialize::serialize(std::uint8_t{1}, ints);
+  std::uint8_t lead{};
+  serialize::span<const int> span;
+  auto code = serialize::deserialize_to(lead, shifted, span);
+  EXPECT_EQ(code, serialize::return_code::unaligned_view);
+
+  auto str = serialize::serialize(std::string{"abc"});
+  auto res_str = serialize::deserialize<serialize::string_view>(str);
+  ASSERT_TRUE(res_str.has_value());
+  EXPECT_EQ(res_str.value().to_string(), "abc");
+}
+
+TEST(SerializerTest, TaggedStructCompatibilityTest) {
+  record_v1 v1{7, "seven"};
+  record_v2 v2{9, "nine", {1, 2, 3}, {1, 1.5, 2}};
+
+  auto same = serialize::deserialize<serialize_props_tagged, record_v2>(
+      serialize::serialize<serialize_props_tagged>(v2));
+  ASSERT_TRUE(same.has_value());
+  EXPECT_EQ(same.value().scores, v2.scores);
+  EXPECT_EQ(same.value().owner, v2.owner);
+
+  // old consumer skips the members it does not know
+  auto old_reader = serialize::deserialize<serialize_props_tagged, record_v1>(
+      serialize::serialize<serialize_props_tagged>(v2));
+  ASSERT_TRUE(old_reader.has_value());
+  EXPECT_EQ(old_reader.value().id, v2.id);
+  EXPECT_EQ(old_reader.value().name, v2.name);
+
+  // new consumer keeps defaults for members the old producer did not send
+  auto new_reader = serialize::deserialize<serialize_props_tagged, record_v2>(
+      serialize::serialize<serialize_props_tagged>(v1));
+  ASSERT_TRUE(new_reader.has_value());
+  EXPECT_EQ(new_reader.value().id, v1.id);
+  EXPECT_EQ(new_reader.value().name, v1.name);
+  EXPECT_TRUE(new_reader.value().scores.empty());
+
+  // a reused target doesn't keep them from the previous message either
+  record_v2 reused = v2;
+  EXPECT_EQ(serialize::deserialize_to<serialize_props_tagged>(
+                reused, serialize::serialize<serialize_props_tagged>(v1)),
+            serialize::return_code::ok);
+  EXPECT_EQ(reused.id, v1.id);
+  EXPECT_TRUE(reused.scores.empty());
+  EXPECT_EQ(reused.owner, person1{});
+
+  // sequential structs with a length field skip appended members too
+  auto buffer = serialize::serialize<serialize_props>(v2, std::uint8_t{42});
+  record_v1 seq{};
+  std::uint8_t trailer = 0;
+  auto code = serialize::deserialize_to<serialize_props>(seq, buffer, trailer);
+  EXPECT_EQ(code, serialize::return_code::ok);
+  EXPECT_EQ(seq.name, v2.name);
+  EXPECT_EQ(trailer, 42);
+
+  // member errors are reported instead of dropped
+  auto tagged = serialize::serialize<serialize_props_tagged>(v2);
+  tagged.resize(tagged.size() - 1);
+  auto cut = serialize::deserialize<serialize_props_tagged, record_v2>(tagged);
+  ASSERT_FALSE(cut.has_value());
+  EXPECT_EQ(cut.error(), serialize::return_code::no_buffer_space);
+
+  auto plain = serialize::serialize(person2{1, 1.2, {1, 2}});
+  plain.resize(plain.size() - 1);
+  auto cut_plain = serialize::deserialize<person2>(plain);
+  ASSERT_FALSE(cut_plain.has_value());
+  EXPECT_EQ(cut_plain.error(), serialize::return_code::no_buffer_space);
+}
+
+TEST(SerializerTest, TypeFingerprintTest) {
+  // computed at compile time
+  static_assert(serialize::get_type_fingerprint<person1>() !=
+                    serialize::get_type_fingerprint<person2>(),
+                "");
+  static_assert(serialize::get_type_fingerprint<std::string>() ==
+                    serialize::get_type_fingerprint<serialize::string_view>(),
+                "");
+  using int_span = serialize::span<const int>;
+  static_assert(serialize::get_type_fingerprint<std::vector<int>>() ==
+                    serialize::get_type_fingerprint<int_span>(),
+                "");
+  EXPECT_EQ(serialize::get_type_fingerprint<sample_msg>(),
+            serialize::get_type_fingerprint<sample_msg_view>());
+  EXPECT_NE((serialize::get_type_fingerprint<std::array<int, 2>>()),
+            (serialize::get_type_fingerprint<std::array<int, 3>>()));
+  EXPECT_NE(serialize::get_type_fingerprint<record_v1>(),
+            serialize::get_type_fingerprint<record_v2>());
+  EXPECT_NE((serialize::get_type_fingerprint<int, double>()),
+            (serialize::get_type_fingerprint<double, int>()));
+  EXPECT_NE(serialize::get_type_fingerprint32<person1>(),
+            serialize::get_type_fingerprint32<person2>());
+
+  person1 p1{1, 1.2, 2};
+  auto buffer = serialize::serialize<serialize_props_type_info>(p1);
+  EXPECT_EQ(buffer.size(), serialize::serialize(p1).size() + 8);
+  EXPECT_EQ(buffer.size(),
+            serialize::get_needed_size<serialize_props_type_info>(p1));
+
+  auto same =
+      serialize::deserialize<serialize_props_type_info, person1>(buffer);
+  ASSERT_TRUE(same.has_value());
+  EXPECT_EQ(same.value(), p1);
+
+  // same byte count, different layout: rejected before decoding
+  auto other =
+      serialize::deserialize<serialize_props_type_info, example::Test>(buffer);
+  ASSERT_FALSE(other.has_value());
+  EXPECT_EQ(other.error(), serialize::return_code::type_mismatch);
+}
+
+TEST(SerializerTest, AlignedLayoutRoundTripTest) {
+  person3 p3{{2, 2.2, 2}, {1, 1.2, {1, 2, 3}}};
+  auto buffer = serialize::serialize<serialize_props_aligned_framed>(p3);
+  auto des =
+      serialize::deserialize<serialize_props_aligned_framed, person3>(buffer);
+  ASSERT_TRUE(des.has_value());
+  EXPECT_EQ(des.value(), p3);
+
+  using tuple_t = std::tuple<std::uint8_t, person2, std::bitset<12>,
+                             mpark::variant<std::uint8_t, double>,
+                             std::array<std::uint16_t, 3>>;
+  tuple_t t{7, {1, 1.5, {4, 5}}, std::bitset<12>{0x5a5}, 2.5, {{1, 2, 3}}};
+  auto tb = serialize::serialize<serialize_props_aligned>(t);
+  auto tdes = serialize::deserialize<serialize_props_aligned, tuple_t>(tb);
+  ASSERT_TRUE(tdes.has_value());
+  EXPECT_EQ(tdes.value(), t);
+
+  // element blocks are aligned, so views never hit unaligned_view
+  sample_msg msg{0x42, {1, 2, 3}, "name"};
+  auto mb = serialize::serialize<serialize_props_aligned>(std::uint8_t{1}, msg);
+  std::uint8_t lead = 0;
+  sample_msg_view view{};
+  serialize::detail::memory_reader reader{mb.data(), mb.data() + mb.size()};
+  serialize::detail::Deserializer<serialize::detail::memory_reader,
+                                  serialize_props_aligned>
+      deserializer(reader);
+  ASSERT_EQ(deserializer.deserialize(lead, view), serialize::return_code::ok);
+  EXPECT_EQ(view.id, msg.id);
+  EXPECT_TRUE(std::equal(view.values.begin(), view.values.end(),
+                         msg.values.begin(), msg.values.end()));
+  EXPECT_EQ(view.name, serialize::string_view{msg.name});
+
+  // padding counts towards the buffer
+  buffer.pop_back();
+  auto truncated =
+      serialize::deserialize<serialize_props_aligned_framed, person3>(buffer);
+  ASSERT_FALSE(truncated.has_value());
+  EXPECT_EQ(truncated.error(), serialize::return_code::no_buffer_space);
+}
+
+TEST(SerializerTest, FlatViewTest) {
+  using namespace serialize::detail;
+  static_assert(flat_layout<serialize::serialize_props_default, sensor_frame>,
+                "");
+  static_assert(!flat_layout<serialize::serialize_props_default, person1>, "");
+  static_assert(flat_layout<serialize_props_aligned, person1>, "");
+  static_assert(!flat_layout<serialize_props, sensor_frame>, "");
+  static_assert(!flat_layout<serialize_props_aligned, person2>, "");
+
+  sensor_frame frame{123456789, {{1.0, 2.0, 3.0}}, 42, 7, 1, 99};
+  auto buffer = serialize::serialize(frame);
+  ASSERT_EQ(buffer.size(), sizeof(sensor_frame));
+  auto res = serialize::view<sensor_frame>(buffer);
+  ASSERT_TRUE(res.has_value());
+  const sensor_frame *ptr = res.value();
+  EXPECT_EQ((const char *)ptr, buffer.data());
+  EXPECT_EQ(ptr->timestamp, frame.timestamp);
+  EXPECT_EQ(ptr->value, frame.value);
+  EXPECT_EQ(ptr->id, frame.id);
+  EXPECT_EQ(ptr->quality, frame.quality);
+
+  // a chunk payload, with the fingerprint checked in front of it
+  alignas(8) std::array<char, 64> chunk{};
+  person1 p1{1, 1.2, 2};
+  auto written = serialize::serialize_to_buffer<serialize_props_aligned_typed>(
+      chunk.data(), chunk.size(), p1);
+  ASSERT_TRUE(written.has_value());
+  auto p1_view = serialize::view<serialize_props_aligned_typed, person1>(
+      chunk.data(), written.value());
+  ASSERT_TRUE(p1_view.has_value());
+  EXPECT_EQ(*p1_view.value(), p1);
+
+  auto mismatch = serialize::view<serialize_props_aligned_typed, A>(
+      chunk.data(), chunk.size());
+  ASSERT_FALSE(mismatch.has_value());
+  EXPECT_EQ(mismatch.error(), serialize::return_code::type_mismatch);
+
+  auto short_read = serialize::view<serialize_props_aligned_typed, person1>(
+      chunk.data(), written.value() - 1);
+  ASSERT_FALSE(short_read.has_value());
+  EXPECT_EQ(short_read.error(), serialize::return_code::no_buffer_space);
+
+  std::vector<char> shifted(buffer.size() + 1);
+  std::copy(buffer.begin(), buffer.end(), shifted.begin() + 1);
+  auto unaligned =
+      serialize::view<sensor_frame>(shifted.data() + 1, buffer.size());
+  ASSERT_FALSE(unaligned.has_value());
+  EXPECT_EQ(unaligned.error(), serialize::return_code::unaligned_view);
+
+  // the reflection has to cover T in declaration order
+  static_assert(!flat_layout<serialize_props_aligned, gap_frame>, "");
+  static_assert(!flat_layout<serialize::serialize_props_default, gap_frame>,
+                "");
+  swapped_pair pair{1, 2};
+  auto pair_buffer = serialize::serialize(pair);
+  ASSERT_EQ(pair_buffer.size(), sizeof(swapped_pair));
+  auto swapped = serialize::view<swapped_pair>(pair_buffer);
+  ASSERT_FALSE(swapped.has_value());
+  EXPECT_EQ(swapped.error(), serialize::return_code::type_mismatch);
+  auto swapped_aligned = serialize::view<serialize_props_aligned, swapped_pair>(
+      pair_buffer.data(), pair_buffer.size());
+  ASSERT_FALSE(swapped_aligned.has_value());
+  EXPECT_EQ(swapped_aligned.error(), serialize::return_code::type_mismatch);
+}
+
+TEST(SerializerTest, ReuseTargetTest) {
+  using message_t =
+      std::tuple<std::vector<int>, std::string, std::unordered_map<int, int>,
+                 std::set<int>, std::vector<std::string>,
+                 mpark::variant<int, std::string>, std::unique_ptr<person1>>;
+  auto make = [](std::size_t n, char c, int base) {
+    message_t m;
+    std::get<0>(m).assign(n, base);
+    std::get<1>(m).assign(n, c);
+    for (int i = 0; i < static_cast<int>(n % 5 + 1); ++i) {
+      std::get<2>(m).emplace(base + i, i);
+      std::get<3>(m).insert(base + i);
+    }
+    std::get<4>(m).assign(n % 3 + 1, std::string(n, c + 1));
+    std::get<5>(m) = std::string(n, c + 2);
+    std::get<6>(m) = std::make_unique<person1>(person1{base, 1.5, base + 1});
+    return m;
+  };
+  message_t large = make(64, 'a', 7);
+  message_t small = make(2, 'x', 9);
+  auto large_buffer = serialize::serialize(large);
+  auto small_buffer = serialize::serialize(small);
+
+  message_t target;
+  ASSERT_EQ(serialize::deserialize_to(target, large_buffer),
+            serialize::return_code::ok);
+  const int *values = std::get<0>(target).data();
+  const char *name = std::get<1>(target).data();
+  const char *nested = std::get<4>(target)[0].data();
+  const char *alt = mpark::get<1>(std::get<5>(target)).data();
+  const person1 *ptr = std::get<6>(target).get();
+
+  // a smaller message replaces the content, the allocations stay
+  ASSERT_EQ(serialize::deserialize_to(target, small_buffer),
+            serialize::return_code::ok);
+  EXPECT_EQ(std::get<0>(target), std::get<0>(small));
+  EXPECT_EQ(std::get<1>(target), std::get<1>(small));
+  EXPECT_EQ(std::get<2>(target), std::get<2>(small));
+  EXPECT_EQ(std::get<3>(target), std::get<3>(small));
+  EXPECT_EQ(std::get<4>(target), std::get<4>(small));
+  EXPECT_EQ(std::get<5>(target), std::get<5>(small));
+  EXPECT_EQ(*std::get<6>(target), *std::get<6>(small));
+  EXPECT_EQ(std::get<0>(target).data(), values);
+  EXPECT_EQ(std::get<1>(target).data(), name);
+  EXPECT_EQ(std::get<4>(target)[0].data(), nested);
+  EXPECT_EQ(mpark::get<1>(std::get<5>(target)).data(), alt);
+  EXPECT_EQ(std::get<6>(target).get(), ptr);
+}
+
+TEST(SerializerTest, BatchTest) {
+  // fixed size: one stride instead of an index
+  std::vector<person1> fixed;
+  for (int i = 0; i < 100; ++i) {
+    fixed.push_back(person1{i, i * 0.5, -i});
+  }
+  auto fixed_buffer = serialize::serialize_batch(fixed);
+  EXPECT_EQ(fixed_buffer.size(), 16u + 8 + 100 * 16);
+  std::vector<person1> fixed_out;
+  ASSERT_EQ(serialize::deserialize_batch_to(fixed_out, fixed_buffer),
+            serialize::return_code::ok);
+  EXPECT_EQ(fixed_out, fixed);
+
+  // variable size, with one fingerprint for the whole batch
+  std::vector<person2> records;
+  for (int i = 0; i < 50; ++i) {
+    records.push_back(person2{
+        i, i * 1.5, std::vector<int>(static_cast<std::size_t>(i % 7 + 1), i)});
+  }
+  auto buffer = serialize::serialize_batch<serialize_props_type_info>(records);
+  auto count = serialize::get_batch_count<serialize_props_type_info, person2>(
+      buffer.data(), buffer.size());
+  ASSERT_TRUE(count.has_value());
+  EXPECT_EQ(count.value(), records.size());
+
+  for (std::size_t i : {std::size_t{0}, std::size_t{17}, std::size_t{49}}) {
+    person2 one{};
+    ASSERT_EQ(serialize::deserialize_batch_at<serialize_props_type_info>(
+                  one, buffer, i),
+              serialize::return_code::ok);
+    EXPECT_EQ(one, records[i]);
+  }
+  person2 past{};
+  EXPECT_EQ(serialize::deserialize_batch_at<serialize_props_type_info>(
+                past, buffer, records.size()),
+            serialize::return_code::out_of_range);
+  person1 other{};
+  EXPECT_EQ(serialize::deserialize_batch_at<serialize_props_type_info>(
+                other, buffer, 0),
+            serialize::return_code::type_mismatch);
+
+  // every element is encoded as if it was serialized alone
+  std::vector<person2> out;
+  ASSERT_EQ(
+      serialize::deserialize_batch_to<serialize_props_type_info>(out, buffer),
+      serialize::return_code::ok);
+  EXPECT_EQ(out, records);
+
+  // appended to a buffer which already holds data, aligned layout
+  std::vector<char> log(3, 'x');
+  serialize::serialize_batch_to<serialize_props_aligned>(log, records);
+  std::vector<person2> aligned_out;
+  ASSERT_EQ(serialize::deserialize_batch_to<serialize_props_aligned>(
+                aligned_out, log.data() + 3, log.size() - 3),
+            serialize::return_code::ok);
+  EXPECT_EQ(aligned_out, records);
+
+  buffer.resize(buffer.size() - 1);
+  EXPECT_NE(
+      serialize::deserialize_batch_to<serialize_props_type_info>(out, buffer),
+      serialize::return_code::ok);
+
+  // without an index only the stride bounds the count, a crafted one has to
+  // be rejected before the target is resized
+  auto crafted = fixed_buffer;
+  const std::uint64_t huge_count = UINT64_MAX / 2;
+  std::memcpy(&crafted[0], &huge_count, sizeof(huge_count));
+  for (std::uint64_t stride : {std::uint64_t{0}, std::uint64_t{1}}) {
+    std::memcpy(&crafted[16], &stride, sizeof(stride));
+    EXPECT_EQ(serialize::deserialize_batch_to(fixed_out, crafted),
+              serialize::return_code::invalid_buffer);
+  }
+  const std::uint64_t no_index = 0;
+  std::vector<char> variable(16 + 8 + 8);
+  std::memcpy(&variable[0], &huge_count, sizeof(huge_count));
+  std::memcpy(&variable[8], &no_index, sizeof(no_index));
+  std::memcpy(&variable[16], &huge_count, sizeof(huge_count));
+  EXPECT_EQ(serialize::deserialize_batch_to(out, variable),
+            serialize::return_code::invalid_buffer);
+}
+
+TEST(SerializerTest, HardenedDecodeTest) {
+  // a corrupted length field is rejected before the target is resized
+  using message_t = std::tuple<std::vector<person1>, std::string>;
+  message_t message{{{1, 2.0, 3}, {4, 5.0, 6}}, "name"};
+  auto buffer = serialize::serialize<serialize_props_type_info>(message);
+  buffer[serialize::detail::kTypeInfoSize + 3] = '\x7f';
+  message_t out;
+  EXPECT_EQ(
+      serialize::deserialize_to<serialize_props_type_info>(out, buffer),
+      serialize::return_code::no_buffer_space);
+  EXPECT_EQ(std::get<0>(out).capacity(), 0u);
+
+  std::vector<std::string> words(4, std::string(32, 'w'));
+  auto word_buffer = serialize::serialize<serialize_props_type_info>(words);
+  word_buffer[serialize::detail::kTypeInfoSize + 4 + 3] = '\x7f';
+  std::vector<std::string> words_out;
+  EXPECT_EQ(serialize::deserialize_to<serialize_props_type_info>(words_out,
+                                                                 word_buffer),
+            serialize::return_code::no_buffer_space);
+
+  // the config caps what a length field may announce
+  std::vector<int> within(8, 1);
+  auto within_buffer = serialize::serialize<serialize_props_limited>(within);
+  std::vector<int> within_out;
+  EXPECT_EQ(serialize::deserialize_to<serialize_props_limited>(within_out,
+                                                               within_buffer),
+            serialize::return_code::ok);
+  EXPECT_EQ(within_out, within);
+
+  std::vector<int> too_many(9, 1);
+  auto too_many_buffer =
+      serialize::serialize<serialize_props_limited>(too_many);
+  EXPECT_EQ(serialize::deserialize_to<serialize_props_limited>(
+                within_out, too_many_buffer),
+            serialize::return_code::length_error);
+
+  auto long_buffer =
+      serialize::serialize<serialize_props_limited>(std::string(17, 's'));
+  std::string long_out;
+  EXPECT_EQ(serialize::deserialize_to<serialize_props_limited>(long_out,
+                                                               long_buffer),
+            serialize::return_code::length_error);
+
+  // empty containers and the first variant alternative have a zero length
+  // field, which is valid
+  using empty_t = std::tuple<std::vector<int>, std::map<int, int>,
+                             mpark::variant<int, double>>;
+  empty_t empty{{}, {}, 5};
+  auto empty_buffer = serialize::serialize(empty);
+  empty_t empty_out{{1}, {{1, 1}}, 2.0};
+  ASSERT_EQ(serialize::deserialize_to(empty_out, empty_buffer),
+            serialize::return_code::ok);
+  EXPECT_EQ(empty_out, empty);
+}
+
+TEST(SerializerTest, OptionalRoundTripTest) {
+  using message_t =
+      std::tuple<tl::optional<person1>, tl::optional<std::string>,
+                 tl::expected<int, std::string>, tl::expected<int, std::string>>;
+  message_t message{person1{1, 2.0, 3}, tl::nullopt, 4,
+                    tl::make_unexpected(std::string("failed"))};
+  auto buffer = serialize::serialize(message);
+  EXPECT_EQ(buffer.size(), serialize::detail::get_serialize_runtime_info<
+                               serialize::serialize_props_default>(message));
+  message_t out{tl::nullopt, std::string("stale"), 0, 0};
+  ASSERT_EQ(serialize::deserialize_to(out, buffer),
+            serialize::return_code::ok);
+  EXPECT_EQ(out, message);
+}
+
+TEST(SerializerTest, SortedKeysTest) {
+  std::map<int, std::string> ordered;
+  std::unordered_map<int, std::string> unordered;
+  std::set<std::string> ordered_set;
+  std::unordered_set<std::string> unordered_set;
+  for (int i = 0; i < 200; ++i) {
+    int key = (i * 7919) % 1000;
+    ordered.emplace(key, std::to_string(i));
+    unordered.emplace(key, std::to_string(i));
+    ordered_set.insert(std::to_string(key));
+    unordered_set.insert(std::to_string(key));
+  }
+
+  // unordered containers encode like the ordered ones
+  auto from_ordered = serialize::serialize<serialize_props_sorted>(ordered);
+  auto from_unordered =
+      serialize::serialize<serialize_props_sorted>(unordered);
+  EXPECT_EQ(from_unordered, from_ordered);
+  EXPECT_EQ(serialize::serialize<serialize_props_sorted>(unordered_set),
+            serialize::serialize<serialize_props_sorted>(ordered_set));
+
+  std::map<int, std::string> ordered_out{{-1, "stale"}};
+  ASSERT_EQ(serialize::deserialize_to<serialize_props_sorted>(ordered_out,
+                                                              from_unordered),
+            serialize::return_code::ok);
+  EXPECT_EQ(ordered_out, ordered);
+  std::unordered_map<int, std::string> unordered_out;
+  ASSERT_EQ(serialize::deserialize_to<serialize_props_sorted>(unordered_out,
+                                                              from_ordered),
+            serialize::return_code::ok);
+  EXPECT_EQ(unordered_out, unordered);
+
+  // bucket order still decodes into an ordered map
+  std::map<int, std::string> from_buckets;
+  ASSERT_EQ(serialize::deserialize_to(from_buckets,
+                                      serialize::serialize(unordered)),
+            serialize::return_code::ok);
+  EXPECT_EQ(from_buckets, ordered);
+  std::set<std::string> set_out;
+  ASSERT_EQ(serialize::deserialize_to(set_out,
+                                      serialize::serialize(unordered_set)),
+            serialize::return_code::ok);
+  EXPECT_EQ(set_out, ordered_set);
+}
+
+TEST(SerializerTest, StreamReaderTest) {
+  using conf = serialize_props_type_info;
+  std::vector<person2> records;
+  for (int i = 0; i < 300; ++i) {
+    records.push_back(person2{
+        i, i * 0.5, std::vector<int>(static_cast<std::size_t>(i % 50), i)});
+  }
+  std::vector<char> stream;
+  for (const auto &record : records) {
+    serialize::serialize_to<conf>(stream, record);
+  }
+
+  // a file read through a window which has to grow and move
+  FILE *file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  int fd = fileno(file);
+  ASSERT_EQ(::write(fd, stream.data(), stream.size()),
+            static_cast<ssize_t>(stream.size()));
+  ASSERT_EQ(::lseek(fd, 0, SEEK_SET), 0);
+  serialize::detail::fd_reader from_fd{fd, 16};
+  person2 out{};
+  for (const auto &record : records) {
+    ASSERT_EQ(serialize::deserialize_next<conf>(out, from_fd),
+              serialize::return_code::ok);
+    EXPECT_EQ(out, record);
+  }
+  EXPECT_TRUE(from_fd.at_end());
+  EXPECT_EQ(serialize::deserialize_next<conf>(out, from_fd),
+            serialize::return_code::no_buffer_space);
+
+  // the same file mapped
+  serialize::detail::mmap_reader mapped{fd};
+  ASSERT_TRUE(mapped.valid());
+  for (const auto &record : records) {
+    ASSERT_EQ(serialize::deserialize_next<conf>(out, mapped),
+              serialize::return_code::ok);
+    EXPECT_EQ(out, record);
+  }
+  EXPECT_TRUE(mapped.at_end());
+
+  // a message cut short waits in the window for the rest of the recording
+  std::vector<char> one;
+  serialize::serialize_to<conf>(one, records[149]);
+  ASSERT_EQ(::write(fd, one.data(), 5), 5);
+  EXPECT_EQ(serialize::deserialize_next<conf>(out, mapped),
+            serialize::return_code::need_more_data);
+  EXPECT_EQ(serialize::deserialize_next<conf>(out, mapped),
+            serialize::return_code::need_more_data);
+  ASSERT_EQ(::write(fd, one.data() + 5, one.size() - 5),
+            static_cast<ssize_t>(one.size() - 5));
+  ASSERT_EQ(serialize::deserialize_next<conf>(out, mapped),
+            serialize::return_code::ok);
+  EXPECT_EQ(out, records[149]);
+  std::fclose(file);
+
+  // a non-blocking pipe
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  ASSERT_EQ(::fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+  serialize::detail::fd_reader from_pipe{fds[0]};
+  EXPECT_EQ(serialize::deserialize_next<conf>(out, from_pipe),
+            serialize::return_code::need_more_data);
+  ASSERT_EQ(::write(fds[1], one.data(), one.size() - 3),
+            static_cast<ssize_t>(one.size() - 3));
+  EXPECT_EQ(serialize::deserialize_next<conf>(out, from_pipe),
+            serialize::return_code::need_more_data);
+  ASSERT_EQ(::write(fds[1], one.data() + one.size() - 3, 3), 3);
+  ASSERT_EQ(serialize::deserialize_next<conf>(out, from_pipe),
+            serialize::return_code::ok);
+  EXPECT_EQ(out, records[149]);
+
+  // the window doesn't grow past the largest accepted message
+  serialize::detail::fd_reader limited{fds[0], 16, 32};
+  ASSERT_EQ(::write(fds[1], one.data(), one.size()),
+            static_cast<ssize_t>(one.size()));
+  EXPECT_EQ(serialize::deserialize_next<conf>(out, limited),
+            serialize::return_code::length_error);
+  ::close(fds[1]);
+  ::close(fds[0]);
+
+  // generic readers decode one message after the other
+  serialize::detail::memory_reader reader{stream.data(),
+                                          stream.data() + stream.size()};
+  for (std::size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(serialize::deserialize_to<conf>(out, reader),
+              serialize::return_code::ok);
+    EXPECT_EQ(out, records[i]);
+  }
+}
@@ -9,7 +9,10 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <cstdint>
+#include <cstring>
+#include <vector>
 
 #include "detail/endian_wrapper.hpp"
 #include "detail/memory_writer.hpp"
@@ -71,4 +74,74 @@ TEST(SerializerTest, EndianTest) {
     std::cout << "error " << __LINE__ << std::endl;
   }
   // EXPECT_EQ(buffer2, buffer3);
-};
\ No newline at end of file
+};
+TEST(SerializerTest, BulkByteSwapTest) {
+  using namespace serialize::detail;
+  std::uint32_t b = 0x12345678;
+  auto big = serialize::serialize<serialize_props_big>(b);
+  EXPECT_EQ(big, (std::vector<char>{0x12, 0x34, 0x56, 0x78}));
+  auto little = serialize::serialize<serialize_props_little>(b);
+  EXPECT_EQ(little, (std::vector<char>{0x78, 0x56, 0x34, 0x12}));
+
+  // only a wire order other than the host's is swapped
+  static_assert(bulk_swap_needed<!is_system_little_endian, std::uint32_t>, "");
+  static_assert(!bulk_swap_needed<is_system_little_endian, std::uint32_t>, "");
+  static_assert(!bulk_swap_needed<!is_system_little_endian, std::uint8_t>, "");
+
+  // odd element counts leave a tail for the scalar loop
+  std::vector<std::uint64_t> u64(37);
+  for (std::size_t i = 0; i < u64.size(); ++i) {
+    u64[i] = 0x0102030405060708ull * (i + 1);
+  }
+  std::vector<std::uint64_t> swapped(u64.size());
+  byte_swap_copy<8>((char *)swapped.data(), (const char *)u64.data(),
+                    u64.size());
+  for (std::size_t i = 0; i < u64.size(); ++i) {
+    EXPECT_EQ(swapped[i], bswap64(u64[i]));
+  }
+
+  auto buffer_u64 = serialize::serialize<serialize_props_big>(u64);
+  EXPECT_EQ(buffer_u64.size(), 4 + u64.size() * sizeof(std::uint64_t));
+  EXPECT_EQ(std::memcmp(buffer_u64.data() + 4, swapped.data(),
+                        u64.size() * sizeof(std::uint64_t)),
+            0);
+  auto des_u64 =
+      serialize::deserialize<serialize_props_big, std::vector<std::uint64_t>>(
+          buffer_u64);
+  if (des_u64.has_value()) {
+    EXPECT_EQ(u64, des_u64.value());
+  } else {
+    std::cout << "error " << __LINE__ << std::endl;
+  }
+
+  std::vector<float> samples(1029);
+  for (std::size_t i = 0; i < samples.size(); ++i) {
+    samples[i] = static_cast<float>(i) * 0.25f;
+  }
+  auto des_f = serialize::deserialize<serialize_props_big, std::vector<float>>(
+      serialize::serialize<serialize_props_big>(samples));
+  if (des_f.has_value()) {
+    EXPECT_EQ(samples, des_f.value());
+  } else {
+    std::cout << "error " << __LINE__ << std::endl;
+  }
+
+  std::array<std::uint16_t, 11> u16{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 0x1234};
+  auto buffer_u16 = serialize::serialize<serialize_props_big>(u16);
+  EXPECT_EQ(buffer_u16.size(), sizeof(u16));
+  EXPECT_EQ(buffer_u16[20], 0x12);
+  EXPECT_EQ(buffer_u16[21], 0x34);
+  auto des_u16 =
+      serialize::deserialize<serialize_props_big, std::array<std::uint16_t, 11>>(
+          buffer_u16);
+  if (des_u16.has_value()) {
+    EXPECT_EQ(u16, des_u16.value());
+  } else {
+    std::cout << "error " << __LINE__ << std::endl;
+  }
+
+  std::int32_t c_arr[5]{-1, 2, -3, 4, -5};
+  auto buffer_c_arr = serialize::serialize<serialize_props_big>(c_arr);
+  EXPECT_EQ(buffer_c_arr.size(), sizeof(c_arr));
+  EXPECT_EQ(buffer_c_arr[7], 2);
+}
@@ -9,9 +9,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <list>
@@ -73,4 +77,274 @@ TEST(SerializerTest, SerializeTest) {
   // auto tt0 = FuncImpl<0>()(tc);
   // EXPECT_EQ(1, tt1);
   // EXPECT_EQ(2.0, tt0);
-}
\ No newline at end of file
+}
+namespace {
+struct forward_only_writer {
+  serialize::detail::memory_writer impl;
+  void write(const char *data, std::size_t len) { impl.write(data, len); }
+};
+}  // namespace
+
+TEST(SerializerTest, StructLengthFieldBackpatchTest) {
+  using namespace serialize::detail;
+  static_assert(backpatch_writer_t<memory_writer>, "");
+  static_assert(!backpatch_writer_t<forward_only_writer>, "");
+
+  person3 p3{{2, 2.2, 2}, {1, 1.2, {1, 2}}};
+  auto size = get_serialize_runtime_info<serialize_props>(p3);
+
+  std::vector<char> recomputed(size);
+  forward_only_writer plain{memory_writer{recomputed.data()}};
+  serialize_to<serialize_props>(plain, size, p3);
+
+  std::vector<char> backpatched(size);
+  memory_writer patching{backpatched.data()};
+  serialize_to<serialize_props>(patching, size, p3);
+
+  EXPECT_EQ(recomputed, backpatched);
+  EXPECT_EQ(backpatched, serialize::serialize<serialize_props>(p3));
+
+  auto des = serialize::deserialize<serialize_props, person3>(backpatched);
+  if (des.has_value()) {
+    EXPECT_EQ(p3, des.value());
+  } else {
+    std::cout << "error: " << __LINE__ << std::endl;
+  }
+}
+
+TEST(SerializerTest, BoundedWriterTest) {
+  person3 p3{{2, 2.2, 2}, {1, 1.2, {1, 2}}};
+  auto expect = serialize::serialize<serialize_props>(p3);
+  EXPECT_EQ(serialize::get_needed_size<serialize_props>(p3), expect.size());
+
+  std::vector<char> small(expect.size() - 1, 0x55);
+  auto res_small = serialize::serialize_to_buffer<serialize_props>(
+      small.data(), small.size(), p3);
+  ASSERT_FALSE(res_small.has_value());
+  EXPECT_EQ(res_small.error(), serialize::return_code::no_buffer_space);
+  EXPECT_EQ(small, std::vector<char>(expect.size() - 1, 0x55));
+
+  std::vector<char> chunk(expect.size() + 16);
+  auto res = serialize::serialize_to_buffer<serialize_props>(
+      chunk.data(), chunk.size(), p3);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(res.value(), expect.size());
+  EXPECT_TRUE(std::equal(expect.begin(), expect.end(), chunk.begin()));
+
+  // spill: the loan is asked for exactly the encoded size
+  std::vector<char> spilled;
+  auto res_loan = serialize::serialize_to_loan<serialize_props>(
+      [&spilled](std::size_t size) {
+        spilled.resize(size);
+        return spilled.data();
+      },
+      p3);
+  ASSERT_TRUE(res_loan.has_value());
+  EXPECT_EQ(spilled, expect);
+
+  auto res_no_loan = serialize::serialize_to_loan<serialize_props>(
+      [](std::size_t) -> char * { return nullptr; }, p3);
+  ASSERT_FALSE(res_no_loan.has_value());
+  EXPECT_EQ(res_no_loan.error(), serialize::return_code::no_buffer_space);
+
+  // a bounded writer driven past its end flags the overflow
+  std::array<char, 8> tiny{};
+  serialize::detail::bounded_writer writer{tiny.data(),
+                                           tiny.data() + tiny.size()};
+  serialize::detail::serialize_to<serialize_props>(writer, expect.size(), p3);
+  EXPECT_TRUE(writer.overflow);
+  EXPECT_LE(writer.buffer, tiny.data() + tiny.size());
+
+  // once a write was dropped the later ones are too, they would land at the
+  // offsets of the dropped bytes
+  std::array<char, 4> room{};
+  serialize::detail::bounded_writer sticky{room.data(),
+                                           room.data() + room.size()};
+  sticky.write("abcdefgh", 8);
+  sticky.write("xy", 2);
+  EXPECT_TRUE(sticky.overflow);
+  EXPECT_EQ(sticky.buffer, room.data());
+  EXPECT_EQ(room, (std::array<char, 4>{}));
+}
+
+TEST(SerializerTest, VarintTest) {
+  using bytes = std::vector<char>;
+  EXPECT_EQ(serialize::serialize(serialize::var_uint32_t{1}), bytes{1});
+  EXPECT_EQ(serialize::serialize(serialize::var_uint32_t{300}),
+            (bytes{(char)0xac, 0x02}));
+  EXPECT_EQ(serialize::serialize(serialize::var_int32_t{-1}), bytes{1});
+  EXPECT_EQ(serialize::serialize(serialize::var_int32_t{1}), bytes{2});
+  EXPECT_EQ(serialize::serialize(serialize::var_uint64_t{UINT64_MAX}).size(),
+            10u);
+
+  const std::int64_t values[] = {0,     1,         -1,        63,
+                                 -64,   64,        8191,      -8192,
+                                 8192,  INT32_MAX, INT32_MIN, INT64_MAX,
+                                 INT64_MIN};
+  for (auto v : values) {
+    serialize::var_int64_t in{v};
+    auto buffer = serialize::serialize(in);
+    EXPECT_EQ(buffer.size(), serialize::get_needed_size(in));
+    auto out = serialize::deserialize<serialize::var_int64_t>(buffer);
+    ASSERT_TRUE(out.has_value());
+    EXPECT_EQ(out.value(), in);
+  }
+
+  // a 64 bit value does not fit a 32 bit varint
+  auto wide = serialize::serialize(serialize::var_uint64_t{UINT32_MAX + 1ull});
+  auto narrow = serialize::deserialize<serialize::var_uint32_t>(wide);
+  ASSERT_FALSE(narrow.has_value());
+  EXPECT_EQ(narrow.error(), serialize::return_code::invalid_buffer);
+
+  // truncated and overlong encodings
+  auto truncated = serialize::deserialize<serialize::var_uint64_t>(
+      bytes{(char)0x80, (char)0x80});
+  ASSERT_FALSE(truncated.has_value());
+  EXPECT_EQ(truncated.error(), serialize::return_code::no_buffer_space);
+  auto overlong = serialize::deserialize<serialize::var_uint64_t>(
+      bytes(11, (char)0x80));
+  ASSERT_FALSE(overlong.has_value());
+  EXPECT_EQ(overlong.error(), serialize::return_code::invalid_buffer);
+
+  // varint length fields: one byte prefixes instead of 2/4 byte ones
+  std::string short_str = "hi";
+  std::vector<int> short_vec{1, 2, 3};
+  auto fixed = serialize::serialize<serialize_props>(short_str, short_vec);
+  auto packed =
+      serialize::serialize<serialize_props_varint>(short_str, short_vec);
+  EXPECT_EQ(fixed.size() - packed.size(), (2u - 1) + (4u - 1));
+  EXPECT_EQ(
+      serialize::get_needed_size<serialize_props_varint>(short_str, short_vec),
+      packed.size());
+
+  std::string long_str(200, 'x');
+  person3 p3{{2, 2.2, 2}, {1, 1.2, {1, 2}}};
+  using tuple_t = std::tuple<std::string, person3, mpark::variant<int, double>>;
+  tuple_t t{long_str, p3, 2.0};
+  auto buffer = serialize::serialize<serialize_props_varint>(t);
+  EXPECT_EQ(buffer.size(),
+            serialize::get_needed_size<serialize_props_varint>(t));
+  auto des = serialize::deserialize<serialize_props_varint, tuple_t>(buffer);
+  ASSERT_TRUE(des.has_value());
+  EXPECT_EQ(des.value(), t);
+}
+
+TEST(SerializerTest, TaggedStructLayoutTest) {
+  using namespace serialize::detail;
+  person1 p1{1, 1.2, 2};
+  // count, then tag + 4 byte length in front of each of the 3 members
+  EXPECT_EQ(serialize::serialize<serialize_props_tagged>(p1).size(),
+            1u + 3 * 5 + 4 + 8 + 4);
+  EXPECT_TRUE((fixed_size_v<serialize_props_tagged, person1>));
+
+  person3 p3{{2, 2.2, 2}, {1, 1.2, {1, 2}}};
+  auto size = get_serialize_runtime_info<serialize_props_tagged>(p3);
+
+  std::vector<char> recomputed(size);
+  forward_only_writer plain{memory_writer{recomputed.data()}};
+  serialize_to<serialize_props_tagged>(plain, size, p3);
+
+  std::vector<char> backpatched(size);
+  memory_writer patching{backpatched.data()};
+  serialize_to<serialize_props_tagged>(patching, size, p3);
+
+  EXPECT_EQ(recomputed, backpatched);
+  EXPECT_EQ(backpatched, serialize::serialize<serialize_props_tagged>(p3));
+}
+
+TEST(SerializerTest, AlignedLayoutTest) {
+  using namespace serialize::detail;
+  static_assert(aligned_layout<serialize_props_aligned>, "");
+  static_assert(!aligned_layout<serialize_props>, "");
+  static_assert(!aligned_layout<serialize::serialize_props_default>, "");
+
+  // a trivially serializable struct gets its in-memory layout
+  person1 p1{1, 1.2, 2};
+  auto buffer = serialize::serialize<serialize_props_aligned>(p1);
+  ASSERT_EQ(buffer.size(), sizeof(person1));
+  EXPECT_EQ(serialize::get_needed_size<serialize_props_aligned>(p1),
+            sizeof(person1));
+  person1 copy{};
+  std::memcpy(&copy.age, buffer.data() + offsetof(person1, age), sizeof(int));
+  std::memcpy(&copy.weight, buffer.data() + offsetof(person1, weight),
+              sizeof(double));
+  std::memcpy(&copy.add, buffer.data() + offsetof(person1, add), sizeof(int));
+  EXPECT_EQ(copy, p1);
+
+  // 1 + 3 padding + 4 + 2 + 6 padding + 8
+  std::tuple<std::uint8_t, std::uint32_t, std::uint16_t, double> t{1, 2, 3, 4};
+  auto packed = serialize::serialize<serialize_props>(t);
+  auto aligned = serialize::serialize<serialize_props_aligned>(t);
+  EXPECT_EQ(packed.size(), 15u);
+  EXPECT_EQ(aligned.size(), 24u);
+  double d = 0;
+  std::memcpy(&d, aligned.data() + 16, sizeof(d));
+  EXPECT_EQ(d, 4.0);
+
+  // padding is capped at kAlignment: double only needs 4 there
+  EXPECT_EQ(serialize::serialize<serialize_props_aligned_framed>(t).size(),
+            kTypeInfoSize + 1 + 3 + 4 + 2 + 2 + 8);
+
+  // the element block of a container starts aligned after its length field
+  std::string name = "abc";
+  std::vector<double> values{1.0, 2.0};
+  auto block = serialize::serialize<serialize_props_aligned>(name, values);
+  EXPECT_EQ(block.size(), 4u + 4 + 4 + 4 + 2 * sizeof(double));
+  std::memcpy(&d, block.data() + 16 + sizeof(double), sizeof(d));
+  EXPECT_EQ(d, 2.0);
+
+  // sizing matches the writer for nested, length prefixed structs
+  person3 p3{{2, 2.2, 2}, {1, 1.2, {1, 2}}};
+  auto framed = serialize::serialize<serialize_props_aligned_framed>(p3);
+  EXPECT_EQ(framed.size(),
+            serialize::get_needed_size<serialize_props_aligned_framed>(p3));
+}
+
+TEST(SerializerTest, IovecWriterTest) {
+  using namespace serialize::detail;
+  static_assert(ref_writer_t<iovec_writer>, "");
+  static_assert(backpatch_writer_t<iovec_writer>, "");
+  static_assert(!ref_writer_t<memory_writer>, "");
+
+  std::vector<std::uint8_t> blob(1 << 16);
+  for (std::size_t i = 0; i < blob.size(); ++i) {
+    blob[i] = static_cast<std::uint8_t>(i * 31);
+  }
+  std::string label = "frame";
+  person3 p3{{2, 2.2, 2}, {1, 1.2, {1, 2}}};
+  auto expect = serialize::serialize<serialize_props>(label, blob, p3);
+
+  iovec_writer writer;
+  serialize::serialize_to<serialize_props>(writer, label, blob, p3);
+  ASSERT_EQ(writer.size(), expect.size());
+
+  // the blob is referenced, everything around it is owned
+  auto &iov = writer.iov();
+  ASSERT_EQ(iov.size(), 3u);
+  EXPECT_EQ(iov[1].iov_base, (void *)blob.data());
+  EXPECT_EQ(iov[1].iov_len, blob.size());
+
+  std::vector<char> gathered(writer.size());
+  writer.gather(gathered.data());
+  EXPECT_EQ(gathered, expect);
+
+  FILE *file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  ASSERT_TRUE(writer.writev(fileno(file)));
+  std::rewind(file);
+  std::vector<char> flushed(expect.size() + 1);
+  EXPECT_EQ(std::fread(flushed.data(), 1, flushed.size(), file),
+            expect.size());
+  flushed.pop_back();
+  EXPECT_EQ(flushed, expect);
+  std::fclose(file);
+
+  // below the threshold everything is copied
+  writer.clear();
+  std::vector<std::uint8_t> small(16, 1);
+  serialize::serialize_to<serialize_props>(writer, small);
+  EXPECT_EQ(writer.iov().size(), 1u);
+  std::vector<char> small_gathered(writer.size());
+  writer.gather(small_gathered.data());
+  EXPECT_EQ(small_gathered, serialize::serialize<serialize_props>(small));
+}
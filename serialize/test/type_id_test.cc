@@ -140,4 +140,13 @@ TEST(SerializerTest, TypeIdTest) {
             serialize::detail::type_id::pointer_t);
   // EXPECT_EQ(serialize::detail::get_type_id<decltype(ref)>(),
   //           serialize::detail::type_id::pointer_t);
+
+  EXPECT_EQ(serialize::detail::get_type_id<serialize::var_int32_t>(),
+            serialize::detail::type_id::v_int32_t);
+  EXPECT_EQ(serialize::detail::get_type_id<serialize::var_int64_t>(),
+            serialize::detail::type_id::v_int64_t);
+  EXPECT_EQ(serialize::detail::get_type_id<serialize::var_uint32_t>(),
+            serialize::detail::type_id::v_uint32_t);
+  EXPECT_EQ(serialize::detail::get_type_id<serialize::var_uint64_t>(),
+            serialize::detail::type_id::v_uint64_t);
 }
\ No newline at end of file
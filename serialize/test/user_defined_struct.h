@@ -7,6 +7,7 @@
  * @LastEditTime: 2024-01-12 14:51:47
  */
 
+#include <array>
 #include <cstdint>
 #include <type_traits>
 
@@ -28,6 +29,128 @@ struct serialize_props {
   static constexpr LengthFieldType kStructLengthField = 8u;
 };
 
+struct serialize_props_varint {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment4;
+  static constexpr ByteOrderType kByteOrder =
+      serialize::byte_order::kLittleEndian;
+  static constexpr LengthFieldType kStringLengthField =
+      serialize::kVarintLengthField;
+  static constexpr LengthFieldType kArrayLengthField =
+      serialize::kVarintLengthField;
+  static constexpr LengthFieldType kUnionLengthField =
+      serialize::kVarintLengthField;
+  static constexpr LengthFieldType kStructLengthField = 4u;
+};
+
+struct serialize_props_tagged {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment4;
+  static constexpr ByteOrderType kByteOrder =
+      serialize::byte_order::kLittleEndian;
+  static constexpr LengthFieldType kStringLengthField = 4u;
+  static constexpr LengthFieldType kArrayLengthField = 4u;
+  static constexpr LengthFieldType kUnionLengthField = 4u;
+  static constexpr LengthFieldType kStructLengthField = 0u;
+  static constexpr serialize::struct_layout kStructLayout =
+      serialize::struct_layout::kTagged;
+};
+
+struct serialize_props_aligned {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment8;
+  static constexpr ByteOrderType kByteOrder =
+      serialize::byte_order::kLittleEndian;
+  static constexpr LengthFieldType kStringLengthField = 4u;
+  static constexpr LengthFieldType kArrayLengthField = 4u;
+  static constexpr LengthFieldType kUnionLengthField = 1u;
+  static constexpr LengthFieldType kStructLengthField = 0u;
+  static constexpr bool kAlignedLayout = true;
+};
+
+// aligned layout with struct lengths and the fingerprint header
+struct serialize_props_aligned_framed {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment4;
+  static constexpr ByteOrderType kByteOrder =
+      serialize::byte_order::kLittleEndian;
+  static constexpr LengthFieldType kStringLengthField = 2u;
+  static constexpr LengthFieldType kArrayLengthField = 4u;
+  static constexpr LengthFieldType kUnionLengthField = 1u;
+  static constexpr LengthFieldType kStructLengthField = 8u;
+  static constexpr serialize::ser_config kTypeInfo =
+      serialize::ENABLE_TYPE_INFO;
+  static constexpr bool kAlignedLayout = true;
+};
+
+struct serialize_props_aligned_typed {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment8;
+  static constexpr ByteOrderType kByteOrder =
+      serialize::byte_order::kLittleEndian;
+  static constexpr LengthFieldType kStringLengthField = 4u;
+  static constexpr LengthFieldType kArrayLengthField = 4u;
+  static constexpr LengthFieldType kUnionLengthField = 1u;
+  static constexpr LengthFieldType kStructLengthField = 0u;
+  static constexpr serialize::ser_config kTypeInfo =
+      serialize::ENABLE_TYPE_INFO;
+  static constexpr bool kAlignedLayout = true;
+};
+
+struct serialize_props_type_info {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment4;
+  static constexpr ByteOrderType kByteOrder =
+      serialize::byte_order::kLittleEndian;
+  static constexpr LengthFieldType kStringLengthField = 4u;
+  static constexpr LengthFieldType kArrayLengthField = 4u;
+  static constexpr LengthFieldType kUnionLengthField = 4u;
+  static constexpr LengthFieldType kStructLengthField = 0u;
+  static constexpr serialize::ser_config kTypeInfo =
+      serialize::ENABLE_TYPE_INFO;
+};
+
+struct serialize_props_limited {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment4;
+  static constexpr ByteOrderType kByteOrder =
+      serialize::byte_order::kLittleEndian;
+  static constexpr LengthFieldType kStringLengthField = 4u;
+  static constexpr LengthFieldType kArrayLengthField = 4u;
+  static constexpr LengthFieldType kUnionLengthField = 1u;
+  static constexpr LengthFieldType kStructLengthField = 0u;
+  static constexpr std::uint64_t kMaxStringLength = 16;
+  static constexpr std::uint64_t kMaxContainerLength = 8;
+};
+
+struct serialize_props_sorted {
+  using LengthFieldType = std::uint8_t;
+  using AlignmentType = serialize::alignment;
+  using ByteOrderType = serialize::byte_order;
+  static constexpr AlignmentType kAlignment = serialize::alignment::kAlignment4;
+  static constexpr ByteOrderType kByteOrder =
+      serialize::byte_order::kLittleEndian;
+  static constexpr LengthFieldType kStringLengthField = 4u;
+  static constexpr LengthFieldType kArrayLengthField = 4u;
+  static constexpr LengthFieldType kUnionLengthField = 1u;
+  static constexpr LengthFieldType kStructLengthField = 0u;
+  static constexpr bool kSortedKeys = true;
+};
+
 // struct
 struct person1 {
   int age;
@@ -88,6 +211,62 @@ struct AA {
 };
 SERIALIZE_REFL(AA, aa, bb, cc, be, dd, fe);
 
+struct sample_msg {
+  std::uint32_t id;
+  std::vector<int> values;
+  std::string name;
+};
+SERIALIZE_REFL(sample_msg, id, values, name);
+
+// same wire layout as sample_msg, decoded without copying the payloads
+struct sample_msg_view {
+  std::uint32_t id;
+  serialize::span<const int> values;
+  serialize::string_view name;
+};
+SERIALIZE_REFL(sample_msg_view, id, values, name);
+
+// two revisions of one message, v2 appends members
+struct record_v1 {
+  std::uint32_t id;
+  std::string name;
+};
+SERIALIZE_REFL(record_v1, id, name);
+
+struct record_v2 {
+  std::uint32_t id;
+  std::string name;
+  std::vector<int> scores;
+  person1 owner;
+};
+SERIALIZE_REFL(record_v2, id, name, scores, owner);
+
+// fixed layout frame without padding, flat under the packed layout as well
+struct sensor_frame {
+  std::uint64_t timestamp;
+  std::array<double, 3> value;
+  std::uint32_t id;
+  std::uint16_t channel;
+  std::uint8_t flags;
+  std::uint8_t quality;
+};
+SERIALIZE_REFL(sensor_frame, timestamp, value, id, channel, flags, quality);
+
+// reflected out of declaration order, same size but not flat
+struct swapped_pair {
+  std::uint32_t first;
+  std::uint32_t second;
+};
+SERIALIZE_REFL(swapped_pair, second, first);
+
+// a member in the middle left out of the reflection
+struct gap_frame {
+  std::uint32_t id;
+  std::uint64_t stamp;
+  std::uint32_t seq;
+};
+SERIALIZE_REFL(gap_frame, id, seq);
+
 namespace example {
 struct Test {
   int a;
@@ -0,0 +1,115 @@
+
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "memory/chunk_header.hpp"
+#include "memory/memory_manager.hpp"
+
+// every layout is registered as
+//   BM_LoanPublishRelease/<layout>/subscribers:<n>/in_flight:<k>
+// with one sample per iteration: it is loaned, written, handed to n
+// subscribers which read it, and the sample loaned k iterations earlier is
+// released. With a large k the chunks of a sample are out of the cache by
+// the time they are released, as with a deep subscriber queue. Compare the
+// layouts with --benchmark_filter, e.g.
+// --benchmark_filter='BM_LoanPublishRelease/.*/subscribers:4/in_flight:4096'.
+// The <layout>/thread_cache variants loan and release through the
+// ThreadCache, see Config::setThreadCache.
+
+namespace {
+
+using shm::memory::BumpAllocator;
+using shm::memory::ChunkSettings;
+using shm::memory::Config;
+using shm::memory::MemoryManager;
+using shm::memory::SharedChunk;
+
+constexpr uint32_t PAYLOAD_SIZE{128U};
+
+struct Fixture {
+  explicit Fixture(const Config& config)
+      : memory(MemoryManager::requiredFullMemorySize(config) /
+                   sizeof(uint64_t) +
+               1U),
+        allocator(memory.data(), memory.size() * sizeof(uint64_t)) {
+    memoryManager.configureMemoryManager(config, allocator, allocator);
+  }
+
+  std::vector<uint64_t> memory;
+  BumpAllocator allocator;
+  MemoryManager memoryManager;
+};
+
+void runLoanPublishRelease(benchmark::State& state,
+                           const Config::ChunkLayout layout,
+                           const bool threadCache) {
+  const auto subscribers = static_cast<uint32_t>(state.range(0));
+  const auto inFlight = static_cast<uint32_t>(state.range(1));
+
+  Config config;
+  config.addMemPool({PAYLOAD_SIZE, inFlight + 1U});
+  config.setChunkLayout(layout);
+  config.setThreadCache(threadCache);
+  Fixture fixture(config);
+  const auto chunkSettings =
+      ChunkSettings::create(PAYLOAD_SIZE, alignof(uint64_t)).value();
+
+  std::vector<SharedChunk> queues(subscribers);
+  std::deque<SharedChunk> samples;
+  uint64_t sequenceNumber{0U};
+  for (auto _ : state) {
+    auto loaned = fixture.memoryManager.getChunk(chunkSettings);
+    if (!loaned.has_value()) {
+      state.SkipWithError("mempool exhausted");
+      break;
+    }
+    SharedChunk sample = std::move(loaned.value());
+    std::memcpy(sample.getUserPayload(), &sequenceNumber,
+                sizeof(sequenceNumber));
+    ++sequenceNumber;
+
+    // delivery keeps one reference per subscriber, reading it goes through
+    // the chunk management to the payload
+    for (auto& queue : queues) {
+      queue = sample;
+      uint64_t received{0U};
+      std::memcpy(&received, queue.getUserPayload(), sizeof(received));
+      benchmark::DoNotOptimize(received);
+    }
+
+    samples.push_back(std::move(sample));
+    if (samples.size() > inFlight) {
+      samples.pop_front();
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void registerLayout(const std::string& name,
+                    const Config::ChunkLayout layout) {
+  for (const bool threadCache : {false, true}) {
+    benchmark::RegisterBenchmark(
+        ("BM_LoanPublishRelease/" + name + (threadCache ? "/thread_cache" : ""))
+            .c_str(),
+        [layout, threadCache](benchmark::State& state) {
+          runLoanPublishRelease(state, layout, threadCache);
+        })
+        ->ArgNames({"subscribers", "in_flight"})
+        ->ArgsProduct({{1, 4}, {1, 64, 4096}});
+  }
+}
+
+const int registered = [] {
+  registerLayout("separate", Config::ChunkLayout::SEPARATE_MANAGEMENT);
+  registerLayout("embedded", Config::ChunkLayout::EMBEDDED_MANAGEMENT);
+  return 0;
+}();
+
+}  // namespace
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <pthread.h>
+
+#include <cstdint>
+
 #include "types/expected.hpp"
 #include "types/optional.hpp"
 
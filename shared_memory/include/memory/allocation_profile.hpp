@@ -0,0 +1,102 @@
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "memory/config.hpp"
+#include "types/optional.hpp"
+
+namespace shm {
+namespace memory {
+
+/// @brief Histogram of the chunk sizes requested from a MemoryManager and the
+/// peak number of chunks in use per size, recorded while the application runs
+/// against a generously sized Config. toConfig() turns it into the mempools
+/// which serve that peak with the least memory.
+/// Recording is lock-free; up to CAPACITY distinct sizes are kept, requests
+/// for further sizes are only counted by getDroppedCount().
+class AllocationProfile {
+ public:
+  static constexpr uint32_t CAPACITY{4096U};
+
+  struct Entry {
+    uint32_t m_requiredChunkSize{0U};
+    uint64_t m_requestCount{0U};
+    uint32_t m_peakInUse{0U};
+  };
+
+  AllocationProfile() noexcept;
+  AllocationProfile(const AllocationProfile&) = delete;
+  AllocationProfile(AllocationProfile&&) = delete;
+  AllocationProfile& operator=(const AllocationProfile&) = delete;
+  AllocationProfile& operator=(AllocationProfile&&) = delete;
+
+  /// @brief records a chunk handed out for ChunkSettings::requiredChunkSize()
+  void recordAcquire(const uint32_t requiredChunkSize) noexcept;
+
+  /// @brief records a chunk returned to its mempool
+  /// @param[in] requiredChunkSize of the chunk, see requiredChunkSize()
+  void recordRelease(const uint32_t requiredChunkSize) noexcept;
+
+  /// @brief recalculates the requested size of a chunk; read it before the
+  /// chunk goes back to its mempool, where it can be reused right away
+  /// @param[in] chunk is the ChunkHeader of the chunk
+  /// @return ChunkSettings::requiredChunkSize() of the loan, 0 if the
+  /// ChunkHeader doesn't describe a valid chunk
+  static uint32_t requiredChunkSize(const void* const chunk) noexcept;
+
+  /// @brief snapshot of the recorded sizes
+  /// @return one Entry per requested size, ordered by size
+  std::vector<Entry> getEntries() const noexcept;
+
+  /// @brief number of requests not recorded because CAPACITY sizes are in use
+  uint64_t getDroppedCount() const noexcept;
+
+  /// @brief Writes entries as text, one size per line
+  static void write(std::ostream& stream,
+                    const std::vector<Entry>& entries) noexcept;
+
+  /// @brief Reads entries written by write()
+  /// @return the entries or nullopt if the stream is not a profile
+  static tl::optional<std::vector<Entry>> read(std::istream& stream) noexcept;
+
+  /// @brief Creates the mempools which serve the peak demand of a profile
+  /// with the least MemoryManager::requiredFullMemorySize. The sizes are
+  /// split into at most maxNumberOfMemPools contiguous ranges, each served by
+  /// one mempool of its largest size, holding the sum of the peaks of the
+  /// range times headroom; the peaks of different sizes are not assumed to
+  /// coincide.
+  /// @param[in] entries of a profile
+  /// @param[in] headroom is the factor applied to the peak demand, >= 1.0
+  /// @param[in] maxNumberOfMemPools upper limit of mempools
+  /// @return the Config with the mempools, empty if entries is empty
+  static Config toConfig(const std::vector<Entry>& entries,
+                         const double headroom = 1.25,
+                         const uint32_t maxNumberOfMemPools =
+                             Config::MAX_NUMBER_OF_MEMPOOLS) noexcept;
+
+ private:
+  struct Slot {
+    /// 0 marks an unused slot, a required chunk size is never 0 since it
+    /// contains the ChunkHeader
+    std::atomic<uint32_t> m_requiredChunkSize{0U};
+    std::atomic<uint32_t> m_inUse{0U};
+    std::atomic<uint32_t> m_peakInUse{0U};
+    std::atomic<uint64_t> m_requestCount{0U};
+  };
+
+  Slot* findSlot(const uint32_t requiredChunkSize,
+                 const bool insert) noexcept;
+
+  std::unique_ptr<Slot[]> m_slots;
+  std::atomic<uint64_t> m_droppedCount{0U};
+};
+
+}  // namespace memory
+}  // namespace shm
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "entity/port_policy.hpp"
 #include "memory/shared_chunk.hpp"
 #include "shm/algorithm.hpp"
@@ -15,6 +15,11 @@ struct ChunkManagement {
   using referenceCounterBase_t = uint64_t;
   using referenceCounter_t = std::atomic<referenceCounterBase_t>;
 
+  /// size of the prefix in front of the ChunkHeader which holds the
+  /// ChunkManagement with Config::ChunkLayout::EMBEDDED_MANAGEMENT; one cache
+  /// line, so the reference counter doesn't share a line with the ChunkHeader
+  static constexpr uint32_t EMBEDDED_PREFIX_SIZE{64U};
+
   ChunkManagement(
       const details::not_null<base_t*> chunkHeader,
       const details::not_null<MemPool*> mempool,
@@ -29,12 +34,41 @@ struct ChunkManagement {
         "'MemPool::CHUNK_MEMORY_ALIGNMENT'!");
   }
 
+  /// @brief Embedded ChunkManagement, it is placed at the start of the chunk
+  /// and the ChunkHeader follows EMBEDDED_PREFIX_SIZE bytes later
+  /// @param[in] mempool the chunk and with it the ChunkManagement belongs to
+  explicit ChunkManagement(const details::not_null<MemPool*> mempool) noexcept
+      : m_mempool(mempool), m_embedded(true) {}
+
+  /// @brief the ChunkHeader, found without a PointerRepository lookup when
+  /// the ChunkManagement is embedded
+  base_t* chunkHeader() const noexcept {
+    if (m_embedded) {
+      return reinterpret_cast<base_t*>(
+          reinterpret_cast<uintptr_t>(this) + EMBEDDED_PREFIX_SIZE);
+    }
+    return m_chunkHeader.get();
+  }
+
+  /// @brief the memory which has to go back to m_mempool
+  void* chunk() noexcept {
+    if (m_embedded) {
+      return this;
+    }
+    return m_chunkHeader.get();
+  }
+
+  /// @brief WARNING: m_chunkHeader and m_chunkManagementPool are only set
+  /// when this is false
+  bool isEmbedded() const noexcept { return m_embedded; }
+
   details::RelativePointer<base_t> m_chunkHeader;
   referenceCounter_t m_referenceCounter{1U};
 
   details::RelativePointer<MemPool> m_mempool;
   details::RelativePointer<MemPool> m_chunkManagementPool;
+  bool m_embedded{false};
 };
 
 }  // namespace memory
-}  // namespace shm
\ No newline at end of file
+}  // namespace shm
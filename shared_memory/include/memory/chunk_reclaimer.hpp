@@ -0,0 +1,78 @@
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "memory/memory_pool.hpp"
+
+namespace shm {
+namespace memory {
+
+struct ChunkManagement;
+
+/// @brief Deferred release of the chunks whose last SharedChunk went away on
+/// the calling thread. The chunk and its ChunkManagement are parked per
+/// MemPool and returned with MemPool::freeChunks once BATCH_SIZE of them piled
+/// up, so releasing a sample costs one free-list operation per batch instead
+/// of two per sample. Parked chunks count as used until they are returned;
+/// MemoryManager::getChunk flushes the reclaimer of the calling thread before
+/// it reports exhausted mempools, ChunkSender::releaseAll flushes it on port
+/// teardown and the thread flushes it on exit.
+/// WARNING: only the thread owning the reclaimer may use it, and it has to be
+/// flushed or disabled before the MemoryManager of a parked chunk goes away.
+class ChunkReclaimer {
+ public:
+  static constexpr uint32_t BATCH_SIZE{MemPool::MAX_BATCH_SIZE};
+  /// the chunks of more MemPools evict each other round robin
+  static constexpr uint32_t NUMBER_OF_BINS{8U};
+
+  /// @brief the reclaimer of the calling thread, disabled until enable() is
+  /// called on it
+  static ChunkReclaimer& forThisThread() noexcept;
+
+  ChunkReclaimer() noexcept = default;
+  /// @brief returns the parked chunks
+  ~ChunkReclaimer() noexcept;
+
+  ChunkReclaimer(const ChunkReclaimer&) = delete;
+  ChunkReclaimer(ChunkReclaimer&&) = delete;
+  ChunkReclaimer& operator=(const ChunkReclaimer&) = delete;
+  ChunkReclaimer& operator=(ChunkReclaimer&&) = delete;
+
+  /// @brief SharedChunk hands the chunks it frees to the reclaimer from now on
+  void enable() noexcept;
+
+  /// @brief flushes and lets SharedChunk free the chunks immediately again
+  void disable() noexcept;
+
+  bool isEnabled() const noexcept;
+
+  /// @brief Parks the chunk and the ChunkManagement, returns the oldest bin
+  /// to its MemPool when there is no bin left for them
+  /// @param[in] chunkManagement whose reference counter dropped to zero
+  void reclaim(ChunkManagement* const chunkManagement) noexcept;
+
+  /// @brief Returns all parked chunks to their MemPools
+  void flush() noexcept;
+
+  /// @brief number of parked chunks and ChunkManagements
+  uint32_t size() const noexcept;
+
+ private:
+  struct Bin {
+    MemPool* m_memPool{nullptr};
+    uint32_t m_size{0U};
+    void* m_chunks[BATCH_SIZE];
+  };
+
+  void park(MemPool* const memPool, void* const chunk) noexcept;
+  void drain(Bin& bin) noexcept;
+
+  Bin m_bins[NUMBER_OF_BINS];
+  uint32_t m_nextEviction{0U};
+  bool m_enabled{false};
+};
+
+}  // namespace memory
+}  // namespace shm
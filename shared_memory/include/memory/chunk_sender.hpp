@@ -2,7 +2,9 @@
 
 #include "memory/chunk_distributor.hpp"
 #include "memory/chunk_header.hpp"
+#include "memory/chunk_reclaimer.hpp"
 #include "memory/memory_manager.hpp"
+#include "memory/thread_cache.hpp"
 #include "types/expected.hpp"
 #include "types/unique_port_id.hpp"
 
@@ -344,6 +346,8 @@ inline void ChunkSender<ChunkSenderDataType>::releaseAll() noexcept {
   getMembers()->m_chunksInUse.cleanup();
   this->cleanup();
   getMembers()->m_lastChunkUnmanaged.releaseToSharedChunk();
+  ChunkReclaimer::forThisThread().flush();
+  ThreadCache::forThisThread().flush();
 }
 
 template <typename ChunkSenderDataType>
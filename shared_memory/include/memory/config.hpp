@@ -19,8 +19,35 @@ struct Config {
     uint32_t m_chunkCount{0};
   };
 
+  /// @brief What MemoryManager::getChunk does when the best fitting mempool
+  /// has no chunk left
+  enum class FallbackPolicy : uint8_t {
+    /// fail with MemoryManager::Error::MEMPOOL_OUT_OF_CHUNKS
+    NONE,
+    /// take the chunk from the next larger mempool which has one left
+    NEXT_LARGER_MEMPOOL,
+  };
+
+  /// @brief Where MemoryManager keeps the reference counter and the mempool
+  /// of a chunk
+  enum class ChunkLayout : uint8_t {
+    /// in a ChunkManagement from a pool of its own, which points to the
+    /// ChunkHeader
+    SEPARATE_MANAGEMENT,
+    /// in the first cache line of the chunk, in front of the ChunkHeader; the
+    /// chunk sizes are rounded up to whole cache lines and mempools ending up
+    /// with the same chunk size are merged
+    EMBEDDED_MANAGEMENT,
+  };
+
   using ConfigContainerType = std::vector<Entry>;
   ConfigContainerType m_mempoolConfig;
+  FallbackPolicy m_fallbackPolicy{FallbackPolicy::NONE};
+  /// every NUMA node gets its own set of the configured mempools
+  uint32_t m_numaNodes{1U};
+  ChunkLayout m_chunkLayout{ChunkLayout::SEPARATE_MANAGEMENT};
+  /// loans and releases go through a MemPoolCache per thread and mempool
+  bool m_threadCache{false};
 
   /// @brief Default constructor to set the configuration for memory pools
   Config() noexcept = default;
@@ -33,6 +60,30 @@ struct Config {
   /// @param[in] Entry structure of mempool configuration
   void addMemPool(Entry f_entry) noexcept;
 
+  /// @brief Function for choosing what happens when a mempool is exhausted
+  /// @param[in] policy applied by MemoryManager::getChunk
+  Config& setFallbackPolicy(const FallbackPolicy policy) noexcept;
+
+  /// @brief Function for giving every NUMA node its own set of mempools with
+  /// the configured chunk counts; MemoryManager::getChunk serves a loan from
+  /// the set of the caller's node. Use details::numberOfNumaNodes() for all
+  /// nodes of the system.
+  /// @param[in] numaNodes is the number of mempool sets, 0 is treated as 1
+  Config& setNumaNodes(const uint32_t numaNodes) noexcept;
+
+  /// @brief Function for choosing where the chunk management is kept;
+  /// EMBEDDED_MANAGEMENT saves a cache miss per access to a chunk at the cost
+  /// of a cache line per chunk
+  /// @param[in] layout used by the MemoryManager
+  Config& setChunkLayout(const ChunkLayout layout) noexcept;
+
+  /// @brief Function for loaning and releasing chunks through a MemPoolCache
+  /// of the calling thread, so the free-list of a mempool is only touched
+  /// once per MemPoolCache::BATCH_SIZE chunks; see ThreadCache for the chunks
+  /// parked in the caches
+  /// @param[in] enabled turns the caches on
+  Config& setThreadCache(const bool enabled) noexcept;
+
   /// @brief Function for creating default memory pools
   Config& setDefaults() noexcept;
 
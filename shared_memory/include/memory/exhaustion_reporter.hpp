@@ -0,0 +1,50 @@
+
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "memory/memory_manager.hpp"
+
+namespace shm {
+namespace memory {
+
+/// @brief Logs the failed loans of a MemoryManager after the fact.
+/// MemoryManager::getChunk and MemPool::getChunk only bump atomic counters
+/// when they fail, so a burst against an exhausted mempool doesn't build
+/// strings or take the logger lock on the loan path. poll() is meant for a
+/// housekeeping thread or the main loop: it logs what happened since its last
+/// report, at most once per interval, so a burst turns into one line per
+/// affected mempool instead of one per failed loan.
+/// WARNING: not thread safe, use one reporter per MemoryManager
+class MemoryExhaustionReporter {
+ public:
+  using Clock_t = std::chrono::steady_clock;
+
+  explicit MemoryExhaustionReporter(
+      const MemoryManager& memoryManager,
+      const Clock_t::duration interval = std::chrono::seconds(1)) noexcept;
+
+  /// @brief Logs the failures since the last report unless the last report
+  /// is more recent than the interval; failures which are not logged yet are
+  /// carried over to the next report
+  /// @param[in] now is the current time
+  /// @return the number of failed loans covered by the report, 0 if there
+  /// were none or the interval did not pass yet
+  uint64_t poll(const Clock_t::time_point now = Clock_t::now()) noexcept;
+
+ private:
+  const MemoryManager* m_memoryManager{nullptr};
+  Clock_t::duration m_interval;
+  Clock_t::time_point m_lastReport;
+  bool m_hasReported{false};
+
+  std::vector<uint64_t> m_reportedExhaustions;
+  std::array<uint64_t, MemoryManager::NUMBER_OF_ERRORS> m_reportedErrors{};
+};
+
+}  // namespace memory
+}  // namespace shm
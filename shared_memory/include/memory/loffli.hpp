@@ -80,6 +80,19 @@ class LoFFLi {
   /// @return true if index is valid or not yet pushed, false otherwise
   bool push(const Index_t index) noexcept;
 
+  /// Pop up to count values from the free-list with a single CAS on the head
+  /// @param [out] indices memory for at least count elements
+  /// @param [in] count is the maximum number of elements to pop
+  /// @return the number of popped elements, 0 if the free-list is empty
+  uint32_t pop_n(Index_t* const indices, const uint32_t count) noexcept;
+
+  /// Push previously poped elements with a single CAS on the head
+  /// @param [in] indices to previously poped elements
+  /// @param [in] count is the number of elements in indices
+  /// @return true if all indices are valid and not yet pushed, false otherwise;
+  /// nothing is pushed in that case
+  bool push_n(const Index_t* const indices, const uint32_t count) noexcept;
+
   /// Calculates the required memory size for a free-list
   /// @param [in] capacity is the number of elements of the free-list
   /// @return the required memory size for a free-list with the requested
@@ -2,10 +2,13 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <limits>
 #include <memory>
 
+#include "memory/allocation_profile.hpp"
 #include "memory/bump_allocator.hpp"
 #include "memory/chunk_header.hpp"
 #include "memory/config.hpp"
@@ -28,13 +31,16 @@ class MemoryManager {
     NO_MEMPOOL_FOR_REQUESTED_CHUNK_SIZE,
     MEMPOOL_OUT_OF_CHUNKS,
   };
+  static constexpr uint32_t NUMBER_OF_ERRORS{3U};
 
   MemoryManager() noexcept = default;
   MemoryManager(const MemoryManager&) = delete;
   MemoryManager(MemoryManager&&) = delete;
   MemoryManager& operator=(const MemoryManager&) = delete;
   MemoryManager& operator=(MemoryManager&&) = delete;
-  ~MemoryManager() noexcept = default;
+  /// @brief returns the chunks the calling thread cached for the mempools;
+  /// the caches of other threads have to be flushed before
+  ~MemoryManager() noexcept;
 
   void configureMemoryManager(const Config& mePooConfig,
                               BumpAllocator& managementAllocator,
@@ -46,10 +52,37 @@ class MemoryManager {
   tl::expected<SharedChunk, Error> getChunk(
       const ChunkSettings& chunkSettings) noexcept;
 
+  /// @brief Obtains a chunk from the mempools of a NUMA node; when they are
+  /// exhausted the other nodes are tried in order before the loan fails
+  /// @param[in] chunkSettings for the requested chunk
+  /// @param[in] numaNode whose mempools are tried first, taken modulo
+  /// getNumberOfNumaNodes() so it works on systems with fewer nodes
+  /// @return a SharedChunk if successful, otherwise a MemoryManager::Error
+  tl::expected<SharedChunk, Error> getChunk(const ChunkSettings& chunkSettings,
+                                            const uint32_t numaNode) noexcept;
+
+  /// @brief Number of mempools of all NUMA nodes; the mempools of node n
+  /// follow the ones of node n - 1
   uint32_t getNumberOfMemPools() const noexcept;
 
+  /// @brief Number of NUMA nodes with their own set of mempools
+  uint32_t getNumberOfNumaNodes() const noexcept;
+
   MemPoolInfo getMemPoolInfo(const uint32_t index) const noexcept;
 
+  /// @brief Number of getChunk calls which failed with the error; getChunk
+  /// only counts failures, a MemoryExhaustionReporter logs them
+  /// @param[in] error to query
+  /// @return the number of failures since the MemoryManager was configured
+  uint64_t getErrorCount(const Error error) const noexcept;
+
+  /// @brief Instrumentation mode: records the required chunk size of every
+  /// loan and the chunks in use per size into profile, nullptr ends it. Call
+  /// it after configureMemoryManager and before loans start; chunks loaned
+  /// before are not counted.
+  /// @param[in] profile to record into
+  void setAllocationProfile(AllocationProfile* const profile) noexcept;
+
   static uint64_t requiredChunkMemorySize(const Config& mePooConfig) noexcept;
   static uint64_t requiredManagementMemorySize(
       const Config& mePooConfig) noexcept;
@@ -58,6 +91,26 @@ class MemoryManager {
  private:
   static uint32_t sizeWithChunkHeaderStruct(
       const MaxChunkPayloadSize_t size) noexcept;
+  /// @brief size of the mempool chunks for a chunk-payload size, including
+  /// the ChunkHeader and, with the embedded layout, the ChunkManagement
+  static uint32_t memPoolChunkSize(const MaxChunkPayloadSize_t size,
+                                   const Config::ChunkLayout layout) noexcept;
+  /// @brief the configured mempools of one NUMA node; with the embedded
+  /// layout the ones with the same memPoolChunkSize are merged
+  static Config::ConfigContainerType memPoolEntries(
+      const Config& mePooConfig) noexcept;
+
+  /// size classes split every power of two into 2^SIZE_CLASS_SUB_BITS linear
+  /// steps, so a mempool is only skipped after the lookup if its chunk size
+  /// is within 1/8 of the requested one
+  static constexpr uint32_t SIZE_CLASS_SUB_BITS{3U};
+  static constexpr uint32_t NUMBER_OF_SIZE_CLASSES{
+      (32U - SIZE_CLASS_SUB_BITS + 1U) << SIZE_CLASS_SUB_BITS};
+
+  static uint32_t sizeClass(const uint32_t size) noexcept;
+  static uint32_t sizeClassLowerBound(const uint32_t sizeClass) noexcept;
+  void generateSizeClassLookup() noexcept;
+  tl::unexpected<Error> countError(const Error error) noexcept;
 
   void printMemPoolVector(std::ostream& log) const noexcept;
   void addMemPool(
@@ -66,6 +119,7 @@ class MemoryManager {
           chunkPayloadSize,
       const greater_or_equal<uint32_t, 1> numberOfChunks) noexcept;
   void generateChunkManagementPool(BumpAllocator& managementAllocator) noexcept;
+  void bindMemPoolsToNumaNode(const uint32_t numaNode) noexcept;
 
  private:
   bool m_denyAddMemPool{false};
@@ -75,6 +129,21 @@ class MemoryManager {
 
   std::vector<std::unique_ptr<MemPool>> m_memPoolVector;
   std::vector<std::unique_ptr<MemPool>> m_chunkManagementPool;
+  uint32_t m_numaNodes{1U};
+  uint32_t m_memPoolsPerNumaNode{0U};
+
+  /// index of the first mempool of a NUMA node with chunks at least as large
+  /// as the lower bound of the size class, m_memPoolsPerNumaNode if there is
+  /// none
+  std::array<uint8_t, NUMBER_OF_SIZE_CLASSES> m_sizeClassToMemPool{};
+  Config::FallbackPolicy m_fallbackPolicy{Config::FallbackPolicy::NONE};
+  Config::ChunkLayout m_chunkLayout{Config::ChunkLayout::SEPARATE_MANAGEMENT};
+  bool m_threadCache{false};
+  /// bytes in front of the ChunkHeader of every chunk
+  uint32_t m_chunkHeaderOffset{0U};
+
+  std::array<std::atomic<uint64_t>, NUMBER_OF_ERRORS> m_errorCounts{};
+  AllocationProfile* m_allocationProfile{nullptr};
 };
 
 inline constexpr const char* asStringLiteral(
@@ -13,14 +13,21 @@
 namespace shm {
 namespace memory {
 
+class AllocationProfile;
+
+/// @brief m_usedChunks counts every chunk which is not on the free-list of the
+/// MemPool, including the free chunks parked in a MemPoolCache;
+/// m_exhaustedCount counts the getChunk calls which found the MemPool empty
 struct MemPoolInfo {
   MemPoolInfo(const uint32_t usedChunks, const uint32_t minFreeChunks,
-              const uint32_t numChunks, const uint32_t chunkSize) noexcept;
+              const uint32_t numChunks, const uint32_t chunkSize,
+              const uint64_t exhaustedCount = 0U) noexcept;
 
   uint32_t m_usedChunks{0};
   uint32_t m_minFreeChunks{0};
   uint32_t m_numChunks{0};
   uint32_t m_chunkSize{0};
+  uint64_t m_exhaustedCount{0};
 };
 
 class MemPool {
@@ -28,11 +35,17 @@ class MemPool {
   using freeList_t = LoFFLi;
   static constexpr uint64_t CHUNK_MEMORY_ALIGNMENT =
       8U;  // default alignment for 64 bit
+  /// upper limit of chunks moved with one operation on the free-list
+  static constexpr uint32_t MAX_BATCH_SIZE = 64U;
 
+  /// @param[in] chunkHeaderOffset is where the ChunkHeader starts in each
+  /// chunk; above CHUNK_MEMORY_ALIGNMENT it has to be a power of two and the
+  /// chunk memory is aligned to it
   MemPool(const greater_or_equal<uint32_t, CHUNK_MEMORY_ALIGNMENT> chunkSize,
           const greater_or_equal<uint32_t, 1> numberOfChunks,
           BumpAllocator& managementAllocator,
-          BumpAllocator& chunkMemoryAllocator) noexcept;
+          BumpAllocator& chunkMemoryAllocator,
+          const uint32_t chunkHeaderOffset = 0U) noexcept;
 
   MemPool(const MemPool&) = delete;
   MemPool(MemPool&&) = delete;
@@ -40,14 +53,43 @@ class MemPool {
   MemPool& operator=(MemPool&&) = delete;
 
   void* getChunk() noexcept;
+  /// @brief getChunk without counting an exhausted MemPool, for a second
+  /// attempt of a loan which was already counted
+  void* tryGetChunk() noexcept;
   uint32_t getChunkSize() const noexcept;
   uint32_t getChunkCount() const noexcept;
   uint32_t getUsedChunks() const noexcept;
   uint32_t getMinFree() const noexcept;
+  uint64_t getExhaustedCount() const noexcept;
   MemPoolInfo getInfo() const noexcept;
+  /// @brief start of the chunk memory, getChunkCount() * getChunkSize() bytes
+  void* getRawMemory() const noexcept;
 
   void freeChunk(const void* chunk) noexcept;
 
+  /// @brief Obtains up to count chunks with one operation on the free-list
+  /// per MAX_BATCH_SIZE chunks
+  /// @param[out] chunks memory for at least count chunk pointers
+  /// @param[in] count is the number of requested chunks
+  /// @return the number of chunks written to chunks, less than count if the
+  /// MemPool ran out of chunks
+  uint32_t getChunks(void** const chunks, const uint32_t count) noexcept;
+
+  /// @brief Returns chunks with one operation on the free-list per
+  /// MAX_BATCH_SIZE chunks
+  /// @param[in] chunks previously obtained from this MemPool
+  /// @param[in] count is the number of chunks
+  void freeChunks(void* const* const chunks, const uint32_t count) noexcept;
+
+  /// @brief Reports every chunk returned with freeChunk to profile, nullptr
+  /// stops it; the chunks must have a ChunkHeader at the chunkHeaderOffset
+  void setAllocationProfile(AllocationProfile* const profile) noexcept;
+
+  /// @brief Chunks of a thread cached MemPool are loaned and released through
+  /// the ThreadCache of the calling thread
+  void setThreadCached(const bool threadCached) noexcept;
+  bool isThreadCached() const noexcept;
+
   /// @brief Converts an index to a chunk in the MemPool to a pointer
   /// @param[in] index of the chunk
   /// @param[in] chunkSize is the size of the chunk
@@ -66,20 +108,28 @@ class MemPool {
                                  const void* const rawMemoryBase) noexcept;
 
  private:
-  void adjustMinFree() noexcept;
+  void adjustMinFree(const uint32_t usedChunks) noexcept;
   bool isMultipleOfAlignment(const uint32_t value) const noexcept;
+  void checkChunkRange(const void* const chunk) const noexcept;
 
   RelativePointer<void> m_rawMemory;
 
   uint32_t m_chunkSize{0U};
+  uint32_t m_chunkHeaderOffset{0U};
   /// needs to be 32 bit since loffli supports only 32 bit numbers
   /// (cas is only 64 bit and we need the other 32 bit for the aba counter)
   uint32_t m_numberOfChunks{0U};
 
   std::atomic<uint32_t> m_usedChunks{0U};
   std::atomic<uint32_t> m_minFree{0U};
+  /// only counted, reporting is left to a MemoryExhaustionReporter so an
+  /// exhausted MemPool doesn't slow down the loans failing on it
+  std::atomic<uint64_t> m_exhaustedCount{0U};
 
   freeList_t m_freeIndices;
+
+  AllocationProfile* m_allocationProfile{nullptr};
+  bool m_threadCached{false};
 };
 
 }  // namespace memory
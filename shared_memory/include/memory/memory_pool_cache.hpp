@@ -0,0 +1,64 @@
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "memory/memory_pool.hpp"
+
+namespace shm {
+namespace memory {
+
+/// @brief Magazine of free chunks of one MemPool in front of its free-list.
+/// Chunks are taken from and returned to the MemPool BATCH_SIZE at a time, so
+/// the CAS on the free-list head and the accounting of the MemPool are paid
+/// once per batch instead of once per chunk. Chunks parked in the cache count
+/// as used in the MemPoolInfo until they are drained or flushed.
+/// WARNING: MemPoolCache is not thread safe! Use one per thread or port; the
+/// chunks it hands out may be freed to any cache of the same MemPool or to the
+/// MemPool itself. The MemoryManager uses the ones of ThreadCache.
+class MemPoolCache {
+ public:
+  static constexpr uint32_t CAPACITY{MemPool::MAX_BATCH_SIZE};
+  static constexpr uint32_t BATCH_SIZE{CAPACITY / 2U};
+
+  explicit MemPoolCache(MemPool& memPool) noexcept;
+  /// @brief returns the parked chunks to the MemPool
+  ~MemPoolCache() noexcept;
+
+  MemPoolCache(const MemPoolCache&) = delete;
+  MemPoolCache(MemPoolCache&&) = delete;
+  MemPoolCache& operator=(const MemPoolCache&) = delete;
+  MemPoolCache& operator=(MemPoolCache&&) = delete;
+
+  /// @brief Obtains a chunk from the cache, refills it from the MemPool when
+  /// it is empty
+  /// @return the chunk or nullptr if the MemPool has no more chunks
+  void* getChunk() noexcept;
+
+  /// @brief Parks a chunk in the cache, drains the oldest BATCH_SIZE chunks
+  /// to the MemPool when it is full
+  /// @param[in] chunk previously obtained from the same MemPool
+  void freeChunk(const void* chunk) noexcept;
+
+  /// @brief Returns all parked chunks to the MemPool, e.g. before a port goes
+  /// idle for a while
+  void flush() noexcept;
+
+  /// @brief number of chunks parked in the cache
+  uint32_t size() const noexcept;
+
+  MemPool& getMemPool() const noexcept;
+
+ private:
+  void drain(const uint32_t count) noexcept;
+
+  MemPool* m_memPool{nullptr};
+  uint32_t m_size{0U};
+  /// LIFO, the most recently freed chunk is handed out first while its cache
+  /// lines are still warm
+  void* m_chunks[CAPACITY];
+};
+
+}  // namespace memory
+}  // namespace shm
@@ -104,6 +104,7 @@ Segment<SharedMemoryObjectType, MemoryManagerType>::createSharedMemoryObject(
                  MemoryManager::requiredChunkMemorySize(mempoolConfig),
                  AccessMode::READ_WRITE, OpenMode::PURGE_AND_CREATE,
                  SEGMENT_PERMISSIONS)
+                 .memoryInfo(m_memoryInfo)
                  .create();
   if (res.has_value()) {
     auto& sharedMemoryObject = res.value();
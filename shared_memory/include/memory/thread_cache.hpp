@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+#include "memory/memory_pool.hpp"
+#include "memory/memory_pool_cache.hpp"
+#include "types/optional.hpp"
+
+namespace shm {
+namespace memory {
+
+/// @brief The MemPoolCaches of the calling thread for the MemPools configured
+/// with Config::setThreadCache. MemoryManager::getChunk loans the chunk and
+/// its ChunkManagement from them and SharedChunk returns both to the caches of
+/// the thread that drops the last reference. The caches of more MemPools
+/// evict each other round robin. Chunks parked in a cache count as used until
+/// they are flushed and only the thread that parked them can loan them again;
+/// ChunkSender::releaseAll flushes the caches on port teardown, the
+/// MemoryManager flushes the ones of its destroying thread and every thread
+/// flushes them on exit.
+/// WARNING: only the thread owning the caches may use them, and they have to
+/// be flushed before the MemoryManager of a parked chunk goes away.
+class ThreadCache {
+ public:
+  static constexpr uint32_t NUMBER_OF_CACHES{8U};
+
+  /// @brief the caches of the calling thread
+  static ThreadCache& forThisThread() noexcept;
+
+  /// @brief Obtains a chunk from the cache of the calling thread if the
+  /// MemPool is thread cached, from the MemPool itself otherwise
+  /// @param[in] memPool to loan the chunk from
+  /// @return the chunk or nullptr if the MemPool has no more chunks
+  static void* getChunk(MemPool& memPool) noexcept;
+
+  /// @brief Parks the chunk in the cache of the calling thread if the MemPool
+  /// is thread cached, returns it to the MemPool otherwise
+  /// @param[in] memPool the chunk was obtained from
+  /// @param[in] chunk to release
+  static void freeChunk(MemPool& memPool, const void* chunk) noexcept;
+
+  ThreadCache() noexcept = default;
+  /// @brief returns the parked chunks
+  ~ThreadCache() noexcept;
+
+  ThreadCache(const ThreadCache&) = delete;
+  ThreadCache(ThreadCache&&) = delete;
+  ThreadCache& operator=(const ThreadCache&) = delete;
+  ThreadCache& operator=(ThreadCache&&) = delete;
+
+  /// @brief the cache of the MemPool, evicts the oldest cache when there is
+  /// no slot left for it
+  MemPoolCache& cacheOf(MemPool& memPool) noexcept;
+
+  /// @brief Returns all parked chunks to their MemPools
+  void flush() noexcept;
+
+  /// @brief Returns the chunks parked for the MemPool and drops its cache
+  void flush(const MemPool& memPool) noexcept;
+
+  /// @brief number of parked chunks
+  uint32_t size() const noexcept;
+
+ private:
+  tl::optional<MemPoolCache> m_caches[NUMBER_OF_CACHES];
+  uint32_t m_nextEviction{0U};
+  /// false once the thread exit destroyed the caches
+  bool m_enabled{true};
+};
+
+}  // namespace memory
+}  // namespace shm
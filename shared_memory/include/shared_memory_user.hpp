@@ -1,5 +1,6 @@
 
 
+#include "shm/memory_info.hpp"
 #include "shm/relative_pointer.hpp"
 #include "shm/shared_memory_object.hpp"
 
@@ -13,9 +14,13 @@ class SharedMemoryUser {
   /// final mapping of memory in the process
   /// @param[in] segmentId of the relocatable shared memory segment
   /// address space
-  SharedMemoryUser(const size_t dataSize, const uint64_t segmentId,
-                   const details::UntypedRelativePointer::offset_t
-                       segmentManagerAddressOffset) noexcept;
+  /// @param[in] memoryInfo the management segment was created with, a
+  /// segment on hugetlbfs is only found with HugePages::HUGETLBFS
+  SharedMemoryUser(
+      const size_t dataSize, const uint64_t segmentId,
+      const details::UntypedRelativePointer::offset_t
+          segmentManagerAddressOffset,
+      const details::MemoryInfo& memoryInfo = details::MemoryInfo()) noexcept;
 
  private:
   void OpenDataSegments(const uint64_t segmentId,
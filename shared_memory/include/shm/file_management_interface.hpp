@@ -3,6 +3,7 @@
 #pragma once
 
 #include <spdlog/spdlog.h>
+#include <sys/stat.h>
 
 #include <limits>
 #include <string>
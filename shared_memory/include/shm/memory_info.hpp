@@ -6,6 +6,29 @@
 namespace shm {
 namespace details {
 
+/// @brief Defines which pages back the memory
+enum class HugePages : uint8_t {
+  /// @brief pages of the system page size
+  NONE,
+  /// @brief the kernel is advised to back the memory with transparent huge
+  ///        pages, this requires 'advise' or 'always' in
+  ///        /sys/kernel/mm/transparent_hugepage/shmem_enabled
+  TRANSPARENT,
+  /// @brief the memory is a file in the hugetlbfs mount, falls back to
+  ///        TRANSPARENT when there is no mount or not enough reserved pages
+  HUGETLBFS
+};
+
+/// @brief Defines on which NUMA nodes the pages of the memory are placed
+enum class NumaPolicy : uint8_t {
+  /// @brief the pages are placed where they are first touched
+  DEFAULT,
+  /// @brief the pages are placed on MemoryInfo::numaNode
+  BIND,
+  /// @brief the pages are spread round robin over all allowed nodes
+  INTERLEAVE
+};
+
 struct MemoryInfo {
   static constexpr uint32_t DEFAULT_DEVICE_ID{0U};
   static constexpr uint32_t DEFAULT_MEMORY_TYPE{0U};
@@ -18,6 +41,24 @@ struct MemoryInfo {
   uint32_t deviceId{DEFAULT_DEVICE_ID};
   uint32_t memoryType{DEFAULT_MEMORY_TYPE};
 
+  /// @brief the pages backing the memory
+  HugePages hugePages{HugePages::NONE};
+
+  /// @brief faults in all pages when the memory is mapped, so that the first
+  ///        write into a page does not stall on a page fault
+  bool prefault{false};
+
+  /// @brief locks the mapped memory in RAM with mlock, this is best effort
+  ///        since it is bound to RLIMIT_MEMLOCK
+  bool lockMemory{false};
+
+  /// @brief the NUMA placement of the pages, ignored with a warning on
+  ///        systems without NUMA support
+  NumaPolicy numaPolicy{NumaPolicy::DEFAULT};
+
+  /// @brief the node used with NumaPolicy::BIND
+  uint32_t numaNode{0U};
+
   MemoryInfo(const MemoryInfo&) noexcept = default;
   MemoryInfo(MemoryInfo&&) noexcept = default;
   MemoryInfo& operator=(const MemoryInfo&) noexcept = default;
@@ -35,4 +76,4 @@ struct MemoryInfo {
 };
 
 }  // namespace details
-}  // namespace shm
\ No newline at end of file
+}  // namespace shm
@@ -3,6 +3,7 @@
 #include <cstdint>
 
 #include "shm/file_access.hpp"
+#include "shm/memory_info.hpp"
 #include "types/expected.hpp"
 
 #define MAP_SHARED 0x01  /* Share changes.  */
@@ -77,15 +78,33 @@ class MemoryMap {
   /// nullptr
   void* getBaseAddress() noexcept;
 
+  /// @brief returns true when the kernel accepted the advice to back the
+  ///        mapping with transparent huge pages
+  bool usesTransparentHugePages() const noexcept;
+
+  /// @brief returns true when the mapped memory is locked in RAM
+  bool isLocked() const noexcept;
+
+  /// @brief returns the NUMA policy applied to the mapping, DEFAULT when the
+  ///        requested one could not be applied
+  NumaPolicy getNumaPolicy() const noexcept;
+
   friend class MemoryMapBuilder;
 
  private:
   MemoryMap(void* const baseAddress, const uint64_t length) noexcept;
   bool destroy() noexcept;
+  void adviseTransparentHugePages() noexcept;
+  void applyNumaPolicy(const NumaPolicy policy, const uint32_t node) noexcept;
+  void prefault(const AccessMode accessMode) noexcept;
+  void lock() noexcept;
   static MemoryMapError errnoToEnum(const int32_t errnum) noexcept;
 
   void* m_baseAddress{nullptr};
   uint64_t m_length{0U};
+  bool m_transparentHugePages{false};
+  bool m_isLocked{false};
+  NumaPolicy m_numaPolicy{NumaPolicy::DEFAULT};
 };
 
 class MemoryMapBuilder {
@@ -114,6 +133,24 @@ class MemoryMapBuilder {
   /// @brief Offset of the memory location
   off_t m_offset = 0;
 
+  /// @brief Advises the kernel to back the mapping with transparent huge pages
+  bool m_transparentHugePages = false;
+
+  /// @brief Faults in all pages of the mapping before create returns
+  bool m_prefault = false;
+
+  /// @brief Places the pages on NUMA nodes, applied before they are faulted
+  ///        in. A failure is only logged and the pages are placed on first
+  ///        touch.
+  NumaPolicy m_numaPolicy = NumaPolicy::DEFAULT;
+
+  /// @brief The node used with NumaPolicy::BIND
+  uint32_t m_numaNode = 0U;
+
+  /// @brief Locks the mapped pages in RAM. A failing mlock is only logged
+  ///        since the mapping itself is still usable.
+  bool m_lock = false;
+
  public:
   /// @brief creates a valid 'MemoryMap' object. If the construction failed
   /// the
@@ -129,6 +166,33 @@ class MemoryMapBuilder {
         m_accessMode(accessMode),
         m_flags(flags),
         m_offset(offset) {}
+
+  /// @brief see m_transparentHugePages
+  MemoryMapBuilder& transparentHugePages(const bool value) noexcept {
+    m_transparentHugePages = value;
+    return *this;
+  }
+
+  /// @brief see m_prefault
+  MemoryMapBuilder& prefault(const bool value) noexcept {
+    m_prefault = value;
+    return *this;
+  }
+
+  /// @brief see m_lock
+  MemoryMapBuilder& lock(const bool value) noexcept {
+    m_lock = value;
+    return *this;
+  }
+
+  /// @brief see m_numaPolicy and m_numaNode
+  MemoryMapBuilder& numaPolicy(const NumaPolicy policy,
+                               const uint32_t node) noexcept {
+    m_numaPolicy = policy;
+    m_numaNode = node;
+    return *this;
+  }
+
   tl::expected<MemoryMap, MemoryMapError> create() noexcept;
 };
 
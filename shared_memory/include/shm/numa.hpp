@@ -0,0 +1,36 @@
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "shm/memory_info.hpp"
+
+namespace shm {
+namespace details {
+
+/// @brief the highest node number + 1 the NUMA functions support
+constexpr uint32_t MAX_NUMBER_OF_NUMA_NODES{64U};
+
+/// @brief returns the NUMA node of the CPU the calling thread currently runs
+///        on, 0 when it cannot be determined
+uint32_t currentNumaNode() noexcept;
+
+/// @brief returns the highest node the process may allocate memory on + 1,
+///        1 on systems without NUMA support
+uint32_t numberOfNumaNodes() noexcept;
+
+/// @brief applies a NUMA policy to the pages in the given range, pages which
+///        are already present are moved when they are only mapped by the
+///        calling process
+/// @param[in] address of the range, must be aligned to the page size
+/// @param[in] length of the range in bytes
+/// @param[in] policy to apply, NumaPolicy::DEFAULT resets the range
+/// @param[in] node used with NumaPolicy::BIND
+/// @return true if the policy was applied, false when the system has no NUMA
+///         support, the node does not exist or the call is not permitted
+bool setNumaPolicy(void* const address, const uint64_t length,
+                   const NumaPolicy policy, const uint32_t node) noexcept;
+
+}  // namespace details
+}  // namespace shm
@@ -40,6 +40,9 @@ class SharedMemory : public FileManagementInterface<SharedMemory> {
   static constexpr int INVALID_HANDLE = -1;
   using Name_t = std::string;
 
+  /// @brief the directory in which shared memory on hugetlbfs is created
+  static constexpr const char* HUGETLBFS_MOUNT_POINT = "/dev/hugepages";
+
   SharedMemory(const SharedMemory&) = delete;
   SharedMemory& operator=(const SharedMemory&) = delete;
   SharedMemory(SharedMemory&&) noexcept;
@@ -57,19 +60,28 @@ class SharedMemory : public FileManagementInterface<SharedMemory> {
   ///        ownership.
   bool hasOwnership() const noexcept;
 
+  /// @brief returns true when the shared memory is a file in
+  ///        HUGETLBFS_MOUNT_POINT instead of a POSIX shared memory object
+  bool isOnHugetlbfs() const noexcept;
+
+  /// @brief returns true when a hugetlbfs is mounted at HUGETLBFS_MOUNT_POINT
+  static bool isHugetlbfsAvailable() noexcept;
+
   /// @brief removes shared memory with a given name from the system
   /// @param[in] name name of the shared memory
+  /// @param[in] onHugetlbfs removes the file in HUGETLBFS_MOUNT_POINT instead
+  ///            of the POSIX shared memory object
   /// @return true if the shared memory was removed, false if the shared memory
   /// did not exist and
   ///         SharedMemoryError when the underlying shm_unlink call failed.
   static tl::expected<bool, SharedMemoryError> unlinkIfExist(
-      const Name_t& name) noexcept;
+      const Name_t& name, const bool onHugetlbfs = false) noexcept;
 
   friend class SharedMemoryBuilder;
 
  private:
   SharedMemory(const Name_t& name, const shm_handle_t handle,
-               const bool hasOwnership) noexcept;
+               const bool hasOwnership, const bool onHugetlbfs) noexcept;
 
   bool unlink() noexcept;
   bool close() noexcept;
@@ -83,6 +95,7 @@ class SharedMemory : public FileManagementInterface<SharedMemory> {
   Name_t m_name;
   shm_handle_t m_handle{INVALID_HANDLE};
   bool m_hasOwnership{false};
+  bool m_isOnHugetlbfs{false};
 };
 
 class SharedMemoryBuilder {
@@ -106,6 +119,11 @@ class SharedMemoryBuilder {
   /// @brief Defines the size of the shared memory
   std::uint64_t m_size;
 
+  /// @brief Creates or opens the shared memory as file in the hugetlbfs mount
+  ///        point. A created file is resized to a multiple of the huge page
+  ///        size.
+  bool m_onHugetlbfs = false;
+
  public:
   /// @brief creates a valid SharedMemory object. If the construction failed
   /// the expected
@@ -120,6 +138,13 @@ class SharedMemoryBuilder {
         m_openMode(openMode),
         m_filePermissions(ar),
         m_size(size) {}
+
+  /// @brief see m_onHugetlbfs
+  SharedMemoryBuilder& hugetlbfs(const bool value) noexcept {
+    m_onHugetlbfs = value;
+    return *this;
+  }
+
   tl::expected<SharedMemory, SharedMemoryError> create() noexcept;
 };
 
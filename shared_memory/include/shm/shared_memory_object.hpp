@@ -10,6 +10,7 @@
 
 #include <cstdint>
 
+#include "shm/memory_info.hpp"
 #include "shm/memory_map.hpp"
 #include "shm/shared_memory.hpp"
 #include "types/expected.hpp"
@@ -59,6 +60,11 @@ class SharedMemoryObject : public FileManagementInterface<SharedMemoryObject> {
   ///        existing shared memory was opened.
   bool hasOwnership() const noexcept;
 
+  /// @brief Returns the options which are in effect for the mapped memory.
+  ///        They differ from the requested ones when huge pages or locking
+  ///        were not available and the object fell back to regular pages.
+  const MemoryInfo& getMemoryInfo() const noexcept;
+
   inline tl::expected<uint64_t, FileStatError> get_size() const noexcept {
     auto result = details::get_file_status(get_file_handle());
     if (!result.has_value()) {
@@ -71,7 +77,8 @@ class SharedMemoryObject : public FileManagementInterface<SharedMemoryObject> {
 
  private:
   SharedMemoryObject(details::SharedMemory&& sharedMemory,
-                     details::MemoryMap&& memoryMap) noexcept;
+                     details::MemoryMap&& memoryMap,
+                     const MemoryInfo& memoryInfo) noexcept;
 
   friend struct FileManagementInterface<SharedMemoryObject>;
 
@@ -80,6 +87,7 @@ class SharedMemoryObject : public FileManagementInterface<SharedMemoryObject> {
  private:
   details::SharedMemory m_sharedMemory;
   details::MemoryMap m_memoryMap;
+  MemoryInfo m_memoryInfo;
 };
 
 class SharedMemoryObjectBuilder {
@@ -110,6 +118,13 @@ class SharedMemoryObjectBuilder {
   /// @brief Defines the access permissions of the shared memory
   access_rights m_permissions = perms::none;
 
+  /// @brief Defines the pages backing the memory and whether it is prefaulted
+  ///        and locked
+  MemoryInfo m_memoryInfo;
+
+  tl::expected<SharedMemoryObject, SharedMemoryObjectError> create(
+      const bool onHugetlbfs) noexcept;
+
  public:
   explicit SharedMemoryObjectBuilder(const SharedMemory::Name_t& name,
                                      const uint64_t memorySize,
@@ -121,6 +136,14 @@ class SharedMemoryObjectBuilder {
         m_openMode(om),
         m_permissions(rights) {}
 
+  /// @brief see m_memoryInfo
+  SharedMemoryObjectBuilder& memoryInfo(const MemoryInfo& info) noexcept {
+    m_memoryInfo = info;
+    return *this;
+  }
+
+  /// @brief creates the shared memory object, with HugePages::HUGETLBFS it
+  ///        tries hugetlbfs first and falls back to POSIX shared memory
   tl::expected<SharedMemoryObject, SharedMemoryObjectError> create() noexcept;
 };
 
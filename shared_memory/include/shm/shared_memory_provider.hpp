@@ -3,6 +3,7 @@
 #pragma once
 
 #include "shm/file_access.hpp"
+#include "shm/memory_info.hpp"
 #include "shm/memory_provider.hpp"
 #include "shm/shared_memory_object.hpp"
 
@@ -18,8 +19,11 @@ class SharedMemoryProvider : public MemoryProvider {
   /// @param [in] shmName is the name of the posix share memory
   /// @param [in] accessMode defines the read and write access to the memory
   /// @param [in] openMode defines the creation/open mode of the shared memory.
+  /// @param [in] memoryInfo defines huge page backing, prefaulting and locking
+  ///             of the shared memory
   SharedMemoryProvider(const ShmName_t& shmName, const AccessMode accessMode,
-                       const OpenMode openMode) noexcept;
+                       const OpenMode openMode,
+                       const MemoryInfo& memoryInfo = MemoryInfo()) noexcept;
   ~SharedMemoryProvider() noexcept;
 
   SharedMemoryProvider(SharedMemoryProvider&&) = delete;
@@ -43,6 +47,7 @@ class SharedMemoryProvider : public MemoryProvider {
   ShmName_t m_shmName;
   AccessMode m_accessMode{AccessMode::READ_ONLY};
   OpenMode m_openMode{OpenMode::OPEN_EXISTING};
+  MemoryInfo m_memoryInfo;
   tl::optional<SharedMemoryObject> m_shmObject;
 
   static constexpr access_rights SHM_MEMORY_PERMISSIONS =
@@ -85,7 +85,7 @@ memory::ChunkHeader* ShmSafeUnmanagedChunk::getChunkHeader() noexcept {
   auto chunkMgmt = details::RelativePointer<memory::ChunkManagement>(
       m_chunkManagement.offset(),
       details::segment_id_t{m_chunkManagement.id()});
-  return chunkMgmt->m_chunkHeader.get();
+  return chunkMgmt->chunkHeader();
 }
 
 const memory::ChunkHeader* ShmSafeUnmanagedChunk::getChunkHeader()
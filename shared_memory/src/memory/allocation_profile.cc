@@ -0,0 +1,284 @@
+
+
+#include "memory/allocation_profile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "memory/chunk_header.hpp"
+#include "memory/chunk_management.hpp"
+#include "memory/chunk_setting.hpp"
+#include "memory/memory_pool.hpp"
+#include "shm/algorithm.hpp"
+#include "shm/memory.hpp"
+
+namespace shm {
+namespace memory {
+
+constexpr uint32_t AllocationProfile::CAPACITY;
+
+static_assert((AllocationProfile::CAPACITY &
+               (AllocationProfile::CAPACITY - 1U)) == 0U,
+              "The capacity must be a power of two for the slot index mask!");
+
+AllocationProfile::AllocationProfile() noexcept
+    : m_slots(new Slot[CAPACITY]) {}
+
+AllocationProfile::Slot* AllocationProfile::findSlot(
+    const uint32_t requiredChunkSize, const bool insert) noexcept {
+  const uint32_t hash = requiredChunkSize * 2654435761U;
+  for (uint32_t probe = 0U; probe < CAPACITY; ++probe) {
+    auto& slot = m_slots[(hash + probe) & (CAPACITY - 1U)];
+    uint32_t key = slot.m_requiredChunkSize.load(std::memory_order_acquire);
+    if (key == requiredChunkSize) {
+      return &slot;
+    }
+    if (key == 0U) {
+      if (!insert) {
+        return nullptr;
+      }
+      if (slot.m_requiredChunkSize.compare_exchange_strong(
+              key, requiredChunkSize, std::memory_order_acq_rel,
+              std::memory_order_acquire) ||
+          key == requiredChunkSize) {
+        return &slot;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void AllocationProfile::recordAcquire(
+    const uint32_t requiredChunkSize) noexcept {
+  auto slot = findSlot(requiredChunkSize, true);
+  if (slot == nullptr) {
+    m_droppedCount.fetch_add(1U, std::memory_order_relaxed);
+    return;
+  }
+
+  slot->m_requestCount.fetch_add(1U, std::memory_order_relaxed);
+  const uint32_t inUse =
+      slot->m_inUse.fetch_add(1U, std::memory_order_relaxed) + 1U;
+  uint32_t peak = slot->m_peakInUse.load(std::memory_order_relaxed);
+  while (inUse > peak &&
+         !slot->m_peakInUse.compare_exchange_weak(peak, inUse,
+                                                  std::memory_order_relaxed)) {
+  }
+}
+
+uint32_t AllocationProfile::requiredChunkSize(
+    const void* const chunk) noexcept {
+  const auto chunkHeader = static_cast<const ChunkHeader*>(chunk);
+  // the user-header alignment is not stored in the ChunkHeader and doesn't
+  // contribute to the required chunk size
+  auto chunkSettings = ChunkSettings::create(
+      chunkHeader->userPayloadSize(), chunkHeader->userPayloadAlignment(),
+      chunkHeader->userHeaderSize(), 1U);
+  if (!chunkSettings.has_value()) {
+    return 0U;
+  }
+  return chunkSettings.value().requiredChunkSize();
+}
+
+void AllocationProfile::recordRelease(
+    const uint32_t requiredChunkSize) noexcept {
+  if (requiredChunkSize == 0U) {
+    return;
+  }
+
+  auto slot = findSlot(requiredChunkSize, false);
+  if (slot == nullptr) {
+    return;
+  }
+
+  /// chunks which were loaned before the profile was attached are not counted
+  uint32_t inUse = slot->m_inUse.load(std::memory_order_relaxed);
+  while (inUse > 0U &&
+         !slot->m_inUse.compare_exchange_weak(inUse, inUse - 1U,
+                                              std::memory_order_relaxed)) {
+  }
+}
+
+std::vector<AllocationProfile::Entry> AllocationProfile::getEntries()
+    const noexcept {
+  std::vector<Entry> entries;
+  for (uint32_t i = 0U; i < CAPACITY; ++i) {
+    const auto& slot = m_slots[i];
+    const auto requiredChunkSize =
+        slot.m_requiredChunkSize.load(std::memory_order_acquire);
+    if (requiredChunkSize != 0U) {
+      entries.push_back({requiredChunkSize,
+                         slot.m_requestCount.load(std::memory_order_relaxed),
+                         slot.m_peakInUse.load(std::memory_order_relaxed)});
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& lhs, const Entry& rhs) {
+              return lhs.m_requiredChunkSize < rhs.m_requiredChunkSize;
+            });
+  return entries;
+}
+
+uint64_t AllocationProfile::getDroppedCount() const noexcept {
+  return m_droppedCount.load(std::memory_order_relaxed);
+}
+
+void AllocationProfile::write(std::ostream& stream,
+                              const std::vector<Entry>& entries) noexcept {
+  stream << "# requiredChunkSize requestCount peakInUse\n";
+  for (const auto& entry : entries) {
+    stream << entry.m_requiredChunkSize << ' ' << entry.m_requestCount << ' '
+           << entry.m_peakInUse << '\n';
+  }
+}
+
+tl::optional<std::vector<AllocationProfile::Entry>> AllocationProfile::read(
+    std::istream& stream) noexcept {
+  std::vector<Entry> entries;
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    Entry entry;
+    if (!(fields >> entry.m_requiredChunkSize >> entry.m_requestCount >>
+          entry.m_peakInUse) ||
+        entry.m_requiredChunkSize == 0U) {
+      return tl::nullopt;
+    }
+    entries.push_back(entry);
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& lhs, const Entry& rhs) {
+              return lhs.m_requiredChunkSize < rhs.m_requiredChunkSize;
+            });
+  return entries;
+}
+
+namespace {
+struct Demand {
+  uint32_t m_chunkPayloadSize{0U};
+  uint64_t m_peakInUse{0U};
+};
+
+/// the share of MemoryManager::requiredFullMemorySize of one mempool: its
+/// chunks, its free-list and the chunk management for each of its chunks
+uint64_t requiredMemPoolMemorySize(const uint32_t chunkPayloadSize,
+                                   const uint64_t chunkCount) noexcept {
+  return details::align(chunkCount * (chunkPayloadSize + sizeof(ChunkHeader)),
+                        MemPool::CHUNK_MEMORY_ALIGNMENT) +
+         details::align(
+             MemPool::freeList_t::requiredIndexMemorySize(chunkCount),
+             MemPool::CHUNK_MEMORY_ALIGNMENT) +
+         chunkCount *
+             (sizeof(ChunkManagement) + sizeof(MemPool::freeList_t::Index_t));
+}
+}  // namespace
+
+Config AllocationProfile::toConfig(
+    const std::vector<Entry>& entries, const double headroom,
+    const uint32_t maxNumberOfMemPools) noexcept {
+  EXPECTS(headroom >= 1.0);
+  EXPECTS(maxNumberOfMemPools > 0U);
+
+  /// sizes which end up with the same aligned chunk-payload size have to
+  /// share a mempool anyway
+  std::vector<Demand> demands;
+  for (const auto& entry : entries) {
+    const uint32_t payloadSize =
+        entry.m_requiredChunkSize > sizeof(ChunkHeader)
+            ? entry.m_requiredChunkSize -
+                  static_cast<uint32_t>(sizeof(ChunkHeader))
+            : 0U;
+    const auto chunkPayloadSize = static_cast<uint32_t>(
+        std::max(details::align(static_cast<uint64_t>(payloadSize),
+                                MemPool::CHUNK_MEMORY_ALIGNMENT),
+                 MemPool::CHUNK_MEMORY_ALIGNMENT));
+    if (!demands.empty() &&
+        demands.back().m_chunkPayloadSize == chunkPayloadSize) {
+      demands.back().m_peakInUse += entry.m_peakInUse;
+    } else {
+      demands.push_back({chunkPayloadSize, entry.m_peakInUse});
+    }
+  }
+
+  Config config;
+  const auto numberOfDemands = static_cast<uint32_t>(demands.size());
+  if (numberOfDemands == 0U) {
+    return config;
+  }
+
+  std::vector<uint64_t> peakPrefixSum(numberOfDemands + 1U, 0U);
+  for (uint32_t i = 0U; i < numberOfDemands; ++i) {
+    peakPrefixSum[i + 1U] = peakPrefixSum[i] + demands[i].m_peakInUse;
+  }
+  auto chunkCount = [&](const uint32_t first, const uint32_t last) {
+    const auto peak =
+        static_cast<double>(peakPrefixSum[last] - peakPrefixSum[first]);
+    const auto count = static_cast<uint64_t>(std::ceil(peak * headroom));
+    return std::min<uint64_t>(std::max<uint64_t>(count, 1U),
+                              std::numeric_limits<uint32_t>::max());
+  };
+
+  /// minSize[k][i] is the least memory for serving the first i sizes with k
+  /// mempools, the last one serving the sizes from split[k][i] to i
+  constexpr uint64_t UNREACHABLE{std::numeric_limits<uint64_t>::max()};
+  const uint32_t maxMemPools = std::min(
+      std::min(maxNumberOfMemPools, Config::MAX_NUMBER_OF_MEMPOOLS),
+      numberOfDemands);
+  std::vector<std::vector<uint64_t>> minSize(
+      maxMemPools + 1U,
+      std::vector<uint64_t>(numberOfDemands + 1U, UNREACHABLE));
+  std::vector<std::vector<uint32_t>> split(
+      maxMemPools + 1U, std::vector<uint32_t>(numberOfDemands + 1U, 0U));
+  minSize[0][0] = 0U;
+
+  for (uint32_t k = 1U; k <= maxMemPools; ++k) {
+    for (uint32_t i = k; i <= numberOfDemands; ++i) {
+      for (uint32_t j = k - 1U; j < i; ++j) {
+        if (minSize[k - 1U][j] == UNREACHABLE) {
+          continue;
+        }
+        const auto size =
+            minSize[k - 1U][j] +
+            requiredMemPoolMemorySize(demands[i - 1U].m_chunkPayloadSize,
+                                      chunkCount(j, i));
+        if (size < minSize[k][i]) {
+          minSize[k][i] = size;
+          split[k][i] = j;
+        }
+      }
+    }
+  }
+
+  uint32_t numberOfMemPools{1U};
+  for (uint32_t k = 2U; k <= maxMemPools; ++k) {
+    const auto& allSizes = minSize[k][numberOfDemands];
+    if (allSizes < minSize[numberOfMemPools][numberOfDemands]) {
+      numberOfMemPools = k;
+    }
+  }
+
+  std::vector<Config::Entry> memPools;
+  for (uint32_t k = numberOfMemPools, i = numberOfDemands; k > 0U; --k) {
+    const auto j = split[k][i];
+    memPools.push_back({demands[i - 1U].m_chunkPayloadSize,
+                        static_cast<uint32_t>(chunkCount(j, i))});
+    i = j;
+  }
+  std::reverse(memPools.begin(), memPools.end());
+  for (const auto& memPool : memPools) {
+    config.addMemPool(memPool);
+  }
+
+  return config;
+}
+
+}  // namespace memory
+}  // namespace shm
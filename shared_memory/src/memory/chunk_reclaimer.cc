@@ -0,0 +1,97 @@
+
+
+#include "memory/chunk_reclaimer.hpp"
+
+#include "memory/chunk_header.hpp"
+#include "memory/chunk_management.hpp"
+
+namespace shm {
+namespace memory {
+
+constexpr uint32_t ChunkReclaimer::BATCH_SIZE;
+constexpr uint32_t ChunkReclaimer::NUMBER_OF_BINS;
+
+ChunkReclaimer& ChunkReclaimer::forThisThread() noexcept {
+  static thread_local ChunkReclaimer reclaimer;
+  return reclaimer;
+}
+
+ChunkReclaimer::~ChunkReclaimer() noexcept {
+  flush();
+  /// a SharedChunk destroyed later during thread exit frees immediately
+  m_enabled = false;
+}
+
+void ChunkReclaimer::enable() noexcept { m_enabled = true; }
+
+void ChunkReclaimer::disable() noexcept {
+  flush();
+  m_enabled = false;
+}
+
+bool ChunkReclaimer::isEnabled() const noexcept { return m_enabled; }
+
+void ChunkReclaimer::reclaim(ChunkManagement* const chunkManagement) noexcept {
+  if (chunkManagement->isEmbedded()) {
+    /// the ChunkManagement goes back to the mempool with its chunk
+    park(chunkManagement->m_mempool.get(), chunkManagement->chunk());
+  } else {
+    park(chunkManagement->m_mempool.get(), chunkManagement->chunk());
+    park(chunkManagement->m_chunkManagementPool.get(), chunkManagement);
+  }
+}
+
+void ChunkReclaimer::park(MemPool* const memPool, void* const chunk) noexcept {
+  Bin* target{nullptr};
+  Bin* empty{nullptr};
+  for (auto& bin : m_bins) {
+    if (bin.m_memPool == memPool) {
+      target = &bin;
+      break;
+    }
+    if (empty == nullptr && bin.m_size == 0U) {
+      empty = &bin;
+    }
+  }
+
+  if (target == nullptr) {
+    target = empty;
+    if (target == nullptr) {
+      target = &m_bins[m_nextEviction];
+      m_nextEviction = (m_nextEviction + 1U) % NUMBER_OF_BINS;
+      drain(*target);
+    }
+    target->m_memPool = memPool;
+  }
+
+  target->m_chunks[target->m_size] = chunk;
+  ++target->m_size;
+  if (target->m_size == BATCH_SIZE) {
+    drain(*target);
+  }
+}
+
+void ChunkReclaimer::drain(Bin& bin) noexcept {
+  if (bin.m_size != 0U) {
+    bin.m_memPool->freeChunks(bin.m_chunks, bin.m_size);
+    bin.m_size = 0U;
+  }
+}
+
+void ChunkReclaimer::flush() noexcept {
+  for (auto& bin : m_bins) {
+    drain(bin);
+    bin.m_memPool = nullptr;
+  }
+}
+
+uint32_t ChunkReclaimer::size() const noexcept {
+  uint32_t parked{0U};
+  for (const auto& bin : m_bins) {
+    parked += bin.m_size;
+  }
+  return parked;
+}
+
+}  // namespace memory
+}  // namespace shm
@@ -8,6 +8,8 @@
 namespace shm {
 namespace memory {
 
+constexpr uint32_t Config::MAX_NUMBER_OF_MEMPOOLS;
+
 const Config::ConfigContainerType* Config::getMemPoolConfig() const noexcept {
   return &m_mempoolConfig;
 }
@@ -24,6 +26,26 @@ void Config::addMemPool(Config::Entry f_entry) noexcept {
   }
 }
 
+Config& Config::setFallbackPolicy(const FallbackPolicy policy) noexcept {
+  m_fallbackPolicy = policy;
+  return *this;
+}
+
+Config& Config::setNumaNodes(const uint32_t numaNodes) noexcept {
+  m_numaNodes = (numaNodes == 0U) ? 1U : numaNodes;
+  return *this;
+}
+
+Config& Config::setChunkLayout(const ChunkLayout layout) noexcept {
+  m_chunkLayout = layout;
+  return *this;
+}
+
+Config& Config::setThreadCache(const bool enabled) noexcept {
+  m_threadCache = enabled;
+  return *this;
+}
+
 /// this is the default memory pool configuration if no one is provided by the
 /// user
 Config& Config::setDefaults() noexcept {
@@ -0,0 +1,78 @@
+
+
+#include "memory/exhaustion_reporter.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <string>
+
+namespace shm {
+namespace memory {
+
+MemoryExhaustionReporter::MemoryExhaustionReporter(
+    const MemoryManager& memoryManager,
+    const Clock_t::duration interval) noexcept
+    : m_memoryManager(&memoryManager), m_interval(interval) {}
+
+uint64_t MemoryExhaustionReporter::poll(
+    const Clock_t::time_point now) noexcept {
+  if (m_hasReported && now - m_lastReport < m_interval) {
+    return 0U;
+  }
+
+  std::array<uint64_t, MemoryManager::NUMBER_OF_ERRORS> errorCounts{};
+  uint64_t failedLoans{0U};
+  for (uint32_t i = 0U; i < MemoryManager::NUMBER_OF_ERRORS; ++i) {
+    errorCounts[i] =
+        m_memoryManager->getErrorCount(static_cast<MemoryManager::Error>(i));
+    failedLoans += errorCounts[i] - m_reportedErrors[i];
+  }
+
+  /// a MemPoolCache refill can find a mempool empty without a loan failing
+  std::vector<MemPoolInfo> infos;
+  bool exhaustedMemPools{false};
+  const auto numberOfMemPools = m_memoryManager->getNumberOfMemPools();
+  m_reportedExhaustions.resize(numberOfMemPools, 0U);
+  for (uint32_t i = 0U; i < numberOfMemPools; ++i) {
+    infos.push_back(m_memoryManager->getMemPoolInfo(i));
+    exhaustedMemPools |= infos[i].m_exhaustedCount != m_reportedExhaustions[i];
+  }
+
+  if (failedLoans == 0U && !exhaustedMemPools) {
+    return 0U;
+  }
+
+  for (uint32_t i = 0U; i < numberOfMemPools; ++i) {
+    const auto& info = infos[i];
+    if (info.m_exhaustedCount != m_reportedExhaustions[i]) {
+      spdlog::warn(
+          "Mempool [ChunkSize = " + std::to_string(info.m_chunkSize) +
+          ", ChunkCount = " + std::to_string(info.m_numChunks) +
+          ", UsedChunks = " + std::to_string(info.m_usedChunks) +
+          ", MinFree = " + std::to_string(info.m_minFreeChunks) +
+          " ] ran out of chunks " +
+          std::to_string(info.m_exhaustedCount - m_reportedExhaustions[i]) +
+          " times since the last report");
+      m_reportedExhaustions[i] = info.m_exhaustedCount;
+    }
+  }
+
+  for (uint32_t i = 0U; i < MemoryManager::NUMBER_OF_ERRORS; ++i) {
+    if (errorCounts[i] != m_reportedErrors[i]) {
+      spdlog::error(
+          "MemoryManager: " + std::to_string(errorCounts[i] -
+                                             m_reportedErrors[i]) +
+          " loans failed with " +
+          asStringLiteral(static_cast<MemoryManager::Error>(i)) +
+          " since the last report");
+      m_reportedErrors[i] = errorCounts[i];
+    }
+  }
+
+  m_lastReport = now;
+  m_hasReported = true;
+  return failedLoans;
+}
+
+}  // namespace memory
+}  // namespace shm
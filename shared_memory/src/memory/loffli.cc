@@ -90,5 +90,93 @@ bool LoFFLi::push(const Index_t index) noexcept {
   return true;
 }
 
+uint32_t LoFFLi::pop_n(Index_t* const indices, const uint32_t count) noexcept {
+  if (count == 0U) {
+    return 0U;
+  }
+
+  Node oldHead = m_head.load(std::memory_order_acquire);
+  Node newHead = oldHead;
+  uint32_t popped{0U};
+
+  do {
+    if (oldHead.indexToNextFreeIndex >= m_size || !m_nextFreeIndex) {
+      return 0U;
+    }
+
+    /// walk the chain behind the head; the links of free elements only change
+    /// after they were popped, which changes the head, so a chain read while
+    /// another thread pops or pushes is discarded by the failing CAS
+    popped = 0U;
+    Index_t next = oldHead.indexToNextFreeIndex;
+    while (popped < count && next < m_size) {
+      indices[popped] = next;
+      ++popped;
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) upper
+      // limit of index set by m_size
+      next = m_nextFreeIndex.get()[next];
+    }
+
+    newHead.indexToNextFreeIndex = next;
+    newHead.abaCounter = oldHead.abaCounter + 1;
+  } while (!m_head.compare_exchange_weak(
+      oldHead, newHead, std::memory_order_acq_rel, std::memory_order_acquire));
+
+  for (uint32_t i = 0U; i < popped; ++i) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    m_nextFreeIndex.get()[indices[i]] = m_invalidIndex;
+  }
+
+  /// same as in pop, synchronize with the validity check in push
+  std::atomic_thread_fence(std::memory_order_release);
+
+  return popped;
+}
+
+bool LoFFLi::push_n(const Index_t* const indices,
+                    const uint32_t count) noexcept {
+  if (count == 0U) {
+    return true;
+  }
+
+  /// we synchronize with m_nextFreeIndex in pop to perform the validity check
+  std::atomic_thread_fence(std::memory_order_release);
+
+  /// link the indices to a chain before it is published; an index is marked
+  /// as soon as it is linked, so an index passed twice fails the check like a
+  /// double free and every link made so far is reverted
+  for (uint32_t i = 0U; i < count; ++i) {
+    const Index_t index = indices[i];
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) index is
+    // limited by capacity
+    if (index >= m_size || !m_nextFreeIndex ||
+        m_nextFreeIndex.get()[index] != m_invalidIndex) {
+      for (uint32_t j = 0U; j < i; ++j) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        m_nextFreeIndex.get()[indices[j]] = m_invalidIndex;
+      }
+      return false;
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    m_nextFreeIndex.get()[index] = (i + 1U < count) ? indices[i + 1U] : m_size;
+  }
+
+  const Index_t first = indices[0];
+  const Index_t last = indices[count - 1U];
+  Node oldHead = m_head.load(std::memory_order_acquire);
+  Node newHead = oldHead;
+
+  do {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) index is
+    // limited by capacity
+    m_nextFreeIndex.get()[last] = oldHead.indexToNextFreeIndex;
+    newHead.indexToNextFreeIndex = first;
+    newHead.abaCounter = oldHead.abaCounter + 1;
+  } while (!m_head.compare_exchange_weak(
+      oldHead, newHead, std::memory_order_acq_rel, std::memory_order_acquire));
+
+  return true;
+}
+
 }  // namespace memory
 }  // namespace shm
\ No newline at end of file
@@ -7,18 +7,33 @@
 #include <cstdlib>
 #include <ostream>
 
+#include "memory/chunk_reclaimer.hpp"
+#include "memory/thread_cache.hpp"
 #include "shm/algorithm.hpp"
 #include "shm/memory.hpp"
+#include "shm/numa.hpp"
+#include "shm/system_call.hpp"
 #include "shm/utils.h"
 
 namespace shm {
 namespace memory {
 
+MemoryManager::~MemoryManager() noexcept {
+  auto& threadCache = ThreadCache::forThisThread();
+  for (const auto& memPool : m_memPoolVector) {
+    threadCache.flush(*memPool);
+  }
+  for (const auto& memPool : m_chunkManagementPool) {
+    threadCache.flush(*memPool);
+  }
+}
+
 void MemoryManager::printMemPoolVector(std::ostream& log) const noexcept {
   for (auto& l_mempool : m_memPoolVector) {
     log << "  MemPool [ ChunkSize = " << l_mempool->getChunkSize()
         << ", ChunkPayloadSize = "
-        << l_mempool->getChunkSize() - sizeof(ChunkHeader)
+        << l_mempool->getChunkSize() - sizeof(ChunkHeader) -
+               m_chunkHeaderOffset
         << ", ChunkCount = " << l_mempool->getChunkCount() << " ]";
   }
 }
@@ -28,8 +43,8 @@ void MemoryManager::addMemPool(
     const greater_or_equal<uint32_t, MemPool::CHUNK_MEMORY_ALIGNMENT>
         chunkPayloadSize,
     const greater_or_equal<uint32_t, 1> numberOfChunks) noexcept {
-  uint32_t adjustedChunkSize =
-      sizeWithChunkHeaderStruct(static_cast<uint32_t>(chunkPayloadSize));
+  uint32_t adjustedChunkSize = memPoolChunkSize(
+      static_cast<uint32_t>(chunkPayloadSize), m_chunkLayout);
   if (m_denyAddMemPool) {
     spdlog::error(
         "After the generation of the chunk management pool you are not "
@@ -38,7 +53,7 @@ void MemoryManager::addMemPool(
     // errorHandler(
     //     iox::PoshError::
     //         MEPOO__MEMPOOL_ADDMEMPOOL_AFTER_GENERATECHUNKMANAGEMENTPOOL);
-  } else if (m_memPoolVector.size() > 0 &&
+  } else if (m_memPoolVector.size() % m_memPoolsPerNumaNode != 0U &&
              adjustedChunkSize <= m_memPoolVector.back()->getChunkSize()) {
     spdlog::error(
         "The following mempools were already added to the mempool handler:");
@@ -47,23 +62,55 @@ void MemoryManager::addMemPool(
 
   m_memPoolVector.emplace_back(
       std::make_unique<MemPool>(adjustedChunkSize, numberOfChunks,
-                                managementAllocator, chunkMemoryAllocator));
+                                managementAllocator, chunkMemoryAllocator,
+                                m_chunkHeaderOffset));
   m_totalNumberOfChunks += numberOfChunks;
 }
 
 void MemoryManager::generateChunkManagementPool(
     BumpAllocator& managementAllocator) noexcept {
   m_denyAddMemPool = true;
+  if (m_chunkLayout == Config::ChunkLayout::EMBEDDED_MANAGEMENT) {
+    return;
+  }
   uint32_t chunkSize = sizeof(ChunkManagement);
   m_chunkManagementPool.emplace_back(
       std::make_unique<MemPool>(chunkSize, m_totalNumberOfChunks,
                                 managementAllocator, managementAllocator));
 }
 
+void MemoryManager::bindMemPoolsToNumaNode(const uint32_t numaNode) noexcept {
+  // pages shared with the neighbouring node are left to first touch
+  const auto& firstMemPool = m_memPoolVector[m_memPoolVector.size() -
+                                             m_memPoolsPerNumaNode];
+  const auto& lastMemPool = m_memPoolVector.back();
+  const auto page = pageSize();
+  const auto begin = align(
+      reinterpret_cast<uint64_t>(firstMemPool->getRawMemory()), page);
+  const auto end =
+      (reinterpret_cast<uint64_t>(lastMemPool->getRawMemory()) +
+       static_cast<uint64_t>(lastMemPool->getChunkCount()) *
+           lastMemPool->getChunkSize()) /
+      page * page;
+  if (end <= begin) {
+    return;
+  }
+  if (!details::setNumaPolicy(reinterpret_cast<void*>(begin), end - begin,
+                              details::NumaPolicy::BIND, numaNode)) {
+    spdlog::warn("Unable to place the mempools of NUMA node " +
+                 std::to_string(numaNode) +
+                 " on it, they are placed on first touch");
+  }
+}
+
 uint32_t MemoryManager::getNumberOfMemPools() const noexcept {
   return static_cast<uint32_t>(m_memPoolVector.size());
 }
 
+uint32_t MemoryManager::getNumberOfNumaNodes() const noexcept {
+  return m_numaNodes;
+}
+
 MemPoolInfo MemoryManager::getMemPoolInfo(const uint32_t index) const noexcept {
   if (index >= m_memPoolVector.size()) {
     return {0, 0, 0, 0};
@@ -71,38 +118,142 @@ MemPoolInfo MemoryManager::getMemPoolInfo(const uint32_t index) const noexcept {
   return m_memPoolVector[index]->getInfo();
 }
 
+uint64_t MemoryManager::getErrorCount(const Error error) const noexcept {
+  return m_errorCounts[static_cast<uint32_t>(error)].load(
+      std::memory_order_relaxed);
+}
+
+void MemoryManager::setAllocationProfile(
+    AllocationProfile* const profile) noexcept {
+  m_allocationProfile = profile;
+  auto& threadCache = ThreadCache::forThisThread();
+  for (auto& memPool : m_memPoolVector) {
+    memPool->setAllocationProfile(profile);
+    /// a release is recorded when the chunk reaches the mempool, so profiled
+    /// loans bypass the caches
+    memPool->setThreadCached(m_threadCache && profile == nullptr);
+    threadCache.flush(*memPool);
+  }
+}
+
 uint32_t MemoryManager::sizeWithChunkHeaderStruct(
     const MaxChunkPayloadSize_t size) noexcept {
   return size + static_cast<uint32_t>(sizeof(ChunkHeader));
 }
 
+uint32_t MemoryManager::memPoolChunkSize(
+    const MaxChunkPayloadSize_t size,
+    const Config::ChunkLayout layout) noexcept {
+  if (layout == Config::ChunkLayout::EMBEDDED_MANAGEMENT) {
+    static_assert(sizeof(ChunkManagement) <=
+                      ChunkManagement::EMBEDDED_PREFIX_SIZE,
+                  "The ChunkManagement must fit into the prefix of a chunk");
+    return align(sizeWithChunkHeaderStruct(size) +
+                     ChunkManagement::EMBEDDED_PREFIX_SIZE,
+                 ChunkManagement::EMBEDDED_PREFIX_SIZE);
+  }
+  return sizeWithChunkHeaderStruct(size);
+}
+
+Config::ConfigContainerType MemoryManager::memPoolEntries(
+    const Config& mePooConfig) noexcept {
+  if (mePooConfig.m_chunkLayout != Config::ChunkLayout::EMBEDDED_MANAGEMENT) {
+    return mePooConfig.m_mempoolConfig;
+  }
+  Config::ConfigContainerType entries;
+  for (const auto& entry : mePooConfig.m_mempoolConfig) {
+    if (!entries.empty() &&
+        memPoolChunkSize(entries.back().m_size, mePooConfig.m_chunkLayout) ==
+            memPoolChunkSize(entry.m_size, mePooConfig.m_chunkLayout)) {
+      entries.back().m_size = entry.m_size;
+      entries.back().m_chunkCount += entry.m_chunkCount;
+    } else {
+      entries.push_back(entry);
+    }
+  }
+  return entries;
+}
+
+constexpr uint32_t MemoryManager::NUMBER_OF_ERRORS;
+constexpr uint32_t MemoryManager::SIZE_CLASS_SUB_BITS;
+constexpr uint32_t MemoryManager::NUMBER_OF_SIZE_CLASSES;
+
+uint32_t MemoryManager::sizeClass(const uint32_t size) noexcept {
+  constexpr uint32_t SUB_CLASSES{1U << SIZE_CLASS_SUB_BITS};
+  if (size < SUB_CLASSES) {
+    return size;
+  }
+  const auto log2 = 31U - static_cast<uint32_t>(__builtin_clz(size));
+  const auto subClass =
+      (size >> (log2 - SIZE_CLASS_SUB_BITS)) & (SUB_CLASSES - 1U);
+  return ((log2 - SIZE_CLASS_SUB_BITS + 1U) << SIZE_CLASS_SUB_BITS) + subClass;
+}
+
+uint32_t MemoryManager::sizeClassLowerBound(const uint32_t sizeClass) noexcept {
+  constexpr uint32_t SUB_CLASSES{1U << SIZE_CLASS_SUB_BITS};
+  if (sizeClass < SUB_CLASSES) {
+    return sizeClass;
+  }
+  const auto log2 =
+      (sizeClass >> SIZE_CLASS_SUB_BITS) + SIZE_CLASS_SUB_BITS - 1U;
+  const auto subClass = sizeClass & (SUB_CLASSES - 1U);
+  return (1U << log2) | (subClass << (log2 - SIZE_CLASS_SUB_BITS));
+}
+
+void MemoryManager::generateSizeClassLookup() noexcept {
+  const auto numberOfMemPools = m_memPoolsPerNumaNode;
+  uint32_t index{0U};
+  for (uint32_t sizeClass = 0U; sizeClass < NUMBER_OF_SIZE_CLASSES;
+       ++sizeClass) {
+    const auto lowerBound = sizeClassLowerBound(sizeClass);
+    while (index < numberOfMemPools &&
+           m_memPoolVector[index]->getChunkSize() < lowerBound) {
+      ++index;
+    }
+    m_sizeClassToMemPool[sizeClass] = static_cast<uint8_t>(index);
+  }
+}
+
 uint64_t MemoryManager::requiredChunkMemorySize(
     const Config& mePooConfig) noexcept {
+  const bool embedded =
+      mePooConfig.m_chunkLayout == Config::ChunkLayout::EMBEDDED_MANAGEMENT;
   uint64_t memorySize{0};
-  for (const auto& mempoolConfig : mePooConfig.m_mempoolConfig) {
+  for (const auto& mempoolConfig : memPoolEntries(mePooConfig)) {
     // for the required chunk memory size only the size of the ChunkHeader
     // and the the chunk-payload size is taken into account;
     // the user has the option to further partition the chunk-payload with
     // a user-header and therefore reduce the user-payload size
     memorySize += details::align(
         static_cast<uint64_t>(mempoolConfig.m_chunkCount) *
-            MemoryManager::sizeWithChunkHeaderStruct(mempoolConfig.m_size),
+            MemoryManager::memPoolChunkSize(mempoolConfig.m_size,
+                                            mePooConfig.m_chunkLayout),
         MemPool::CHUNK_MEMORY_ALIGNMENT);
+    if (embedded) {
+      // worst case padding to align the chunks to cache lines
+      memorySize += ChunkManagement::EMBEDDED_PREFIX_SIZE -
+                    MemPool::CHUNK_MEMORY_ALIGNMENT;
+    }
   }
-  return memorySize;
+  return memorySize * mePooConfig.m_numaNodes;
 }
 
 uint64_t MemoryManager::requiredManagementMemorySize(
     const Config& mePooConfig) noexcept {
   uint64_t memorySize{0U};
   uint64_t sumOfAllChunks{0U};
-  for (const auto& mempool : mePooConfig.m_mempoolConfig) {
+  for (const auto& mempool : memPoolEntries(mePooConfig)) {
     sumOfAllChunks += mempool.m_chunkCount;
     memorySize += align(
         MemPool::freeList_t::requiredIndexMemorySize(mempool.m_chunkCount),
         MemPool::CHUNK_MEMORY_ALIGNMENT);
   }
+  memorySize *= mePooConfig.m_numaNodes;
+  sumOfAllChunks *= mePooConfig.m_numaNodes;
 
+  if (mePooConfig.m_chunkLayout == Config::ChunkLayout::EMBEDDED_MANAGEMENT) {
+    return memorySize;
+  }
   memorySize += align(sumOfAllChunks * sizeof(ChunkManagement),
                       MemPool::CHUNK_MEMORY_ALIGNMENT);
   memorySize +=
@@ -121,51 +272,140 @@ uint64_t MemoryManager::requiredFullMemorySize(
 void MemoryManager::configureMemoryManager(
     const Config& mePooConfig, BumpAllocator& managementAllocator,
     BumpAllocator& chunkMemoryAllocator) noexcept {
-  for (auto entry : mePooConfig.m_mempoolConfig) {
-    addMemPool(managementAllocator, chunkMemoryAllocator, entry.m_size,
-               entry.m_chunkCount);
+  m_numaNodes = mePooConfig.m_numaNodes;
+  m_chunkLayout = mePooConfig.m_chunkLayout;
+  m_chunkHeaderOffset =
+      (m_chunkLayout == Config::ChunkLayout::EMBEDDED_MANAGEMENT)
+          ? ChunkManagement::EMBEDDED_PREFIX_SIZE
+          : 0U;
+  const auto entries = memPoolEntries(mePooConfig);
+  m_memPoolsPerNumaNode = static_cast<uint32_t>(entries.size());
+  for (uint32_t numaNode = 0U;
+       numaNode < m_numaNodes && m_memPoolsPerNumaNode != 0U; ++numaNode) {
+    for (auto entry : entries) {
+      addMemPool(managementAllocator, chunkMemoryAllocator, entry.m_size,
+                 entry.m_chunkCount);
+    }
+    if (m_numaNodes > 1U) {
+      bindMemPoolsToNumaNode(numaNode);
+    }
   }
 
   generateChunkManagementPool(managementAllocator);
+  generateSizeClassLookup();
+  m_fallbackPolicy = mePooConfig.m_fallbackPolicy;
+
+  m_threadCache = mePooConfig.m_threadCache;
+  for (auto& memPool : m_memPoolVector) {
+    memPool->setThreadCached(m_threadCache);
+  }
+  for (auto& memPool : m_chunkManagementPool) {
+    memPool->setThreadCached(m_threadCache);
+  }
+}
+
+tl::unexpected<MemoryManager::Error> MemoryManager::countError(
+    const Error error) noexcept {
+  m_errorCounts[static_cast<uint32_t>(error)].fetch_add(
+      1U, std::memory_order_relaxed);
+  return tl::make_unexpected(error);
 }
 
 tl::expected<SharedChunk, MemoryManager::Error> MemoryManager::getChunk(
     const ChunkSettings& chunkSettings) noexcept {
-  void* chunk{nullptr};
-  MemPool* memPoolPointer{nullptr};
+  // getcpu is cheap, but a single set of mempools doesn't need it at all
+  return getChunk(chunkSettings,
+                  (m_numaNodes > 1U) ? details::currentNumaNode() : 0U);
+}
+
+tl::expected<SharedChunk, MemoryManager::Error> MemoryManager::getChunk(
+    const ChunkSettings& chunkSettings, const uint32_t numaNode) noexcept {
   const auto requiredChunkSize = chunkSettings.requiredChunkSize();
+  const auto requiredMemPoolChunkSize = requiredChunkSize + m_chunkHeaderOffset;
 
-  uint32_t aquiredChunkSize = 0U;
+  if (m_memPoolVector.size() == 0) {
+    return countError(Error::NO_MEMPOOLS_AVAILABLE);
+  }
 
-  for (auto& memPool : m_memPoolVector) {
-    uint32_t chunkSizeOfMemPool = memPool->getChunkSize();
-    if (chunkSizeOfMemPool >= requiredChunkSize) {
-      chunk = memPool->getChunk();
-      memPoolPointer = &(*memPool);
-      aquiredChunkSize = chunkSizeOfMemPool;
-      break;
+  /// only mempools of the same size class can still be too small; the
+  /// mempool sets of all nodes are alike, so the first one is searched
+  const auto numberOfMemPools = m_memPoolsPerNumaNode;
+  uint32_t fittingIndex =
+      m_sizeClassToMemPool[sizeClass(requiredMemPoolChunkSize)];
+  while (fittingIndex < numberOfMemPools &&
+         m_memPoolVector[fittingIndex]->getChunkSize() <
+             requiredMemPoolChunkSize) {
+    ++fittingIndex;
+  }
+
+  if (fittingIndex == numberOfMemPools) {
+    return countError(Error::NO_MEMPOOL_FOR_REQUESTED_CHUNK_SIZE);
+  }
+
+  const uint32_t localNode = numaNode % m_numaNodes;
+  MemPool* memPoolPointer{nullptr};
+  void* chunk{nullptr};
+  auto& reclaimer = ChunkReclaimer::forThisThread();
+  /// an exhausted mempool is only counted once per loan
+  bool retry{false};
+  const auto take = [&retry](MemPool& memPool) {
+    return retry ? memPool.tryGetChunk() : ThreadCache::getChunk(memPool);
+  };
+  do {
+    for (uint32_t i = 0U; i < m_numaNodes && chunk == nullptr; ++i) {
+      const auto firstMemPool =
+          ((localNode + i) % m_numaNodes) * m_memPoolsPerNumaNode;
+      uint32_t index = fittingIndex;
+      memPoolPointer = m_memPoolVector[firstMemPool + index].get();
+      chunk = take(*memPoolPointer);
+      if (chunk == nullptr &&
+          m_fallbackPolicy == Config::FallbackPolicy::NEXT_LARGER_MEMPOOL) {
+        for (++index; index < numberOfMemPools && chunk == nullptr; ++index) {
+          memPoolPointer = m_memPoolVector[firstMemPool + index].get();
+          chunk = take(*memPoolPointer);
+        }
+      }
+    }
+    /// the chunks this thread has parked for a bulk release may be all that
+    /// is left; hand them back and search once more
+    retry = (chunk == nullptr && !retry && reclaimer.size() > 0U);
+    if (retry) {
+      reclaimer.flush();
     }
+  } while (retry);
+
+  if (chunk == nullptr) {
+    return countError(Error::MEMPOOL_OUT_OF_CHUNKS);
   }
 
-  if (m_memPoolVector.size() == 0) {
-    spdlog::error("There are no mempools available!");
+  if (m_allocationProfile != nullptr) {
+    m_allocationProfile->recordAcquire(requiredChunkSize);
+  }
+  const uint32_t aquiredChunkSize =
+      memPoolPointer->getChunkSize() - m_chunkHeaderOffset;
+  if (m_chunkLayout == Config::ChunkLayout::EMBEDDED_MANAGEMENT) {
+    new (static_cast<uint8_t*>(chunk) + m_chunkHeaderOffset)
+        ChunkHeader(aquiredChunkSize, chunkSettings);
+    return SharedChunk(new (chunk) ChunkManagement(memPoolPointer));
+  }
 
-    return tl::make_unexpected(Error::NO_MEMPOOLS_AVAILABLE);
-  } else if (memPoolPointer == nullptr) {
-    spdlog::error("The following mempools are available:");
-    return tl::make_unexpected(Error::NO_MEMPOOL_FOR_REQUESTED_CHUNK_SIZE);
-  } else if (chunk == nullptr) {
-    spdlog::error(
-        "MemoryManager: unable to acquire a chunk with a chunk-payload size "
-        "of ");
-    return tl::make_unexpected(Error::MEMPOOL_OUT_OF_CHUNKS);
-  } else {
-    auto chunkHeader = new (chunk) ChunkHeader(aquiredChunkSize, chunkSettings);
-    auto chunkManagement =
-        new (m_chunkManagementPool.front()->getChunk()) ChunkManagement(
-            chunkHeader, memPoolPointer, &(*m_chunkManagementPool.front()));
-    return SharedChunk(chunkManagement);
+  auto chunkHeader = new (chunk) ChunkHeader(aquiredChunkSize, chunkSettings);
+  /// parked ChunkManagements are evicted independently of their chunks and
+  /// other threads may park some as well, so this pool can run dry first
+  auto& chunkManagementPool = *m_chunkManagementPool.front();
+  void* chunkManagementMemory = ThreadCache::getChunk(chunkManagementPool);
+  if (chunkManagementMemory == nullptr && reclaimer.size() > 0U) {
+    reclaimer.flush();
+    chunkManagementMemory = chunkManagementPool.tryGetChunk();
+  }
+  if (chunkManagementMemory == nullptr) {
+    /// balances the recorded acquire when a profile is attached
+    ThreadCache::freeChunk(*memPoolPointer, chunk);
+    return countError(Error::MEMPOOL_OUT_OF_CHUNKS);
   }
+  auto chunkManagement = new (chunkManagementMemory)
+      ChunkManagement(chunkHeader, memPoolPointer, &chunkManagementPool);
+  return SharedChunk(chunkManagement);
 }
 
 std::ostream& operator<<(std::ostream& stream,
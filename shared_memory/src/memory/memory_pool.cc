@@ -4,34 +4,43 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <string>
 
+#include "memory/allocation_profile.hpp"
+
 namespace shm {
 namespace memory {
 
 MemPoolInfo::MemPoolInfo(const uint32_t usedChunks,
                          const uint32_t minFreeChunks, const uint32_t numChunks,
-                         const uint32_t chunkSize) noexcept
+                         const uint32_t chunkSize,
+                         const uint64_t exhaustedCount) noexcept
     : m_usedChunks(usedChunks),
       m_minFreeChunks(minFreeChunks),
       m_numChunks(numChunks),
-      m_chunkSize(chunkSize) {}
+      m_chunkSize(chunkSize),
+      m_exhaustedCount(exhaustedCount) {}
 
 constexpr uint64_t MemPool::CHUNK_MEMORY_ALIGNMENT;
+constexpr uint32_t MemPool::MAX_BATCH_SIZE;
 
 MemPool::MemPool(
     const greater_or_equal<uint32_t, CHUNK_MEMORY_ALIGNMENT> chunkSize,
     const greater_or_equal<uint32_t, 1> numberOfChunks,
     BumpAllocator& managementAllocator,
-    BumpAllocator& chunkMemoryAllocator) noexcept
+    BumpAllocator& chunkMemoryAllocator,
+    const uint32_t chunkHeaderOffset) noexcept
     : m_chunkSize(chunkSize),
+      m_chunkHeaderOffset(chunkHeaderOffset),
       m_numberOfChunks(numberOfChunks),
       m_minFree(numberOfChunks) {
   if (isMultipleOfAlignment(chunkSize)) {
     auto allocationResult = chunkMemoryAllocator.allocate(
         static_cast<uint64_t>(m_numberOfChunks) * m_chunkSize,
-        CHUNK_MEMORY_ALIGNMENT);
+        std::max(CHUNK_MEMORY_ALIGNMENT,
+                 static_cast<uint64_t>(m_chunkHeaderOffset)));
     EXPECTS(allocationResult.has_value());
     m_rawMemory = static_cast<uint8_t*>(allocationResult.value());
 
@@ -60,33 +69,59 @@ bool MemPool::isMultipleOfAlignment(const uint32_t value) const noexcept {
   return (value % CHUNK_MEMORY_ALIGNMENT == 0U);
 }
 
-void MemPool::adjustMinFree() noexcept {
-  // @todo iox-#1714 rethink the concurrent change that can happen. do we need a
-  // CAS loop?
-  m_minFree.store(
-      std::min(m_numberOfChunks - m_usedChunks.load(std::memory_order_relaxed),
-               m_minFree.load(std::memory_order_relaxed)));
+void MemPool::adjustMinFree(const uint32_t usedChunks) noexcept {
+  /// usedChunks is the value this thread set, so a concurrent free can't make
+  /// m_minFree miss the minimum; the CAS keeps a lower value stored meanwhile
+  const uint32_t freeChunks = m_numberOfChunks - usedChunks;
+  uint32_t minFree = m_minFree.load(std::memory_order_relaxed);
+  while (freeChunks < minFree &&
+         !m_minFree.compare_exchange_weak(minFree, freeChunks,
+                                          std::memory_order_relaxed)) {
+  }
 }
 
 void* MemPool::getChunk() noexcept {
+  void* chunk = tryGetChunk();
+  if (chunk == nullptr) {
+    m_exhaustedCount.fetch_add(1U, std::memory_order_relaxed);
+  }
+  return chunk;
+}
+
+void* MemPool::tryGetChunk() noexcept {
   uint32_t index{0U};
   if (!m_freeIndices.pop(index)) {
-    spdlog::warn("Mempool [m_chunkSize = " + std::to_string(m_chunkSize) +
-                 ", numberOfChunks = " + std::to_string(m_numberOfChunks) +
-                 ", used_chunks = " + std::to_string(m_usedChunks.load()) +
-                 " ] has no more space left");
     return nullptr;
   }
 
-  /// @todo iox-#1714 verify that m_usedChunk is not changed during
-  /// adjustMInFree
-  ///         without changing m_minFree
-  m_usedChunks.fetch_add(1U, std::memory_order_relaxed);
-  adjustMinFree();
+  adjustMinFree(m_usedChunks.fetch_add(1U, std::memory_order_relaxed) + 1U);
 
   return indexToPointer(index, m_chunkSize, m_rawMemory.get());
 }
 
+uint32_t MemPool::getChunks(void** const chunks,
+                            const uint32_t count) noexcept {
+  uint32_t obtained{0U};
+  freeList_t::Index_t indices[MAX_BATCH_SIZE];
+
+  while (obtained < count) {
+    const uint32_t popped = m_freeIndices.pop_n(
+        indices, std::min(count - obtained, MAX_BATCH_SIZE));
+    if (popped == 0U) {
+      break;
+    }
+    for (uint32_t i = 0U; i < popped; ++i) {
+      chunks[obtained + i] =
+          indexToPointer(indices[i], m_chunkSize, m_rawMemory.get());
+    }
+    obtained += popped;
+    adjustMinFree(m_usedChunks.fetch_add(popped, std::memory_order_relaxed) +
+                  popped);
+  }
+
+  return obtained;
+}
+
 void* MemPool::indexToPointer(uint32_t index, uint32_t chunkSize,
                               void* const rawMemoryBase) noexcept {
   const auto offset = static_cast<uint64_t>(index) * chunkSize;
@@ -105,23 +140,95 @@ uint32_t MemPool::pointerToIndex(const void* const chunk,
   return index;
 }
 
-void MemPool::freeChunk(const void* chunk) noexcept {
+void MemPool::checkChunkRange(const void* const chunk) const noexcept {
   const auto offsetToLastChunk =
       static_cast<uint64_t>(m_chunkSize) * (m_numberOfChunks - 1U);
   EXPECTS(m_rawMemory.get() <= chunk &&
           chunk <=
               static_cast<uint8_t*>(m_rawMemory.get()) + offsetToLastChunk);
+}
+
+void MemPool::freeChunk(const void* chunk) noexcept {
+  checkChunkRange(chunk);
+
+  const uint32_t requiredChunkSize =
+      (m_allocationProfile != nullptr)
+          ? AllocationProfile::requiredChunkSize(
+                static_cast<const uint8_t*>(chunk) + m_chunkHeaderOffset)
+          : 0U;
 
   const auto index = pointerToIndex(chunk, m_chunkSize, m_rawMemory.get());
 
   if (!m_freeIndices.push(index)) {
-    // TODO
-    // errorHandler(PoshError::POSH__MEMPOOL_POSSIBLE_DOUBLE_FREE);
+    spdlog::error("Possible double free of chunk " + std::to_string(index) +
+                  " of the MemPool with chunk size " +
+                  std::to_string(m_chunkSize));
+    return;
   }
 
+  if (m_allocationProfile != nullptr) {
+    m_allocationProfile->recordRelease(requiredChunkSize);
+  }
   m_usedChunks.fetch_sub(1U, std::memory_order_relaxed);
 }
 
+void MemPool::freeChunks(void* const* const chunks,
+                         const uint32_t count) noexcept {
+  freeList_t::Index_t indices[MAX_BATCH_SIZE];
+  /// read before the push, a pushed chunk can be reused right away
+  uint32_t requiredChunkSizes[MAX_BATCH_SIZE];
+
+  for (uint32_t done = 0U; done < count;) {
+    const uint32_t batch = std::min(count - done, MAX_BATCH_SIZE);
+    for (uint32_t i = 0U; i < batch; ++i) {
+      checkChunkRange(chunks[done + i]);
+      if (m_allocationProfile != nullptr) {
+        requiredChunkSizes[i] = AllocationProfile::requiredChunkSize(
+            static_cast<const uint8_t*>(chunks[done + i]) +
+            m_chunkHeaderOffset);
+      }
+      indices[i] =
+          pointerToIndex(chunks[done + i], m_chunkSize, m_rawMemory.get());
+    }
+
+    uint32_t pushed = batch;
+    if (m_freeIndices.push_n(indices, batch)) {
+      for (uint32_t i = 0U; i < batch && m_allocationProfile != nullptr; ++i) {
+        m_allocationProfile->recordRelease(requiredChunkSizes[i]);
+      }
+    } else {
+      /// a double free in the batch rejects all of it; return the valid
+      /// chunks one by one so only the offending ones are dropped
+      pushed = 0U;
+      for (uint32_t i = 0U; i < batch; ++i) {
+        if (m_freeIndices.push(indices[i])) {
+          ++pushed;
+          if (m_allocationProfile != nullptr) {
+            m_allocationProfile->recordRelease(requiredChunkSizes[i]);
+          }
+        } else {
+          spdlog::error("Possible double free of chunk " +
+                        std::to_string(indices[i]) + " of the MemPool with "
+                        "chunk size " + std::to_string(m_chunkSize));
+        }
+      }
+    }
+
+    m_usedChunks.fetch_sub(pushed, std::memory_order_relaxed);
+    done += batch;
+  }
+}
+
+void MemPool::setAllocationProfile(AllocationProfile* const profile) noexcept {
+  m_allocationProfile = profile;
+}
+
+void MemPool::setThreadCached(const bool threadCached) noexcept {
+  m_threadCached = threadCached;
+}
+
+bool MemPool::isThreadCached() const noexcept { return m_threadCached; }
+
 uint32_t MemPool::getChunkSize() const noexcept { return m_chunkSize; }
 
 uint32_t MemPool::getChunkCount() const noexcept { return m_numberOfChunks; }
@@ -134,11 +241,17 @@ uint32_t MemPool::getMinFree() const noexcept {
   return m_minFree.load(std::memory_order_relaxed);
 }
 
+uint64_t MemPool::getExhaustedCount() const noexcept {
+  return m_exhaustedCount.load(std::memory_order_relaxed);
+}
+
 MemPoolInfo MemPool::getInfo() const noexcept {
   return {m_usedChunks.load(std::memory_order_relaxed),
           m_minFree.load(std::memory_order_relaxed), m_numberOfChunks,
-          m_chunkSize};
+          m_chunkSize, m_exhaustedCount.load(std::memory_order_relaxed)};
 }
 
+void* MemPool::getRawMemory() const noexcept { return m_rawMemory.get(); }
+
 }  // namespace memory
 }  // namespace shm
\ No newline at end of file
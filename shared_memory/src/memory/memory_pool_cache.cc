@@ -0,0 +1,57 @@
+
+
+#include "memory/memory_pool_cache.hpp"
+
+#include <algorithm>
+
+namespace shm {
+namespace memory {
+
+constexpr uint32_t MemPoolCache::CAPACITY;
+constexpr uint32_t MemPoolCache::BATCH_SIZE;
+
+MemPoolCache::MemPoolCache(MemPool& memPool) noexcept : m_memPool(&memPool) {}
+
+MemPoolCache::~MemPoolCache() noexcept { flush(); }
+
+void* MemPoolCache::getChunk() noexcept {
+  if (m_size == 0U) {
+    m_size = m_memPool->getChunks(m_chunks, BATCH_SIZE);
+    if (m_size == 0U) {
+      /// another cache may have returned a chunk meanwhile, the MemPool also
+      /// counts the exhaustion
+      return m_memPool->getChunk();
+    }
+  }
+
+  --m_size;
+  return m_chunks[m_size];
+}
+
+void MemPoolCache::freeChunk(const void* chunk) noexcept {
+  if (m_size == CAPACITY) {
+    drain(BATCH_SIZE);
+  }
+
+  m_chunks[m_size] = const_cast<void*>(chunk);
+  ++m_size;
+}
+
+void MemPoolCache::flush() noexcept { drain(m_size); }
+
+void MemPoolCache::drain(const uint32_t count) noexcept {
+  if (count == 0U) {
+    return;
+  }
+
+  m_memPool->freeChunks(m_chunks, count);
+  std::copy(m_chunks + count, m_chunks + m_size, m_chunks);
+  m_size -= count;
+}
+
+uint32_t MemPoolCache::size() const noexcept { return m_size; }
+
+MemPool& MemPoolCache::getMemPool() const noexcept { return *m_memPool; }
+
+}  // namespace memory
+}  // namespace shm
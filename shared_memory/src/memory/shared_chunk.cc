@@ -3,11 +3,15 @@
 #include "memory/shared_chunk.hpp"
 
 #include "memory/chunk_header.hpp"
+#include "memory/chunk_reclaimer.hpp"
 #include "memory/memory_pool.hpp"
+#include "memory/thread_cache.hpp"
 
 namespace shm {
 namespace memory {
 
+constexpr uint32_t ChunkManagement::EMBEDDED_PREFIX_SIZE;
+
 SharedChunk::SharedChunk(ChunkManagement* const resource) noexcept
     : m_chunkManagement(resource) {}
 
@@ -33,9 +37,19 @@ void SharedChunk::decrementReferenceCounter() noexcept {
 }
 
 void SharedChunk::freeChunk() noexcept {
-  m_chunkManagement->m_mempool->freeChunk(
-      static_cast<void*>(m_chunkManagement->m_chunkHeader.get()));
-  m_chunkManagement->m_chunkManagementPool->freeChunk(m_chunkManagement);
+  auto& reclaimer = ChunkReclaimer::forThisThread();
+  if (reclaimer.isEnabled()) {
+    reclaimer.reclaim(m_chunkManagement);
+  } else if (m_chunkManagement->isEmbedded()) {
+    /// the ChunkManagement goes back to the mempool with its chunk
+    ThreadCache::freeChunk(*m_chunkManagement->m_mempool.get(),
+                           m_chunkManagement->chunk());
+  } else {
+    ThreadCache::freeChunk(*m_chunkManagement->m_mempool.get(),
+                           m_chunkManagement->chunk());
+    ThreadCache::freeChunk(*m_chunkManagement->m_chunkManagementPool.get(),
+                           m_chunkManagement);
+  }
   m_chunkManagement = nullptr;
 }
 
@@ -61,7 +75,7 @@ void* SharedChunk::getUserPayload() const noexcept {
   if (m_chunkManagement == nullptr) {
     return nullptr;
   } else {
-    return m_chunkManagement->m_chunkHeader->userPayload();
+    return m_chunkManagement->chunkHeader()->userPayload();
   }
 }
 
@@ -87,7 +101,7 @@ SharedChunk::operator bool() const noexcept {
 
 ChunkHeader* SharedChunk::getChunkHeader() const noexcept {
   if (m_chunkManagement != nullptr) {
-    return m_chunkManagement->m_chunkHeader.get();
+    return m_chunkManagement->chunkHeader();
   } else {
     return nullptr;
   }
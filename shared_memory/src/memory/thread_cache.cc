@@ -0,0 +1,82 @@
+
+#include "memory/thread_cache.hpp"
+
+namespace shm {
+namespace memory {
+
+constexpr uint32_t ThreadCache::NUMBER_OF_CACHES;
+
+ThreadCache& ThreadCache::forThisThread() noexcept {
+  static thread_local ThreadCache threadCache;
+  return threadCache;
+}
+
+void* ThreadCache::getChunk(MemPool& memPool) noexcept {
+  auto& threadCache = forThisThread();
+  if (memPool.isThreadCached() && threadCache.m_enabled) {
+    return threadCache.cacheOf(memPool).getChunk();
+  }
+  return memPool.getChunk();
+}
+
+void ThreadCache::freeChunk(MemPool& memPool, const void* chunk) noexcept {
+  auto& threadCache = forThisThread();
+  if (memPool.isThreadCached() && threadCache.m_enabled) {
+    threadCache.cacheOf(memPool).freeChunk(chunk);
+  } else {
+    memPool.freeChunk(chunk);
+  }
+}
+
+ThreadCache::~ThreadCache() noexcept {
+  flush();
+  /// a SharedChunk destroyed later during thread exit frees immediately
+  m_enabled = false;
+}
+
+MemPoolCache& ThreadCache::cacheOf(MemPool& memPool) noexcept {
+  tl::optional<MemPoolCache>* empty{nullptr};
+  for (auto& cache : m_caches) {
+    if (cache.has_value() && &cache->getMemPool() == &memPool) {
+      return *cache;
+    }
+    if (empty == nullptr && !cache.has_value()) {
+      empty = &cache;
+    }
+  }
+
+  if (empty == nullptr) {
+    empty = &m_caches[m_nextEviction];
+    m_nextEviction = (m_nextEviction + 1U) % NUMBER_OF_CACHES;
+    /// the destructor of the evicted cache returns its chunks
+    empty->reset();
+  }
+  return empty->emplace(memPool);
+}
+
+void ThreadCache::flush() noexcept {
+  for (auto& cache : m_caches) {
+    cache.reset();
+  }
+}
+
+void ThreadCache::flush(const MemPool& memPool) noexcept {
+  for (auto& cache : m_caches) {
+    if (cache.has_value() && &cache->getMemPool() == &memPool) {
+      cache.reset();
+    }
+  }
+}
+
+uint32_t ThreadCache::size() const noexcept {
+  uint32_t parked{0U};
+  for (const auto& cache : m_caches) {
+    if (cache.has_value()) {
+      parked += cache->size();
+    }
+  }
+  return parked;
+}
+
+}  // namespace memory
+}  // namespace shm
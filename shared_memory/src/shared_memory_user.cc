@@ -20,11 +20,12 @@ namespace shm {
 
 SharedMemoryUser::SharedMemoryUser(
     const size_t dataSize, const uint64_t segmentId,
-    const details::UntypedRelativePointer::offset_t
-        segmentManagerAddressOffset) noexcept {
+    const details::UntypedRelativePointer::offset_t segmentManagerAddressOffset,
+    const details::MemoryInfo& memoryInfo) noexcept {
   auto res = details::SharedMemoryObjectBuilder(
                  "chh", dataSize, AccessMode::READ_WRITE,
                  OpenMode::OPEN_EXISTING, SHM_SEGMENT_PERMISSIONS)
+                 .memoryInfo(memoryInfo)
                  .create();
 
   if (res.has_value()) {
@@ -69,9 +70,11 @@ void SharedMemoryUser::OpenDataSegments(
   for (const auto& segment : segmentMapping) {
     auto accessMode =
         segment.m_isWritable ? AccessMode::READ_WRITE : AccessMode::READ_ONLY;
+    // a segment placed on hugetlbfs is not in /dev/shm
     auto res = details::SharedMemoryObjectBuilder(
                    segment.m_sharedMemoryName, segment.m_size, accessMode,
                    OpenMode::OPEN_EXISTING, SHM_SEGMENT_PERMISSIONS)
+                   .memoryInfo(segment.m_memoryInfo)
                    .create();
 
     if (res.has_value()) {
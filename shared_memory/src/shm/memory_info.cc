@@ -0,0 +1,22 @@
+
+
+#include "shm/memory_info.hpp"
+
+namespace shm {
+namespace details {
+
+constexpr uint32_t MemoryInfo::DEFAULT_DEVICE_ID;
+constexpr uint32_t MemoryInfo::DEFAULT_MEMORY_TYPE;
+
+MemoryInfo::MemoryInfo(uint32_t device, uint32_t type) noexcept
+    : deviceId(device), memoryType(type) {}
+
+bool MemoryInfo::operator==(const MemoryInfo& rhs) const noexcept {
+  return deviceId == rhs.deviceId && memoryType == rhs.memoryType &&
+         hugePages == rhs.hugePages && prefault == rhs.prefault &&
+         lockMemory == rhs.lockMemory && numaPolicy == rhs.numaPolicy &&
+         numaNode == rhs.numaNode;
+}
+
+}  // namespace details
+}  // namespace shm
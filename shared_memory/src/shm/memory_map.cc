@@ -8,6 +8,7 @@
 #include <bitset>
 #include <string>
 
+#include "shm/numa.hpp"
 #include "shm/shared_memory.hpp"
 #include "shm/system_call.hpp"
 #include "shm/utils.h"
@@ -16,14 +17,23 @@ namespace shm {
 namespace details {
 
 tl::expected<MemoryMap, MemoryMapError> MemoryMapBuilder::create() noexcept {
+  auto flags = static_cast<int32_t>(m_flags);
+  // with transparent huge pages or a NUMA policy the memory is populated
+  // after the advice, otherwise MAP_POPULATE would already have backed it
+  // with small pages on the node of the calling thread
+  const bool populateOnMap = m_prefault && !m_transparentHugePages &&
+                             m_numaPolicy == NumaPolicy::DEFAULT;
+  if (populateOnMap) {
+    flags |= MAP_POPULATE;
+  }
+
   // AXIVION Next Construct AutosarC++19_03-A5.2.3, CertC++-EXP55 :
   // Incompatibility with POSIX definition of mmap
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) low-level memory
   // management
   auto result = SYSTEM_CALL(mmap)(const_cast<void*>(m_baseAddressHint),
                                   m_length, convertToProtFlags(m_accessMode),
-                                  static_cast<int32_t>(m_flags),
-                                  m_fileDescriptor, m_offset)
+                                  flags, m_fileDescriptor, m_offset)
 
                     // NOLINTJUSTIFICATION cast required, type of error
                     // MAP_FAILED defined by POSIX to be void*
@@ -35,7 +45,20 @@ tl::expected<MemoryMap, MemoryMapError> MemoryMapBuilder::create() noexcept {
                     .evaluate();
 
   if (result) {
-    return MemoryMap(result.value().value, m_length);
+    MemoryMap memoryMap(result.value().value, m_length);
+    if (m_transparentHugePages) {
+      memoryMap.adviseTransparentHugePages();
+    }
+    if (m_numaPolicy != NumaPolicy::DEFAULT) {
+      memoryMap.applyNumaPolicy(m_numaPolicy, m_numaNode);
+    }
+    if (m_prefault && !populateOnMap) {
+      memoryMap.prefault(m_accessMode);
+    }
+    if (m_lock) {
+      memoryMap.lock();
+    }
+    return memoryMap;
   }
   constexpr uint64_t FLAGS_BIT_SIZE = 32U;
   spdlog::error(
@@ -53,6 +76,73 @@ tl::expected<MemoryMap, MemoryMapError> MemoryMapBuilder::create() noexcept {
 MemoryMap::MemoryMap(void* const baseAddress, const uint64_t length) noexcept
     : m_baseAddress(baseAddress), m_length(length) {}
 
+void MemoryMap::adviseTransparentHugePages() noexcept {
+  auto result = SYSTEM_CALL(madvise)(m_baseAddress, m_length, MADV_HUGEPAGE)
+                    .failureReturnValue(-1)
+                    .suppressErrorMessagesForErrnos(EINVAL)
+                    .evaluate();
+  if (!result.has_value()) {
+    spdlog::warn("Transparent huge pages are not available [ size = " +
+                 std::to_string(m_length) +
+                 " ], the mapping is backed by regular pages");
+    return;
+  }
+  m_transparentHugePages = true;
+}
+
+void MemoryMap::applyNumaPolicy(const NumaPolicy policy,
+                                const uint32_t node) noexcept {
+  if (!setNumaPolicy(m_baseAddress, m_length, policy, node)) {
+    spdlog::warn("Unable to apply the NUMA policy to the mapped memory [ "
+                 "size = " +
+                 std::to_string(m_length) + ", node = " +
+                 std::to_string(node) +
+                 " ], the pages are placed on first touch");
+    return;
+  }
+  m_numaPolicy = policy;
+}
+
+void MemoryMap::prefault(const AccessMode accessMode) noexcept {
+#ifdef MADV_POPULATE_WRITE
+  auto advice = (accessMode == AccessMode::READ_ONLY) ? MADV_POPULATE_READ
+                                                      : MADV_POPULATE_WRITE;
+  auto result = SYSTEM_CALL(madvise)(m_baseAddress, m_length, advice)
+                    .failureReturnValue(-1)
+                    .suppressErrorMessagesForErrnos(EINVAL)
+                    .evaluate();
+  if (result.has_value()) {
+    return;
+  }
+#endif
+  // kernels before 5.14 do not know MADV_POPULATE_*, a read of every page
+  // faults it in as well since shared mappings never use the zero page
+  if (accessMode == AccessMode::WRITE_ONLY) {
+    return;
+  }
+  const auto page = pageSize();
+  const auto* bytes = static_cast<const volatile uint8_t*>(m_baseAddress);
+  for (uint64_t offset = 0U; offset < m_length; offset += page) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    static_cast<void>(bytes[offset]);
+  }
+}
+
+void MemoryMap::lock() noexcept {
+  auto result = SYSTEM_CALL(mlock)(m_baseAddress, m_length)
+                    .failureReturnValue(-1)
+                    .suppressErrorMessagesForErrnos(EPERM, ENOMEM, EAGAIN)
+                    .evaluate();
+  if (!result.has_value()) {
+    spdlog::warn("Unable to lock " + std::to_string(m_length) +
+                 " bytes of mapped memory in RAM (" +
+                 result.error().getReadableErrnum() +
+                 "), RLIMIT_MEMLOCK may be too low");
+    return;
+  }
+  m_isLocked = true;
+}
+
 // NOLINTJUSTIFICATION the function size results from the error handling and the
 // expanded log macro NOLINTNEXTLINE(readability-function-size)
 MemoryMapError MemoryMap::errnoToEnum(const int32_t errnum) noexcept {
@@ -143,9 +233,15 @@ MemoryMap& MemoryMap::operator=(MemoryMap&& rhs) noexcept {
 
     m_baseAddress = rhs.m_baseAddress;
     m_length = rhs.m_length;
+    m_transparentHugePages = rhs.m_transparentHugePages;
+    m_isLocked = rhs.m_isLocked;
+    m_numaPolicy = rhs.m_numaPolicy;
 
     rhs.m_baseAddress = nullptr;
     rhs.m_length = 0U;
+    rhs.m_transparentHugePages = false;
+    rhs.m_isLocked = false;
+    rhs.m_numaPolicy = NumaPolicy::DEFAULT;
   }
   return *this;
 }
@@ -160,6 +256,14 @@ const void* MemoryMap::getBaseAddress() const noexcept { return m_baseAddress; }
 
 void* MemoryMap::getBaseAddress() noexcept { return m_baseAddress; }
 
+bool MemoryMap::usesTransparentHugePages() const noexcept {
+  return m_transparentHugePages;
+}
+
+bool MemoryMap::isLocked() const noexcept { return m_isLocked; }
+
+NumaPolicy MemoryMap::getNumaPolicy() const noexcept { return m_numaPolicy; }
+
 bool MemoryMap::destroy() noexcept {
   if (m_baseAddress != nullptr) {
     auto unmapResult = SYSTEM_CALL(munmap)(m_baseAddress, m_length)
@@ -167,6 +271,9 @@ bool MemoryMap::destroy() noexcept {
                            .evaluate();
     m_baseAddress = nullptr;
     m_length = 0U;
+    m_transparentHugePages = false;
+    m_isLocked = false;
+    m_numaPolicy = NumaPolicy::DEFAULT;
 
     if (!unmapResult.has_value()) {
       errnoToEnum(unmapResult.error().errnum);
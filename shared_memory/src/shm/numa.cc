@@ -0,0 +1,77 @@
+
+
+#include "shm/numa.hpp"
+
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace shm {
+namespace details {
+
+namespace {
+using NodeMask_t = unsigned long;
+static_assert(sizeof(NodeMask_t) * 8U == MAX_NUMBER_OF_NUMA_NODES,
+              "one word holds the node mask");
+
+// the kernel reads maxnode - 1 bits from the mask
+constexpr unsigned long MAX_NODE{MAX_NUMBER_OF_NUMA_NODES + 1U};
+
+bool allowedNumaNodes(NodeMask_t& mask) noexcept {
+  mask = 0U;
+  return syscall(SYS_get_mempolicy, nullptr, &mask, MAX_NODE, nullptr,
+                 MPOL_F_MEMS_ALLOWED) == 0 &&
+         mask != 0U;
+}
+}  // namespace
+
+uint32_t currentNumaNode() noexcept {
+  unsigned int cpu{0U};
+  unsigned int node{0U};
+  if (getcpu(&cpu, &node) != 0) {
+    return 0U;
+  }
+  return static_cast<uint32_t>(node);
+}
+
+uint32_t numberOfNumaNodes() noexcept {
+  NodeMask_t mask{0U};
+  if (!allowedNumaNodes(mask)) {
+    return 1U;
+  }
+  return MAX_NUMBER_OF_NUMA_NODES -
+         static_cast<uint32_t>(__builtin_clzl(mask));
+}
+
+bool setNumaPolicy(void* const address, const uint64_t length,
+                   const NumaPolicy policy, const uint32_t node) noexcept {
+  NodeMask_t mask{0U};
+  int mode{MPOL_DEFAULT};
+  switch (policy) {
+    case NumaPolicy::DEFAULT:
+      break;
+    case NumaPolicy::BIND:
+      if (node >= MAX_NUMBER_OF_NUMA_NODES) {
+        return false;
+      }
+      mode = MPOL_BIND;
+      mask = NodeMask_t{1U} << node;
+      break;
+    case NumaPolicy::INTERLEAVE:
+      if (!allowedNumaNodes(mask)) {
+        return false;
+      }
+      mode = MPOL_INTERLEAVE;
+      break;
+    default:
+      return false;
+  }
+  const auto* nodeMask = (mode == MPOL_DEFAULT) ? nullptr : &mask;
+  const auto maxNode = (mode == MPOL_DEFAULT) ? 0U : MAX_NODE;
+  return syscall(SYS_mbind, address, length, mode, nodeMask, maxNode,
+                 MPOL_MF_MOVE) == 0;
+}
+
+}  // namespace details
+}  // namespace shm
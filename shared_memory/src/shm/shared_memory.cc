@@ -8,8 +8,12 @@
  */
 #include "shm/shared_memory.hpp"
 
+#include <fcntl.h>
 #include <spdlog/spdlog.h>
 #include <sys/mman.h>
+#include <linux/magic.h>
+#include <sys/vfs.h>
+#include <unistd.h>
 
 #include <iostream>
 #include <string>
@@ -22,6 +26,36 @@
 namespace shm {
 namespace details {
 
+namespace {
+// shm_open and open, respectively shm_unlink and unlink, share their
+// signatures; the wrappers keep a single SYSTEM_CALL per operation
+int openFile(const char* name, int oflag, mode_t mode, bool onHugetlbfs) {
+  return onHugetlbfs ? open(name, oflag, mode) : shm_open(name, oflag, mode);
+}
+
+int unlinkFile(const char* name, bool onHugetlbfs) {
+  return onHugetlbfs ? unlink(name) : shm_unlink(name);
+}
+
+std::string filePath(const std::string& name, bool onHugetlbfs) {
+  auto nameWithLeadingSlash = addLeadingSlash(name);
+  return onHugetlbfs ? SharedMemory::HUGETLBFS_MOUNT_POINT +
+                           nameWithLeadingSlash
+                     : nameWithLeadingSlash;
+}
+
+/// @brief the block size of hugetlbfs is the size of its huge pages
+uint64_t hugePageSize(const shm_handle_t handle) {
+  struct statfs fileSystem {};
+  if (fstatfs(handle, &fileSystem) != 0) {
+    return 0U;
+  }
+  return static_cast<uint64_t>(fileSystem.f_bsize);
+}
+}  // namespace
+
+constexpr const char* SharedMemory::HUGETLBFS_MOUNT_POINT;
+
 tl::expected<SharedMemory, SharedMemoryError>
 SharedMemoryBuilder::create() noexcept {
   auto printError = [this] {
@@ -31,7 +65,8 @@ SharedMemoryBuilder::create() noexcept {
         m_name + ", access mode = " + asStringLiteral(m_accessMode) +
         ", open mode = " + asStringLiteral(m_openMode) +
         ", mode = " + std::to_string(m_filePermissions.value()) +
-        ", sizeInBytes = " + std::to_string(m_size) + " ]");
+        ", sizeInBytes = " + std::to_string(m_size) +
+        ", hugetlbfs = " + (m_onHugetlbfs ? "true" : "false") + " ]");
   };
 
   // on qnx the current working directory will be added to the /dev/shmem path
@@ -48,7 +83,7 @@ SharedMemoryBuilder::create() noexcept {
     return tl::make_unexpected(SharedMemoryError::INVALID_FILE_NAME);
   }
 
-  auto nameWithLeadingSlash = addLeadingSlash(m_name);
+  auto nameWithLeadingSlash = filePath(m_name, m_onHugetlbfs);
 
   bool hasOwnership = (m_openMode == OpenMode::EXCLUSIVE_CREATE ||
                        m_openMode == OpenMode::PURGE_AND_CREATE ||
@@ -70,19 +105,20 @@ SharedMemoryBuilder::create() noexcept {
     ScopeGuard umaskGuard([&] { umask(umaskSaved); });
 
     if (m_openMode == OpenMode::PURGE_AND_CREATE) {
-      DISCARD_RESULT(SYSTEM_CALL(shm_unlink)(nameWithLeadingSlash.c_str())
+      DISCARD_RESULT(SYSTEM_CALL(unlinkFile)(nameWithLeadingSlash.c_str(),
+                                             m_onHugetlbfs)
                          .failureReturnValue(SharedMemory::INVALID_HANDLE)
                          .ignoreErrnos(ENOENT)
                          .evaluate());
     }
 
-    auto result = SYSTEM_CALL(shm_open)(
+    auto result = SYSTEM_CALL(openFile)(
                       nameWithLeadingSlash.c_str(),
                       convertToOflags(m_accessMode,
                                       (m_openMode == OpenMode::OPEN_OR_CREATE)
                                           ? OpenMode::EXCLUSIVE_CREATE
                                           : m_openMode),
-                      m_filePermissions.value())
+                      m_filePermissions.value(), m_onHugetlbfs)
                       .failureReturnValue(SharedMemory::INVALID_HANDLE)
                       .suppressErrorMessagesForErrnos(
                           (m_openMode == OpenMode::OPEN_OR_CREATE) ? EEXIST : 0)
@@ -93,10 +129,10 @@ SharedMemoryBuilder::create() noexcept {
       if (m_openMode == OpenMode::OPEN_OR_CREATE &&
           result.error().errnum == EEXIST) {
         hasOwnership = false;
-        result = SYSTEM_CALL(shm_open)(
+        result = SYSTEM_CALL(openFile)(
                      nameWithLeadingSlash.c_str(),
                      convertToOflags(m_accessMode, OpenMode::OPEN_EXISTING),
-                     m_filePermissions.value())
+                     m_filePermissions.value(), m_onHugetlbfs)
                      .failureReturnValue(SharedMemory::INVALID_HANDLE)
                      .evaluate();
       }
@@ -111,8 +147,16 @@ SharedMemoryBuilder::create() noexcept {
   }
 
   if (hasOwnership) {
+    auto size = m_size;
+    if (m_onHugetlbfs) {
+      // hugetlbfs only accepts sizes which are a multiple of its pages
+      const auto hugePage = hugePageSize(sharedMemoryFileHandle);
+      if (hugePage != 0U) {
+        size = (size + hugePage - 1U) / hugePage * hugePage;
+      }
+    }
     auto result = SYSTEM_CALL(ftruncate)(sharedMemoryFileHandle,
-                                         static_cast<int64_t>(m_size))
+                                         static_cast<int64_t>(size))
                       .failureReturnValue(SharedMemory::INVALID_HANDLE)
                       .evaluate();
     if (!result.has_value()) {
@@ -127,7 +171,8 @@ SharedMemoryBuilder::create() noexcept {
                       " for SharedMemory \"" + m_name + "\"");
       }
 
-      auto res_unlink = SYSTEM_CALL(shm_unlink)(nameWithLeadingSlash.c_str())
+      auto res_unlink = SYSTEM_CALL(unlinkFile)(nameWithLeadingSlash.c_str(),
+                                                m_onHugetlbfs)
                             .failureReturnValue(SharedMemory::INVALID_HANDLE)
                             .evaluate();
       if (!res_unlink) {
@@ -140,12 +185,17 @@ SharedMemoryBuilder::create() noexcept {
     }
   }
 
-  return SharedMemory(m_name, sharedMemoryFileHandle, hasOwnership);
+  return SharedMemory(m_name, sharedMemoryFileHandle, hasOwnership,
+                      m_onHugetlbfs);
 }
 
 SharedMemory::SharedMemory(const Name_t& name, const shm_handle_t handle,
-                           const bool hasOwnership) noexcept
-    : m_name{name}, m_handle{handle}, m_hasOwnership{hasOwnership} {}
+                           const bool hasOwnership,
+                           const bool onHugetlbfs) noexcept
+    : m_name{name},
+      m_handle{handle},
+      m_hasOwnership{hasOwnership},
+      m_isOnHugetlbfs{onHugetlbfs} {}
 
 SharedMemory::~SharedMemory() noexcept { destroy(); }
 
@@ -156,6 +206,7 @@ void SharedMemory::destroy() noexcept {
 
 void SharedMemory::reset() noexcept {
   m_hasOwnership = false;
+  m_isOnHugetlbfs = false;
   m_name = Name_t();
   m_handle = INVALID_HANDLE;
 }
@@ -171,6 +222,7 @@ SharedMemory& SharedMemory::operator=(SharedMemory&& rhs) noexcept {
     m_name = rhs.m_name;
     m_hasOwnership = rhs.m_hasOwnership;
     m_handle = rhs.m_handle;
+    m_isOnHugetlbfs = rhs.m_isOnHugetlbfs;
 
     rhs.reset();
   }
@@ -183,11 +235,22 @@ shm_handle_t SharedMemory::get_file_handle() const noexcept { return m_handle; }
 
 bool SharedMemory::hasOwnership() const noexcept { return m_hasOwnership; }
 
+bool SharedMemory::isOnHugetlbfs() const noexcept { return m_isOnHugetlbfs; }
+
+bool SharedMemory::isHugetlbfsAvailable() noexcept {
+  struct statfs fileSystem {};
+  if (statfs(HUGETLBFS_MOUNT_POINT, &fileSystem) != 0) {
+    return false;
+  }
+  return static_cast<uint64_t>(fileSystem.f_type) == HUGETLBFS_MAGIC;
+}
+
 tl::expected<bool, SharedMemoryError> SharedMemory::unlinkIfExist(
-    const Name_t& name) noexcept {
-  auto nameWithLeadingSlash = addLeadingSlash(name);
+    const Name_t& name, const bool onHugetlbfs) noexcept {
+  auto nameWithLeadingSlash = filePath(name, onHugetlbfs);
 
-  auto result = SYSTEM_CALL(shm_unlink)(nameWithLeadingSlash.c_str())
+  auto result = SYSTEM_CALL(unlinkFile)(nameWithLeadingSlash.c_str(),
+                                        onHugetlbfs)
                     .failureReturnValue(INVALID_HANDLE)
                     .ignoreErrnos(ENOENT)
                     .evaluate();
@@ -201,7 +264,7 @@ tl::expected<bool, SharedMemoryError> SharedMemory::unlinkIfExist(
 
 bool SharedMemory::unlink() noexcept {
   if (m_hasOwnership) {
-    auto unlinkResult = unlinkIfExist(m_name);
+    auto unlinkResult = unlinkIfExist(m_name, m_isOnHugetlbfs);
     if (!unlinkResult.has_value() || !unlinkResult.value()) {
       spdlog::error("Unable to unlink SharedMemory (shm_unlink failed).");
       return false;
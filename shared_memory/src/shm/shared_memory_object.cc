@@ -41,6 +41,22 @@ static void memsetSigbusHandler(int) noexcept {
 
 tl::expected<SharedMemoryObject, SharedMemoryObjectError>
 SharedMemoryObjectBuilder::create() noexcept {
+  if (m_memoryInfo.hugePages == HugePages::HUGETLBFS) {
+    if (SharedMemory::isHugetlbfsAvailable()) {
+      auto result = create(true);
+      if (result.has_value()) {
+        return result;
+      }
+    }
+    spdlog::warn("Unable to place the shared memory [" + m_name +
+                 "] on hugetlbfs in " + SharedMemory::HUGETLBFS_MOUNT_POINT +
+                 ", falling back to transparent huge pages");
+  }
+  return create(false);
+}
+
+tl::expected<SharedMemoryObject, SharedMemoryObjectError>
+SharedMemoryObjectBuilder::create(const bool onHugetlbfs) noexcept {
   auto printErrorDetails = [this] {
     auto logBaseAddressHint =
         [this](std::stringstream& stream) noexcept -> std::stringstream& {
@@ -65,6 +81,7 @@ SharedMemoryObjectBuilder::create() noexcept {
   auto sharedMemory =
       details::SharedMemoryBuilder(m_name, m_accessMode, m_openMode,
                                    m_permissions, m_memorySizeInBytes)
+          .hugetlbfs(onHugetlbfs)
           .create();
 
   if (!sharedMemory) {
@@ -100,10 +117,16 @@ SharedMemoryObjectBuilder::create() noexcept {
 
   auto hint = m_baseAddressHint ? m_baseAddressHint.value() : nullptr;
 
-  auto memoryMap = details::MemoryMapBuilder(
-                       hint, realSize, sharedMemory->getHandle(), m_accessMode,
-                       details::MemoryMapFlags::SHARE_CHANGES, 0)
-                       .create();
+  auto memoryMap =
+      details::MemoryMapBuilder(hint, realSize, sharedMemory->getHandle(),
+                                m_accessMode,
+                                details::MemoryMapFlags::SHARE_CHANGES, 0)
+          .transparentHugePages(!onHugetlbfs &&
+                                m_memoryInfo.hugePages != HugePages::NONE)
+          .prefault(m_memoryInfo.prefault)
+          .lock(m_memoryInfo.lockMemory)
+          .numaPolicy(m_memoryInfo.numaPolicy, m_memoryInfo.numaNode)
+          .create();
 
   if (!memoryMap) {
     printErrorDetails();
@@ -155,13 +178,27 @@ SharedMemoryObjectBuilder::create() noexcept {
                   " bytes successfully in the shared memory [" + m_name + "]");
   }
 
-  return SharedMemoryObject(std::move(*sharedMemory), std::move(*memoryMap));
+  auto memoryInfo = m_memoryInfo;
+  if (onHugetlbfs) {
+    memoryInfo.hugePages = HugePages::HUGETLBFS;
+  } else if (memoryMap->usesTransparentHugePages()) {
+    memoryInfo.hugePages = HugePages::TRANSPARENT;
+  } else {
+    memoryInfo.hugePages = HugePages::NONE;
+  }
+  memoryInfo.lockMemory = memoryMap->isLocked();
+  memoryInfo.numaPolicy = memoryMap->getNumaPolicy();
+
+  return SharedMemoryObject(std::move(*sharedMemory), std::move(*memoryMap),
+                            memoryInfo);
 }
 
 SharedMemoryObject::SharedMemoryObject(details::SharedMemory&& sharedMemory,
-                                       details::MemoryMap&& memoryMap) noexcept
+                                       details::MemoryMap&& memoryMap,
+                                       const MemoryInfo& memoryInfo) noexcept
     : m_sharedMemory(std::move(sharedMemory)),
-      m_memoryMap(std::move(memoryMap)) {}
+      m_memoryMap(std::move(memoryMap)),
+      m_memoryInfo(memoryInfo) {}
 
 const void* SharedMemoryObject::getBaseAddress() const noexcept {
   return m_memoryMap.getBaseAddress();
@@ -183,5 +220,9 @@ bool SharedMemoryObject::hasOwnership() const noexcept {
   return m_sharedMemory.hasOwnership();
 }
 
+const MemoryInfo& SharedMemoryObject::getMemoryInfo() const noexcept {
+  return m_memoryInfo;
+}
+
 }  // namespace details
 }  // namespace shm
\ No newline at end of file
@@ -9,10 +9,13 @@ namespace details {
 
 constexpr access_rights SharedMemoryProvider::SHM_MEMORY_PERMISSIONS;
 
-SharedMemoryProvider::SharedMemoryProvider(const ShmName_t& shmName,
-                                           const AccessMode accessMode,
-                                           const OpenMode openMode) noexcept
-    : m_shmName(shmName), m_accessMode(accessMode), m_openMode(openMode) {}
+SharedMemoryProvider::SharedMemoryProvider(
+    const ShmName_t& shmName, const AccessMode accessMode,
+    const OpenMode openMode, const MemoryInfo& memoryInfo) noexcept
+    : m_shmName(shmName),
+      m_accessMode(accessMode),
+      m_openMode(openMode),
+      m_memoryInfo(memoryInfo) {}
 
 SharedMemoryProvider::~SharedMemoryProvider() noexcept {
   if (isAvailable()) {
@@ -32,6 +35,7 @@ tl::expected<void*, MemoryProviderError> SharedMemoryProvider::createMemory(
 
   auto res = SharedMemoryObjectBuilder(m_shmName, size, m_accessMode,
                                        m_openMode, SHM_MEMORY_PERMISSIONS)
+                 .memoryInfo(m_memoryInfo)
                  .create();
 
   if (res.has_value()) {
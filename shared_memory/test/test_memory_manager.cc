@@ -1,6 +1,15 @@
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <sstream>
+#include <thread>
+
 #include "memory/chunk_header.hpp"
+#include "memory/chunk_reclaimer.hpp"
+#include "memory/exhaustion_reporter.hpp"
 #include "memory/memory_manager.hpp"
-#include "memory/segment.hpp"
+#include "memory/thread_cache.hpp"
+#include "shm/numa.hpp"
 // #include "shm/utils.h"
 #include "test.hpp"
 
@@ -489,6 +498,374 @@ TEST_F(MemoryManager_test, freeChunkMultiMemPoolFullToEmptyToFull) {
   EXPECT_THAT(sut->getMemPoolInfo(3).m_usedChunks, Eq(CHUNK_COUNT));
 }
 
+TEST_F(MemoryManager_test, getChunkSelectsTheSmallestFittingMemPoolOfMany) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "3e7a91c4-5b0d-4f8e-a2c6-d819f04b7e35");
+  constexpr uint32_t CHUNK_COUNT{2U};
+  std::vector<uint32_t> payloadSizes;
+  for (uint32_t size = 32U; size <= 4096U; size += size / 4U) {
+    payloadSizes.push_back(size / 8U * 8U);
+  }
+  ASSERT_THAT(payloadSizes.size(), Gt(20U));
+  for (auto size : payloadSizes) {
+    mempoolconf.addMemPool({size, CHUNK_COUNT});
+  }
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  for (uint32_t userPayloadSize = 0U; userPayloadSize <= payloadSizes.back();
+       ++userPayloadSize) {
+    auto chunkSettings =
+        ChunkSettings::create(userPayloadSize,
+                              CHUNK_DEFAULT_USER_PAYLOAD_ALIGNMENT)
+            .value();
+    uint32_t expectedChunkSize{0U};
+    for (auto size : payloadSizes) {
+      const auto chunkSize = size + static_cast<uint32_t>(sizeof(ChunkHeader));
+      if (chunkSize >= chunkSettings.requiredChunkSize()) {
+        expectedChunkSize = chunkSize;
+        break;
+      }
+    }
+
+    auto chunk = sut->getChunk(chunkSettings);
+    ASSERT_TRUE(chunk.has_value()) << "user-payload size " << userPayloadSize;
+    EXPECT_THAT(chunk.value().getChunkHeader()->chunkSize(),
+                Eq(expectedChunkSize))
+        << "user-payload size " << userPayloadSize;
+  }
+}
+
+TEST_F(MemoryManager_test, getChunkWithFallbackTakesTheNextLargerMemPool) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "a84f0d27-c13e-4b69-9f5a-6e2b7d80c194");
+  constexpr uint32_t CHUNK_COUNT{10U};
+
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_64, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_128, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_256, CHUNK_COUNT});
+  mempoolconf.setFallbackPolicy(Config::FallbackPolicy::NEXT_LARGER_MEMPOOL);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  auto chunkStore_64 = getChunksFromSut(CHUNK_COUNT, chunkSettings_64);
+  auto chunkStore_128 = getChunksFromSut(CHUNK_COUNT, chunkSettings_128);
+
+  auto chunk = sut->getChunk(chunkSettings_64);
+  ASSERT_TRUE(chunk.has_value());
+  EXPECT_THAT(chunk.value().getChunkHeader()->chunkSize(),
+              Eq(CHUNK_SIZE_256 + sizeof(ChunkHeader)));
+  EXPECT_THAT(chunk.value().getChunkHeader()->userPayloadSize(),
+              Eq(chunkSettings_64.userPayloadSize()));
+
+  EXPECT_THAT(sut->getMemPoolInfo(0).m_usedChunks, Eq(0U));
+  EXPECT_THAT(sut->getMemPoolInfo(1).m_usedChunks, Eq(CHUNK_COUNT));
+  EXPECT_THAT(sut->getMemPoolInfo(2).m_usedChunks, Eq(CHUNK_COUNT));
+  EXPECT_THAT(sut->getMemPoolInfo(3).m_usedChunks, Eq(1U));
+}
+
+TEST_F(MemoryManager_test,
+       getChunkWithFallbackFailsWhenAllLargerMemPoolsAreExhausted) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "5c29e8b1-7f43-4d0a-b6e7-91d3a5c08f62");
+  constexpr uint32_t CHUNK_COUNT{10U};
+
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_64, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_128, CHUNK_COUNT});
+  mempoolconf.setFallbackPolicy(Config::FallbackPolicy::NEXT_LARGER_MEMPOOL);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  auto chunkStore = getChunksFromSut(2U * CHUNK_COUNT, chunkSettings_64);
+  EXPECT_THAT(chunkStore.size(), Eq(2U * CHUNK_COUNT));
+
+  auto chunk = sut->getChunk(chunkSettings_64);
+  ASSERT_FALSE(chunk.has_value());
+  EXPECT_EQ(chunk.error(), MemoryManager::Error::MEMPOOL_OUT_OF_CHUNKS);
+  EXPECT_THAT(sut->getMemPoolInfo(0).m_usedChunks, Eq(0U));
+}
+
+TEST_F(MemoryManager_test, everyNumaNodeGetsItsOwnSetOfMemPools) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "a4db485c-518e-4d9d-adc4-14682f76a37d");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  constexpr uint32_t NUMA_NODES{2U};
+
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_64, CHUNK_COUNT});
+  mempoolconf.setNumaNodes(NUMA_NODES);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  EXPECT_THAT(sut->getNumberOfNumaNodes(), Eq(NUMA_NODES));
+  ASSERT_THAT(sut->getNumberOfMemPools(), Eq(4U));
+  EXPECT_THAT(sut->getMemPoolInfo(2).m_chunkSize,
+              Eq(sut->getMemPoolInfo(0).m_chunkSize));
+
+  auto chunkOfNode0 = sut->getChunk(chunkSettings_64, 0U);
+  auto chunkOfNode1 = sut->getChunk(chunkSettings_64, 1U);
+  // nodes beyond the configured ones wrap around
+  auto chunkOfNode3 = sut->getChunk(chunkSettings_32, 3U);
+  ASSERT_TRUE(chunkOfNode0.has_value());
+  ASSERT_TRUE(chunkOfNode1.has_value());
+  ASSERT_TRUE(chunkOfNode3.has_value());
+
+  EXPECT_THAT(sut->getMemPoolInfo(0).m_usedChunks, Eq(0U));
+  EXPECT_THAT(sut->getMemPoolInfo(1).m_usedChunks, Eq(1U));
+  EXPECT_THAT(sut->getMemPoolInfo(2).m_usedChunks, Eq(1U));
+  EXPECT_THAT(sut->getMemPoolInfo(3).m_usedChunks, Eq(1U));
+}
+
+TEST_F(MemoryManager_test, getChunkServesFromTheNumaNodeOfTheCaller) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "d1bd3b7f-c8f6-4eb2-a6ce-be1940c09f15");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  constexpr uint32_t NUMA_NODES{2U};
+
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.setNumaNodes(NUMA_NODES);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  // on a single node system this is the fallback to the set of node 0
+  const auto localNode = currentNumaNode() % NUMA_NODES;
+  auto chunk = sut->getChunk(chunkSettings_32);
+  ASSERT_TRUE(chunk.has_value());
+
+  EXPECT_THAT(sut->getMemPoolInfo(localNode).m_usedChunks, Eq(1U));
+  EXPECT_THAT(sut->getMemPoolInfo(1U - localNode).m_usedChunks, Eq(0U));
+}
+
+TEST_F(MemoryManager_test, getChunkTakesRemoteChunksWhenTheLocalNodeIsEmpty) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "5c60c760-e8e1-443e-8bf1-fa1da74d8674");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  constexpr uint32_t NUMA_NODES{2U};
+
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_64, CHUNK_COUNT});
+  mempoolconf.setFallbackPolicy(Config::FallbackPolicy::NEXT_LARGER_MEMPOOL);
+  mempoolconf.setNumaNodes(NUMA_NODES);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  ChunkStore chunkStore;
+  for (uint32_t i = 0U; i < NUMA_NODES * 2U * CHUNK_COUNT; ++i) {
+    auto chunk = sut->getChunk(chunkSettings_32, 0U);
+    ASSERT_TRUE(chunk.has_value());
+    chunkStore.push_back(chunk.value());
+    // the larger mempool of the local node comes before the remote node
+    if (i == 2U * CHUNK_COUNT - 1U) {
+      EXPECT_THAT(sut->getMemPoolInfo(1).m_usedChunks, Eq(CHUNK_COUNT));
+      EXPECT_THAT(sut->getMemPoolInfo(2).m_usedChunks, Eq(0U));
+    }
+  }
+
+  auto chunk = sut->getChunk(chunkSettings_32, 1U);
+  ASSERT_FALSE(chunk.has_value());
+  EXPECT_EQ(chunk.error(), MemoryManager::Error::MEMPOOL_OUT_OF_CHUNKS);
+}
+
+TEST_F(MemoryManager_test, requiredMemorySizeGrowsWithTheNumaNodes) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "1c102a3f-898e-41cc-b678-02f098407302");
+  mempoolconf.addMemPool({CHUNK_SIZE_32, 10U});
+  mempoolconf.addMemPool({CHUNK_SIZE_128, 7U});
+  const auto chunkMemory = MemoryManager::requiredChunkMemorySize(mempoolconf);
+  const auto managementMemory =
+      MemoryManager::requiredManagementMemorySize(mempoolconf);
+
+  mempoolconf.setNumaNodes(3U);
+
+  EXPECT_THAT(MemoryManager::requiredChunkMemorySize(mempoolconf),
+              Eq(3U * chunkMemory));
+  EXPECT_THAT(MemoryManager::requiredManagementMemorySize(mempoolconf),
+              Gt(managementMemory));
+  EXPECT_THAT(numberOfNumaNodes(), Ge(1U));
+}
+
+TEST_F(MemoryManager_test, getChunkCountsFailedLoansPerError) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "7b15f3e8-2c64-4a9d-b0e1-58d9c2a7f406");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  using Error = MemoryManager::Error;
+
+  EXPECT_FALSE(sut->getChunk(chunkSettings_32).has_value());
+  EXPECT_THAT(sut->getErrorCount(Error::NO_MEMPOOLS_AVAILABLE), Eq(1U));
+
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_64, CHUNK_COUNT});
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  EXPECT_FALSE(sut->getChunk(chunkSettings_128).has_value());
+  auto chunkStore = getChunksFromSut(CHUNK_COUNT + 3U, chunkSettings_64);
+
+  EXPECT_THAT(sut->getErrorCount(Error::NO_MEMPOOL_FOR_REQUESTED_CHUNK_SIZE),
+              Eq(1U));
+  EXPECT_THAT(sut->getErrorCount(Error::MEMPOOL_OUT_OF_CHUNKS), Eq(3U));
+  EXPECT_THAT(sut->getMemPoolInfo(0).m_exhaustedCount, Eq(0U));
+  EXPECT_THAT(sut->getMemPoolInfo(1).m_exhaustedCount, Eq(3U));
+}
+
+TEST_F(MemoryManager_test, exhaustionReporterReportsAtMostOncePerInterval) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "e2c8a061-9f3d-47b5-a1e6-0d74b8f5c923");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  constexpr std::chrono::seconds INTERVAL{1};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  MemoryExhaustionReporter reporter{*sut, INTERVAL};
+  const auto start = MemoryExhaustionReporter::Clock_t::now();
+
+  EXPECT_THAT(reporter.poll(start), Eq(0U));
+
+  auto chunkStore = getChunksFromSut(CHUNK_COUNT + 5U, chunkSettings_32);
+  EXPECT_THAT(reporter.poll(start), Eq(5U));
+
+  EXPECT_FALSE(sut->getChunk(chunkSettings_32).has_value());
+  EXPECT_FALSE(sut->getChunk(chunkSettings_32).has_value());
+  EXPECT_THAT(reporter.poll(start + INTERVAL / 2), Eq(0U));
+  EXPECT_THAT(reporter.poll(start + INTERVAL), Eq(2U));
+  EXPECT_THAT(reporter.poll(start + 3 * INTERVAL), Eq(0U));
+}
+
+TEST_F(MemoryManager_test, allocationProfileRecordsRequestsAndPeakInUse) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "4d8e1b72-a6c3-49f0-b85d-e2170c9f3a64");
+  mempoolconf.addMemPool({CHUNK_SIZE_32, 10U});
+  mempoolconf.addMemPool({CHUNK_SIZE_128, 10U});
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  AllocationProfile profile;
+  sut->setAllocationProfile(&profile);
+
+  {
+    auto chunkStore = getChunksFromSut(3U, chunkSettings_32);
+    chunkStore.pop_back();
+    chunkStore.pop_back();
+    auto more = getChunksFromSut(1U, chunkSettings_32);
+    auto other = getChunksFromSut(1U, chunkSettings_64);
+  }
+  auto last = getChunksFromSut(1U, chunkSettings_64);
+
+  const auto entries = profile.getEntries();
+  ASSERT_THAT(entries.size(), Eq(2U));
+  EXPECT_THAT(entries[0].m_requiredChunkSize,
+              Eq(chunkSettings_32.requiredChunkSize()));
+  EXPECT_THAT(entries[0].m_requestCount, Eq(4U));
+  EXPECT_THAT(entries[0].m_peakInUse, Eq(3U));
+  EXPECT_THAT(entries[1].m_requiredChunkSize,
+              Eq(chunkSettings_64.requiredChunkSize()));
+  EXPECT_THAT(entries[1].m_requestCount, Eq(2U));
+  EXPECT_THAT(entries[1].m_peakInUse, Eq(1U));
+  EXPECT_THAT(profile.getDroppedCount(), Eq(0U));
+
+  sut->setAllocationProfile(nullptr);
+}
+
+TEST_F(MemoryManager_test, allocationProfileSurvivesAWriteReadRoundTrip) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "b39a0c5e-71f4-4e28-9d63-0a5c8e2f7b14");
+  const std::vector<AllocationProfile::Entry> entries{
+      {72U, 1000U, 12U}, {168U, 20U, 3U}, {4136U, 7U, 2U}};
+
+  std::stringstream stream;
+  AllocationProfile::write(stream, entries);
+  const auto result = AllocationProfile::read(stream);
+
+  ASSERT_TRUE(result.has_value());
+  ASSERT_THAT(result->size(), Eq(entries.size()));
+  for (size_t i = 0U; i < entries.size(); ++i) {
+    EXPECT_THAT((*result)[i].m_requiredChunkSize,
+                Eq(entries[i].m_requiredChunkSize));
+    EXPECT_THAT((*result)[i].m_requestCount, Eq(entries[i].m_requestCount));
+    EXPECT_THAT((*result)[i].m_peakInUse, Eq(entries[i].m_peakInUse));
+  }
+
+  std::stringstream garbage{"72 1000\n"};
+  EXPECT_FALSE(AllocationProfile::read(garbage).has_value());
+}
+
+TEST_F(MemoryManager_test, configFromProfileAppliesTheHeadroomToThePeak) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "6a1f5d93-c084-4b7e-a2d9-38e6b0c41f75");
+  const uint32_t header = sizeof(ChunkHeader);
+  const std::vector<AllocationProfile::Entry> entries{
+      {header + 32U, 1000U, 100U}, {header + 4096U, 10U, 4U}};
+
+  const auto config = AllocationProfile::toConfig(entries, 1.5);
+
+  ASSERT_THAT(config.m_mempoolConfig.size(), Eq(2U));
+  EXPECT_THAT(config.m_mempoolConfig[0].m_size, Eq(32U));
+  EXPECT_THAT(config.m_mempoolConfig[0].m_chunkCount, Eq(150U));
+  EXPECT_THAT(config.m_mempoolConfig[1].m_size, Eq(4096U));
+  EXPECT_THAT(config.m_mempoolConfig[1].m_chunkCount, Eq(6U));
+}
+
+TEST_F(MemoryManager_test, configFromProfileMergesSizesWhenItSavesMemory) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "f07c2e48-95ab-4d13-8e6f-c1b4a3d97052");
+  const uint32_t header = sizeof(ChunkHeader);
+  // with the headroom, two pools of 1016 and 1024 bytes need two chunks each
+  // while a merged pool of 1024 bytes needs three
+  const std::vector<AllocationProfile::Entry> entries{
+      {header + 30U, 10U, 4U},
+      {header + 32U, 10U, 6U},
+      {header + 1016U, 10U, 1U},
+      {header + 1024U, 10U, 1U}};
+
+  const auto config = AllocationProfile::toConfig(entries, 1.5);
+
+  ASSERT_THAT(config.m_mempoolConfig.size(), Eq(2U));
+  EXPECT_THAT(config.m_mempoolConfig[0].m_size, Eq(32U));
+  EXPECT_THAT(config.m_mempoolConfig[0].m_chunkCount, Eq(15U));
+  EXPECT_THAT(config.m_mempoolConfig[1].m_size, Eq(1024U));
+  EXPECT_THAT(config.m_mempoolConfig[1].m_chunkCount, Eq(3U));
+
+  const auto single = AllocationProfile::toConfig(entries, 1.5, 1U);
+  ASSERT_THAT(single.m_mempoolConfig.size(), Eq(1U));
+  EXPECT_THAT(single.m_mempoolConfig[0].m_size, Eq(1024U));
+  EXPECT_THAT(single.m_mempoolConfig[0].m_chunkCount, Eq(18U));
+  EXPECT_THAT(MemoryManager::requiredFullMemorySize(config),
+              Lt(MemoryManager::requiredFullMemorySize(single)));
+}
+
+TEST_F(MemoryManager_test, configFromRecordedProfileServesTheRecordedPeak) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "28d4b6a0-e3c1-4f97-b052-7d9a1c6e4f83");
+  constexpr uint32_t CHUNK_COUNT{100U};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_64, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_128, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_256, CHUNK_COUNT});
+  mempoolconf.addMemPool({1024U, CHUNK_COUNT});
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  AllocationProfile profile;
+  sut->setAllocationProfile(&profile);
+  {
+    auto chunks_32 = getChunksFromSut(40U, chunkSettings_32);
+    auto chunks_128 = getChunksFromSut(7U, chunkSettings_128);
+    auto chunks_256 = getChunksFromSut(3U, chunkSettings_256);
+  }
+  sut->setAllocationProfile(nullptr);
+
+  const auto config = AllocationProfile::toConfig(profile.getEntries());
+  const auto requiredMemorySize = MemoryManager::requiredFullMemorySize(config);
+  EXPECT_THAT(requiredMemorySize,
+              Lt(MemoryManager::requiredFullMemorySize(mempoolconf) / 10U));
+
+  std::vector<uint64_t> memory(requiredMemorySize / sizeof(uint64_t) + 1U);
+  BumpAllocator optimizedAllocator{memory.data(), requiredMemorySize};
+  MemoryManager optimized;
+  optimized.configureMemoryManager(config, optimizedAllocator,
+                                   optimizedAllocator);
+  std::vector<SharedChunk> chunks;
+  for (const auto& request : {std::make_pair(40U, chunkSettings_32),
+                              std::make_pair(7U, chunkSettings_128),
+                              std::make_pair(3U, chunkSettings_256)}) {
+    for (uint32_t i = 0U; i < request.first; ++i) {
+      auto chunk = optimized.getChunk(request.second);
+      ASSERT_TRUE(chunk.has_value());
+      chunks.push_back(chunk.value());
+    }
+  }
+}
+
 TEST_F(MemoryManager_test, getChunkWithUserPayloadSizeZeroShouldNotFail) {
   ::testing::Test::RecordProperty("TEST_ID",
                                   "9fbfe1ff-9d59-449b-b164-433bbb031125");
@@ -519,6 +896,378 @@ TEST_F(MemoryManager_test, getChunkWithUserPayloadSizeZeroShouldNotFail) {
 //       }, HoofsError::EXPECTS_ENSURES_FAILED);
 // }
 
+TEST_F(MemoryManager_test, reclaimedChunksStayParkedUntilABatchIsFull) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "3c0f6a51-6e0b-4a7e-9d0b-2f4b8e61c7a2");
+  constexpr uint32_t CHUNK_COUNT{2U * ChunkReclaimer::BATCH_SIZE};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  auto& reclaimer = ChunkReclaimer::forThisThread();
+  reclaimer.enable();
+
+  {
+    auto chunkStore =
+        getChunksFromSut(ChunkReclaimer::BATCH_SIZE - 1U, chunkSettings_32);
+    ASSERT_EQ(chunkStore.size(), ChunkReclaimer::BATCH_SIZE - 1U);
+  }
+  /// the payloads and the ChunkManagements are parked in separate bins
+  EXPECT_EQ(reclaimer.size(), 2U * (ChunkReclaimer::BATCH_SIZE - 1U));
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks,
+            ChunkReclaimer::BATCH_SIZE - 1U);
+
+  {
+    auto chunk = sut->getChunk(chunkSettings_32);
+    ASSERT_TRUE(chunk.has_value());
+  }
+  EXPECT_EQ(reclaimer.size(), 0U);
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+
+  reclaimer.disable();
+}
+
+TEST_F(MemoryManager_test, flushingTheReclaimerReturnsTheParkedChunks) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "b7d2e9c4-1a35-4f86-8c1e-5d0a7f3b9e24");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_64, CHUNK_COUNT});
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  auto& reclaimer = ChunkReclaimer::forThisThread();
+  reclaimer.enable();
+
+  {
+    auto chunkStore32 = getChunksFromSut(CHUNK_COUNT, chunkSettings_32);
+    auto chunkStore64 = getChunksFromSut(CHUNK_COUNT, chunkSettings_64);
+  }
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, CHUNK_COUNT);
+  EXPECT_EQ(sut->getMemPoolInfo(1U).m_usedChunks, CHUNK_COUNT);
+
+  reclaimer.flush();
+  EXPECT_EQ(reclaimer.size(), 0U);
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+  EXPECT_EQ(sut->getMemPoolInfo(1U).m_usedChunks, 0U);
+
+  reclaimer.disable();
+}
+
+TEST_F(MemoryManager_test, getChunkFlushesTheReclaimerWhenOutOfChunks) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "5e81c0b3-7f2d-4a69-b4e0-c93d1a6f2875");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  auto& reclaimer = ChunkReclaimer::forThisThread();
+  reclaimer.enable();
+
+  {
+    auto chunkStore = getChunksFromSut(CHUNK_COUNT, chunkSettings_32);
+    ASSERT_EQ(chunkStore.size(), CHUNK_COUNT);
+  }
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, CHUNK_COUNT);
+
+  auto chunkStore = getChunksFromSut(CHUNK_COUNT, chunkSettings_32);
+  EXPECT_EQ(chunkStore.size(), CHUNK_COUNT);
+  EXPECT_EQ(sut->getErrorCount(MemoryManager::Error::MEMPOOL_OUT_OF_CHUNKS),
+            0U);
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_exhaustedCount, 1U);
+  EXPECT_FALSE(sut->getChunk(chunkSettings_32).has_value());
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_exhaustedCount, 2U);
+
+  chunkStore.clear();
+  reclaimer.disable();
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+}
+
+/// parks the ChunkManagement of one chunk from each of the eight mempools;
+/// the eighth payload evicts the bin of the first, so its mempool has a chunk
+/// again while every ChunkManagement stays parked
+void parkAllChunkManagements(MemoryManager& memoryManager) {
+  auto& reclaimer = ChunkReclaimer::forThisThread();
+  reclaimer.enable();
+  std::vector<SharedChunk> chunks;
+  for (uint32_t i = 0U; i < ChunkReclaimer::NUMBER_OF_BINS; ++i) {
+    auto chunkSettings = ChunkSettings::create(
+        32U + 8U * i, CHUNK_DEFAULT_USER_PAYLOAD_ALIGNMENT);
+    ASSERT_TRUE(chunkSettings.has_value());
+    auto chunk = memoryManager.getChunk(chunkSettings.value());
+    ASSERT_TRUE(chunk.has_value());
+    chunks.push_back(chunk.value());
+  }
+  chunks.clear();
+  EXPECT_EQ(memoryManager.getMemPoolInfo(0U).m_usedChunks, 0U);
+}
+
+TEST_F(MemoryManager_test, getChunkFlushesParkedChunkManagements) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "4d8a1f63-c2b9-4e07-a5d1-93f6e0b27c48");
+  for (uint32_t i = 0U; i < ChunkReclaimer::NUMBER_OF_BINS; ++i) {
+    mempoolconf.addMemPool({32U + 8U * i, 1U});
+  }
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  parkAllChunkManagements(*sut);
+
+  auto chunk = sut->getChunk(chunkSettings_32);
+  EXPECT_TRUE(chunk.has_value());
+
+  ChunkReclaimer::forThisThread().disable();
+}
+
+TEST_F(MemoryManager_test, getChunkFailsWhenAnotherThreadParksTheManagement) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "9e27b5c0-1f84-4a6d-8c3e-d05a7b91f2e6");
+  for (uint32_t i = 0U; i < ChunkReclaimer::NUMBER_OF_BINS; ++i) {
+    mempoolconf.addMemPool({32U + 8U * i, 1U});
+  }
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  std::promise<void> parked;
+  std::promise<void> done;
+  std::thread parker([&] {
+    parkAllChunkManagements(*sut);
+    parked.set_value();
+    done.get_future().wait();
+  });
+  parked.get_future().wait();
+
+  auto chunk = sut->getChunk(chunkSettings_32);
+  ASSERT_FALSE(chunk.has_value());
+  EXPECT_EQ(chunk.error(), MemoryManager::Error::MEMPOOL_OUT_OF_CHUNKS);
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+
+  /// the parker flushes on exit
+  done.set_value();
+  parker.join();
+  EXPECT_TRUE(sut->getChunk(chunkSettings_32).has_value());
+}
+
+TEST_F(MemoryManager_test, disabledReclaimerFreesChunksImmediately) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "a40c7e96-2b58-4d1f-9e37-6f8b2d05c1e9");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  auto& reclaimer = ChunkReclaimer::forThisThread();
+  reclaimer.enable();
+
+  auto chunkStore = getChunksFromSut(CHUNK_COUNT, chunkSettings_32);
+  chunkStore.resize(CHUNK_COUNT / 2U);
+  EXPECT_EQ(reclaimer.size(), CHUNK_COUNT);
+
+  reclaimer.disable();
+  EXPECT_FALSE(reclaimer.isEnabled());
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, CHUNK_COUNT / 2U);
+
+  chunkStore.clear();
+  EXPECT_EQ(reclaimer.size(), 0U);
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+}
+
+TEST_F(MemoryManager_test, embeddedChunkManagementPrecedesTheChunkHeader) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "e2a95c17-48d0-4b6f-a3c8-1f7d60b94e52");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  constexpr uint32_t PAYLOAD_SIZE{CHUNK_SIZE_256};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_256, CHUNK_COUNT});
+  mempoolconf.setChunkLayout(Config::ChunkLayout::EMBEDDED_MANAGEMENT);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  auto chunkStore = getChunksFromSut(CHUNK_COUNT, chunkSettings_256);
+  ASSERT_EQ(chunkStore.size(), CHUNK_COUNT);
+  EXPECT_EQ(sut->getMemPoolInfo(1U).m_usedChunks, CHUNK_COUNT);
+  for (auto& chunk : chunkStore) {
+    auto chunkManagement = reinterpret_cast<uintptr_t>(chunk.getChunkHeader()) -
+                           ChunkManagement::EMBEDDED_PREFIX_SIZE;
+    EXPECT_EQ(chunkManagement % ChunkManagement::EMBEDDED_PREFIX_SIZE, 0U);
+    EXPECT_GE(chunk.getChunkHeader()->userPayloadSize(), PAYLOAD_SIZE);
+    EXPECT_EQ(chunk.getChunkHeader()->chunkSize() +
+                  ChunkManagement::EMBEDDED_PREFIX_SIZE,
+              sut->getMemPoolInfo(1U).m_chunkSize);
+    std::memset(chunk.getUserPayload(), 0xFF, PAYLOAD_SIZE);
+  }
+
+  auto copy = chunkStore.front();
+  chunkStore.clear();
+  EXPECT_EQ(sut->getMemPoolInfo(1U).m_usedChunks, 1U);
+  EXPECT_EQ(*static_cast<uint8_t*>(copy.getUserPayload()), 0xFFU);
+  copy = SharedChunk();
+  EXPECT_EQ(sut->getMemPoolInfo(1U).m_usedChunks, 0U);
+}
+
+TEST_F(MemoryManager_test, embeddedLayoutFitsIntoTheRequiredMemorySize) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "71c4d3e8-9b2a-4f05-86e1-a0d5c2b7f938");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_128, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_256, CHUNK_COUNT});
+  const auto separateManagementMemory =
+      MemoryManager::requiredManagementMemorySize(mempoolconf);
+  mempoolconf.setChunkLayout(Config::ChunkLayout::EMBEDDED_MANAGEMENT);
+  const auto requiredMemorySize =
+      MemoryManager::requiredFullMemorySize(mempoolconf);
+  EXPECT_THAT(MemoryManager::requiredManagementMemorySize(mempoolconf),
+              Lt(separateManagementMemory));
+
+  /// misaligned on purpose, the chunks are still aligned to cache lines
+  std::vector<uint64_t> memory(requiredMemorySize / sizeof(uint64_t) + 2U);
+  BumpAllocator exactAllocator{memory.data() + 1U, requiredMemorySize};
+  MemoryManager embedded;
+  embedded.configureMemoryManager(mempoolconf, exactAllocator, exactAllocator);
+
+  std::vector<SharedChunk> chunks;
+  for (const auto& chunkSettings :
+       {chunkSettings_32, chunkSettings_128, chunkSettings_256}) {
+    for (uint32_t i = 0U; i < CHUNK_COUNT; ++i) {
+      auto chunk = embedded.getChunk(chunkSettings);
+      ASSERT_TRUE(chunk.has_value());
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(chunk->getChunkHeader()) %
+                    ChunkManagement::EMBEDDED_PREFIX_SIZE,
+                0U);
+      chunks.push_back(chunk.value());
+    }
+  }
+  EXPECT_FALSE(embedded.getChunk(chunkSettings_256).has_value());
+}
+
+TEST_F(MemoryManager_test, embeddedLayoutMergesMemPoolsWithTheSameChunkSize) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "c58e0f2b-6d17-4a93-b4f6-3e92a1d7c085");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_32 + 8U, CHUNK_COUNT});
+  mempoolconf.addMemPool({CHUNK_SIZE_256, CHUNK_COUNT});
+  mempoolconf.setChunkLayout(Config::ChunkLayout::EMBEDDED_MANAGEMENT);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  ASSERT_EQ(sut->getNumberOfMemPools(), 2U);
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_numChunks, 2U * CHUNK_COUNT);
+  EXPECT_EQ(sut->getMemPoolInfo(1U).m_numChunks, CHUNK_COUNT);
+  EXPECT_EQ(getChunksFromSut(2U * CHUNK_COUNT, chunkSettings_32).size(),
+            2U * CHUNK_COUNT);
+}
+
+TEST_F(MemoryManager_test, reclaimerReturnsEmbeddedChunksToTheirMemPool) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "0b6f93d2-a7e4-4c15-9d28-f4c1e75a3b69");
+  constexpr uint32_t CHUNK_COUNT{10U};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.setChunkLayout(Config::ChunkLayout::EMBEDDED_MANAGEMENT);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  auto& reclaimer = ChunkReclaimer::forThisThread();
+  reclaimer.enable();
+
+  {
+    auto chunkStore = getChunksFromSut(CHUNK_COUNT, chunkSettings_32);
+    ASSERT_EQ(chunkStore.size(), CHUNK_COUNT);
+  }
+  EXPECT_EQ(reclaimer.size(), CHUNK_COUNT);
+  EXPECT_EQ(getChunksFromSut(CHUNK_COUNT, chunkSettings_32).size(),
+            CHUNK_COUNT);
+
+  reclaimer.disable();
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+}
+
+TEST_F(MemoryManager_test, threadCacheLoansAndReleasesChunksPerBatch) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "e2a95c17-4b6d-4f30-8a1e-73c0d9b5f624");
+  constexpr uint32_t CHUNK_COUNT{2U * MemPoolCache::BATCH_SIZE};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.setThreadCache(true);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  auto& threadCache = ThreadCache::forThisThread();
+
+  {
+    auto chunk = sut->getChunk(chunkSettings_32);
+    ASSERT_TRUE(chunk.has_value());
+    /// the payloads and the ChunkManagements are cached separately
+    EXPECT_EQ(threadCache.size(), 2U * (MemPoolCache::BATCH_SIZE - 1U));
+    EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, MemPoolCache::BATCH_SIZE);
+  }
+  EXPECT_EQ(threadCache.size(), 2U * MemPoolCache::BATCH_SIZE);
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, MemPoolCache::BATCH_SIZE);
+
+  threadCache.flush();
+  EXPECT_EQ(threadCache.size(), 0U);
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+}
+
+TEST_F(MemoryManager_test, threadCacheServesAllChunksOfTheMemPool) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "71f3b0d8-9c2e-4a57-b6d4-0e8a25c93f71");
+  constexpr uint32_t CHUNK_COUNT{3U * MemPoolCache::CAPACITY};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.setThreadCache(true);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  for (uint32_t round = 0U; round < 2U; ++round) {
+    auto chunkStore = getChunksFromSut(CHUNK_COUNT, chunkSettings_32);
+    EXPECT_EQ(chunkStore.size(), CHUNK_COUNT);
+    EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, CHUNK_COUNT);
+    chunkStore.clear();
+    /// a full cache drains to the mempool
+    EXPECT_LE(sut->getMemPoolInfo(0U).m_usedChunks, MemPoolCache::CAPACITY);
+  }
+  EXPECT_EQ(sut->getErrorCount(MemoryManager::Error::MEMPOOL_OUT_OF_CHUNKS),
+            0U);
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_exhaustedCount, 0U);
+
+  ThreadCache::forThisThread().flush();
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+}
+
+TEST_F(MemoryManager_test, threadCacheReturnsTheChunksOnThreadExit) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "c84e16a9-35d7-4b02-9f6c-a1d7e30b5c82");
+  constexpr uint32_t CHUNK_COUNT{MemPoolCache::BATCH_SIZE};
+  mempoolconf.addMemPool({CHUNK_SIZE_32, CHUNK_COUNT});
+  mempoolconf.setThreadCache(true);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+
+  std::promise<void> cached;
+  std::promise<void> done;
+  std::thread loaner([&] {
+    EXPECT_TRUE(sut->getChunk(chunkSettings_32).has_value());
+    cached.set_value();
+    done.get_future().wait();
+  });
+  cached.get_future().wait();
+
+  /// only the loaner can loan the chunks parked in its cache
+  auto chunk = sut->getChunk(chunkSettings_32);
+  ASSERT_FALSE(chunk.has_value());
+  EXPECT_EQ(chunk.error(), MemoryManager::Error::MEMPOOL_OUT_OF_CHUNKS);
+
+  done.set_value();
+  loaner.join();
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+  EXPECT_TRUE(sut->getChunk(chunkSettings_32).has_value());
+}
+
+TEST_F(MemoryManager_test, allocationProfileBypassesTheThreadCache) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "3b07d9e5-a6c1-48f2-8d39-5e1c4f72a0b6");
+  mempoolconf.addMemPool({CHUNK_SIZE_32, 10U});
+  mempoolconf.setThreadCache(true);
+  sut->configureMemoryManager(mempoolconf, *allocator, *allocator);
+  AllocationProfile profile;
+  sut->setAllocationProfile(&profile);
+
+  {
+    auto chunkStore = getChunksFromSut(3U, chunkSettings_32);
+    EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 3U);
+  }
+  EXPECT_EQ(sut->getMemPoolInfo(0U).m_usedChunks, 0U);
+
+  const auto entries = profile.getEntries();
+  ASSERT_THAT(entries.size(), Eq(1U));
+  EXPECT_THAT(entries[0].m_requestCount, Eq(3U));
+  EXPECT_THAT(entries[0].m_peakInUse, Eq(3U));
+
+  sut->setAllocationProfile(nullptr);
+}
+
 TEST(MemoryManagerEnumString_test, asStringLiteralConvertsEnumValuesToStrings) {
   ::testing::Test::RecordProperty("TEST_ID",
                                   "5f6c3942-0af5-4c48-b44c-7268191dbac5");
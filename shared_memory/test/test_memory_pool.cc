@@ -1,5 +1,12 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "memory/allocation_profile.hpp"
 #include "memory/chunk_header.hpp"
 #include "memory/memory_pool.hpp"
+#include "memory/memory_pool_cache.hpp"
 #include "shm/algorithm.hpp"
 #include "test.hpp"
 
@@ -37,12 +44,12 @@ TEST_F(MemPool_test, MempoolIndexToPointerConversionForIndexZeroWorks) {
                                   "107222a6-7a48-44f1-93c5-9a1f56f3d319");
 
   constexpr uint32_t INDEX{0};
-  constexpr uint32_t CHUNK_SIZE{128};
+  constexpr uint32_t CHUNK_STEP{128};
   uint8_t* const RAW_MEMORY_BASE{reinterpret_cast<uint8_t*>(0x7f60d90c5000ULL)};
   uint8_t* const EXPECTED_CHUNK_PTR{RAW_MEMORY_BASE};
 
   const auto* chunk =
-      MemPool::indexToPointer(INDEX, CHUNK_SIZE, RAW_MEMORY_BASE);
+      MemPool::indexToPointer(INDEX, CHUNK_STEP, RAW_MEMORY_BASE);
 
   EXPECT_THAT(chunk, Eq(EXPECTED_CHUNK_PTR));
 }
@@ -52,12 +59,12 @@ TEST_F(MemPool_test, MempoolIndexToPointerConversionForIndexOneWorks) {
                                   "fda231af-87a9-4292-be1e-e443aa7cff63");
 
   constexpr uint32_t INDEX{1};
-  constexpr uint32_t CHUNK_SIZE{128};
+  constexpr uint32_t CHUNK_STEP{128};
   uint8_t* const RAW_MEMORY_BASE{reinterpret_cast<uint8_t*>(0x7f60d90c5000ULL)};
-  uint8_t* const EXPECTED_CHUNK_PTR{RAW_MEMORY_BASE + CHUNK_SIZE};
+  uint8_t* const EXPECTED_CHUNK_PTR{RAW_MEMORY_BASE + CHUNK_STEP};
 
   const auto* chunk =
-      MemPool::indexToPointer(INDEX, CHUNK_SIZE, RAW_MEMORY_BASE);
+      MemPool::indexToPointer(INDEX, CHUNK_STEP, RAW_MEMORY_BASE);
 
   EXPECT_THAT(chunk, Eq(EXPECTED_CHUNK_PTR));
 }
@@ -70,13 +77,13 @@ TEST_F(MemPool_test,
   constexpr uint32_t INDEX{42};
   constexpr uint32_t MB{1UL << 20};
   constexpr uint64_t GB{1ULL << 30};
-  constexpr uint32_t CHUNK_SIZE{128 * MB};
+  constexpr uint32_t CHUNK_STEP{128 * MB};
   uint8_t* const RAW_MEMORY_BASE{reinterpret_cast<uint8_t*>(0x7f60d90c5000ULL)};
   uint8_t* const EXPECTED_CHUNK_PTR{RAW_MEMORY_BASE +
-                                    static_cast<uint64_t>(INDEX) * CHUNK_SIZE};
+                                    static_cast<uint64_t>(INDEX) * CHUNK_STEP};
 
   const auto* chunk =
-      MemPool::indexToPointer(INDEX, CHUNK_SIZE, RAW_MEMORY_BASE);
+      MemPool::indexToPointer(INDEX, CHUNK_STEP, RAW_MEMORY_BASE);
 
   EXPECT_THAT(chunk, Eq(EXPECTED_CHUNK_PTR));
   EXPECT_THAT(static_cast<const uint8_t*>(chunk) - RAW_MEMORY_BASE, Gt(5 * GB));
@@ -86,13 +93,13 @@ TEST_F(MemPool_test, MempoolPointerToIndexConversionForIndexZeroWorks) {
   ::testing::Test::RecordProperty("TEST_ID",
                                   "37b23350-b562-4e89-a452-2f3d328bc016");
 
-  constexpr uint32_t CHUNK_SIZE{128};
+  constexpr uint32_t CHUNK_STEP{128};
   uint8_t* const RAW_MEMORY_BASE{reinterpret_cast<uint8_t*>(0x7f60d90c5000ULL)};
   uint8_t* const CHUNK_PTR{RAW_MEMORY_BASE};
   constexpr uint32_t EXPECTED_INDEX{0};
 
   const auto index =
-      MemPool::pointerToIndex(CHUNK_PTR, CHUNK_SIZE, RAW_MEMORY_BASE);
+      MemPool::pointerToIndex(CHUNK_PTR, CHUNK_STEP, RAW_MEMORY_BASE);
 
   EXPECT_THAT(index, Eq(EXPECTED_INDEX));
 }
@@ -101,13 +108,13 @@ TEST_F(MemPool_test, MempoolPointerToIndexConversionForIndexOneWorks) {
   ::testing::Test::RecordProperty("TEST_ID",
                                   "64349d9a-1a97-4ba0-a04f-07c929befe38");
 
-  constexpr uint32_t CHUNK_SIZE{128};
+  constexpr uint32_t CHUNK_STEP{128};
   uint8_t* const RAW_MEMORY_BASE{reinterpret_cast<uint8_t*>(0x7f60d90c5000ULL)};
-  uint8_t* const CHUNK_PTR{RAW_MEMORY_BASE + CHUNK_SIZE};
+  uint8_t* const CHUNK_PTR{RAW_MEMORY_BASE + CHUNK_STEP};
   constexpr uint32_t EXPECTED_INDEX{1};
 
   const auto index =
-      MemPool::pointerToIndex(CHUNK_PTR, CHUNK_SIZE, RAW_MEMORY_BASE);
+      MemPool::pointerToIndex(CHUNK_PTR, CHUNK_STEP, RAW_MEMORY_BASE);
 
   EXPECT_THAT(index, Eq(EXPECTED_INDEX));
 }
@@ -119,14 +126,14 @@ TEST_F(MemPool_test,
 
   constexpr uint32_t MB{1UL << 20};
   constexpr uint64_t GB{1ULL << 30};
-  constexpr uint32_t CHUNK_SIZE{128 * MB};
+  constexpr uint32_t CHUNK_STEP{128 * MB};
   uint8_t* const RAW_MEMORY_BASE{reinterpret_cast<uint8_t*>(0x7f60d90c5000ULL)};
   constexpr uint32_t EXPECTED_INDEX{42};
   uint8_t* const CHUNK_PTR{RAW_MEMORY_BASE +
-                           static_cast<uint64_t>(EXPECTED_INDEX) * CHUNK_SIZE};
+                           static_cast<uint64_t>(EXPECTED_INDEX) * CHUNK_STEP};
 
   const auto index =
-      MemPool::pointerToIndex(CHUNK_PTR, CHUNK_SIZE, RAW_MEMORY_BASE);
+      MemPool::pointerToIndex(CHUNK_PTR, CHUNK_STEP, RAW_MEMORY_BASE);
 
   EXPECT_THAT(index, Eq(EXPECTED_INDEX));
   EXPECT_THAT(static_cast<const uint8_t*>(CHUNK_PTR) - RAW_MEMORY_BASE,
@@ -137,14 +144,14 @@ TEST_F(MemPool_test, MempoolCtorInitialisesTheObjectWithValuesPassedToTheCtor) {
   ::testing::Test::RecordProperty("TEST_ID",
                                   "b15b0da5-74e0-481b-87b6-53888b8a9890");
   char memory[8192];
-  BumpAllocator allocator{memory, 8192U};
+  BumpAllocator ctorAllocator{memory, 8192U};
 
-  MemPool sut(CHUNK_SIZE, NUMBER_OF_CHUNKS, allocator, allocator);
+  MemPool mempool(CHUNK_SIZE, NUMBER_OF_CHUNKS, ctorAllocator, ctorAllocator);
 
-  EXPECT_THAT(sut.getChunkSize(), Eq(CHUNK_SIZE));
-  EXPECT_THAT(sut.getChunkCount(), Eq(NUMBER_OF_CHUNKS));
-  EXPECT_THAT(sut.getMinFree(), Eq(NUMBER_OF_CHUNKS));
-  EXPECT_THAT(sut.getUsedChunks(), Eq(0U));
+  EXPECT_THAT(mempool.getChunkSize(), Eq(CHUNK_SIZE));
+  EXPECT_THAT(mempool.getChunkCount(), Eq(NUMBER_OF_CHUNKS));
+  EXPECT_THAT(mempool.getMinFree(), Eq(NUMBER_OF_CHUNKS));
+  EXPECT_THAT(mempool.getUsedChunks(), Eq(0U));
 }
 
 // TEST_F(MemPool_test,
@@ -214,6 +221,21 @@ TEST_F(MemPool_test, GetChunkMethodWhenAllTheChunksAreUsedReturnsNullPointer) {
   EXPECT_THAT(sut.getChunk(), Eq(nullptr));
 }
 
+TEST_F(MemPool_test, GetChunkMethodWhenAllTheChunksAreUsedCountsTheExhaustion) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "0a4e7c52-d9b1-4f36-8e2a-b5c17f9063d8");
+  for (uint32_t i = 0U; i < NUMBER_OF_CHUNKS; ++i) {
+    sut.getChunk();
+  }
+  EXPECT_THAT(sut.getExhaustedCount(), Eq(0U));
+
+  sut.getChunk();
+  sut.getChunk();
+
+  EXPECT_THAT(sut.getExhaustedCount(), Eq(2U));
+  EXPECT_THAT(sut.getInfo().m_exhaustedCount, Eq(2U));
+}
+
 TEST_F(MemPool_test, WritingDataToAChunkStoresTheCorrespondingDataInTheChunk) {
   ::testing::Test::RecordProperty("TEST_ID",
                                   "4550d044-d1c8-493d-b839-40509b03407f");
@@ -331,4 +353,218 @@ TEST_F(MemPool_test, GetMinFreeMethodReturnsTheNumberOfFreeChunks) {
 //           MEPOO__MEMPOOL_CHUNKSIZE_MUST_BE_MULTIPLE_OF_CHUNK_MEMORY_ALIGNMENT);
 // }
 
+TEST_F(MemPool_test, GetChunksMethodObtainsTheRequestedNumberOfChunks) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "5d0c7a0e-3f0b-4b53-9a4e-0f1b9b3c2d71");
+  constexpr uint32_t COUNT{70U};
+  std::vector<void*> chunks(COUNT, nullptr);
+
+  EXPECT_THAT(sut.getChunks(chunks.data(), COUNT), Eq(COUNT));
+  EXPECT_THAT(sut.getUsedChunks(), Eq(COUNT));
+  EXPECT_THAT(sut.getMinFree(), Eq(NUMBER_OF_CHUNKS - COUNT));
+
+  std::sort(chunks.begin(), chunks.end());
+  EXPECT_THAT(std::adjacent_find(chunks.begin(), chunks.end()),
+              Eq(chunks.end()));
+}
+
+TEST_F(MemPool_test, GetChunksMethodWhenPoolRunsOutReturnsTheRemainingChunks) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "b0e5a2d6-61c3-4f3e-8b0c-7f6c3a9d1e42");
+  std::vector<void*> chunks(NUMBER_OF_CHUNKS + 10U, nullptr);
+
+  EXPECT_THAT(sut.getChunks(chunks.data(), NUMBER_OF_CHUNKS + 10U),
+              Eq(NUMBER_OF_CHUNKS));
+  EXPECT_THAT(sut.getChunks(chunks.data(), 1U), Eq(0U));
+  EXPECT_THAT(sut.getChunk(), Eq(nullptr));
+  EXPECT_THAT(sut.getMinFree(), Eq(0U));
+}
+
+TEST_F(MemPool_test, FreeChunksMethodReturnsTheChunksToTheFreeList) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "c37b9f14-0a2e-4d6b-9c51-3e8d2f7a6b90");
+  std::vector<void*> chunks(NUMBER_OF_CHUNKS, nullptr);
+  ASSERT_THAT(sut.getChunks(chunks.data(), NUMBER_OF_CHUNKS),
+              Eq(NUMBER_OF_CHUNKS));
+
+  sut.freeChunks(chunks.data(), NUMBER_OF_CHUNKS);
+
+  EXPECT_THAT(sut.getUsedChunks(), Eq(0U));
+  EXPECT_THAT(sut.getMinFree(), Eq(0U));
+  for (uint32_t i = 0U; i < NUMBER_OF_CHUNKS; ++i) {
+    EXPECT_THAT(sut.getChunk(), Ne(nullptr));
+  }
+}
+
+TEST_F(MemPool_test, FreeChunksMethodWhenBatchContainsADoubleFreeDropsIt) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "8e41d0b3-27f5-4c8a-a6d9-15b7c04e3f28");
+  std::vector<void*> chunks(3U, nullptr);
+  ASSERT_THAT(sut.getChunks(chunks.data(), 3U), Eq(3U));
+  sut.freeChunk(chunks[1]);
+  ASSERT_THAT(sut.getUsedChunks(), Eq(2U));
+
+  std::vector<void*> batch{chunks[0], chunks[1], chunks[2], chunks[0]};
+  sut.freeChunks(batch.data(), 4U);
+
+  EXPECT_THAT(sut.getUsedChunks(), Eq(0U));
+  std::vector<void*> all(NUMBER_OF_CHUNKS + 1U, nullptr);
+  EXPECT_THAT(sut.getChunks(all.data(), NUMBER_OF_CHUNKS + 1U),
+              Eq(NUMBER_OF_CHUNKS));
+}
+
+TEST_F(MemPool_test, FreeChunkMethodWhenChunkIsFreedTwiceCountsItOnce) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "5a9d2e70-c3b8-4f16-8e04-b7f1d6a23c95");
+  void* chunk = sut.getChunk();
+  ASSERT_THAT(sut.getChunk(), Ne(nullptr));
+
+  sut.freeChunk(chunk);
+  sut.freeChunk(chunk);
+
+  EXPECT_THAT(sut.getUsedChunks(), Eq(1U));
+}
+
+TEST_F(MemPool_test, ProfileIgnoresTheReleaseOfADoubleFreedChunk) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "f3b06c2d-84e1-4a97-b5d8-6c1a29e7f043");
+  auto chunkSettings = ChunkSettings::create(8U, alignof(uint64_t));
+  ASSERT_TRUE(chunkSettings.has_value());
+  AllocationProfile profile;
+  sut.setAllocationProfile(&profile);
+  const auto loan = [&] {
+    void* chunk = sut.getChunk();
+    new (chunk) ChunkHeader(CHUNK_SIZE, chunkSettings.value());
+    profile.recordAcquire(chunkSettings.value().requiredChunkSize());
+    return chunk;
+  };
+
+  void* chunk = loan();
+  loan();
+  sut.freeChunk(chunk);
+  sut.freeChunk(chunk);
+  void* batch[2U]{loan(), chunk};
+  sut.freeChunks(batch, 2U);
+  loan();
+  loan();
+  loan();
+
+  /// one chunk is in use before the last three loans; with the double frees
+  /// counted as releases the peak would stay at 3
+  const auto entries = profile.getEntries();
+  ASSERT_THAT(entries.size(), Eq(1U));
+  EXPECT_THAT(entries[0].m_peakInUse, Eq(4U));
+  sut.setAllocationProfile(nullptr);
+}
+
+TEST_F(MemPool_test, CacheRefillsFromTheMemPoolInBatches) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "f1a6c8e2-94d7-4b03-b2e5-6d0c9a7f3b15");
+  MemPoolCache cache{sut};
+
+  auto chunk = cache.getChunk();
+
+  ASSERT_THAT(chunk, Ne(nullptr));
+  EXPECT_THAT(cache.size(), Eq(MemPoolCache::BATCH_SIZE - 1U));
+  EXPECT_THAT(sut.getUsedChunks(), Eq(MemPoolCache::BATCH_SIZE));
+}
+
+TEST_F(MemPool_test, CacheHandsOutTheLastFreedChunkFirst) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "2b9d7e40-c5f1-4a86-8e3b-a04f6d1c9e57");
+  MemPoolCache cache{sut};
+  auto first = cache.getChunk();
+  auto second = cache.getChunk();
+
+  cache.freeChunk(first);
+
+  EXPECT_THAT(cache.getChunk(), Eq(first));
+  EXPECT_THAT(second, Ne(first));
+}
+
+TEST_F(MemPool_test, CacheDrainsABatchWhenFull) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "94c0e3b7-1d58-4f2a-b6c9-8a7e2d05f413");
+  std::vector<void*> chunks(MemPoolCache::CAPACITY + 1U, nullptr);
+  ASSERT_THAT(sut.getChunks(chunks.data(), MemPoolCache::CAPACITY + 1U),
+              Eq(MemPoolCache::CAPACITY + 1U));
+  MemPoolCache cache{sut};
+
+  for (auto chunk : chunks) {
+    cache.freeChunk(chunk);
+  }
+
+  EXPECT_THAT(cache.size(), Eq(MemPoolCache::CAPACITY + 1U -
+                               MemPoolCache::BATCH_SIZE));
+  EXPECT_THAT(sut.getUsedChunks(),
+              Eq(MemPoolCache::CAPACITY + 1U - MemPoolCache::BATCH_SIZE));
+}
+
+TEST_F(MemPool_test, CacheReturnsItsChunksOnDestruction) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "6fe2b815-0c9a-4d37-a1e4-c58b3f7d2a69");
+  {
+    MemPoolCache cache{sut};
+    std::vector<void*> chunks;
+    for (uint32_t i = 0U; i < NUMBER_OF_CHUNKS; ++i) {
+      chunks.push_back(cache.getChunk());
+      ASSERT_THAT(chunks.back(), Ne(nullptr));
+    }
+    EXPECT_THAT(cache.getChunk(), Eq(nullptr));
+    EXPECT_THAT(sut.getMinFree(), Eq(0U));
+
+    for (auto chunk : chunks) {
+      cache.freeChunk(chunk);
+    }
+    EXPECT_THAT(cache.size(), Gt(0U));
+    EXPECT_THAT(sut.getUsedChunks(), Eq(cache.size()));
+  }
+  EXPECT_THAT(sut.getUsedChunks(), Eq(0U));
+}
+
+TEST_F(MemPool_test, CachesOnConcurrentThreadsNeverHandOutAChunkTwice) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "d7a35c91-8b2e-4f06-9e1d-3c4b0a6f8e22");
+  constexpr uint32_t NUMBER_OF_THREADS{4U};
+  constexpr uint32_t ITERATIONS{20000U};
+  std::atomic<uint32_t> collisions{0U};
+
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0U; t < NUMBER_OF_THREADS; ++t) {
+    threads.emplace_back([&, t] {
+      MemPoolCache cache{sut};
+      std::vector<uint32_t*> held;
+      for (uint32_t i = 0U; i < ITERATIONS; ++i) {
+        if (held.size() < 8U) {
+          auto chunk = static_cast<uint32_t*>(cache.getChunk());
+          if (chunk != nullptr) {
+            *chunk = t;
+            held.push_back(chunk);
+          }
+        } else {
+          for (auto chunk : held) {
+            if (*chunk != t) {
+              collisions.fetch_add(1U);
+            }
+            cache.freeChunk(chunk);
+          }
+          held.clear();
+        }
+      }
+      for (auto chunk : held) {
+        cache.freeChunk(chunk);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_THAT(collisions.load(), Eq(0U));
+  EXPECT_THAT(sut.getUsedChunks(), Eq(0U));
+  std::vector<void*> all(NUMBER_OF_CHUNKS + 1U, nullptr);
+  EXPECT_THAT(sut.getChunks(all.data(), NUMBER_OF_CHUNKS + 1U),
+              Eq(NUMBER_OF_CHUNKS));
+}
+
 }  // namespace
\ No newline at end of file
@@ -73,6 +73,10 @@ class MePooSegment_test : public Test {
           m_openMode(om),
           m_permissions(rights) {}
 
+    SharedMemoryObject_MOCKBuilder& memoryInfo(const MemoryInfo&) noexcept {
+      return *this;
+    }
+
     tl::expected<SharedMemoryObject_MOCK, SharedMemoryObjectError>
     create() noexcept {
       return SharedMemoryObject_MOCK(
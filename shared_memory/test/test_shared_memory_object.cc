@@ -1,6 +1,7 @@
 
 
 #include "shm/group.hpp"
+#include "shm/numa.hpp"
 #include "shm/shared_memory_object.hpp"
 #include "shm/user.hpp"
 #include "test.hpp"
@@ -24,7 +25,6 @@ TEST_F(SharedMemoryObject_Test, CTorWithValidArguments) {
                  "validShmMem", 100, shm::AccessMode::READ_WRITE,
                  shm::OpenMode::PURGE_AND_CREATE, shm::perms::none)
                  .create();
-  sleep(100);
   EXPECT_THAT(!sut.has_value(), Eq(false));
 }
 
@@ -180,4 +180,182 @@ TEST_F(SharedMemoryObject_Test, SettingPermissionsWorks) {
   EXPECT_THAT(*result, Eq(shm::perms::none));
 }
 
+TEST_F(SharedMemoryObject_Test, DefaultMemoryInfoIsInEffect) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "bd1a3c2d-17a3-4e54-8940-1b4e7e99a7c0");
+  auto sut = SharedMemoryObjectBuilder(
+                 "shmAllocate", 8, shm::AccessMode::READ_WRITE,
+                 shm::OpenMode::PURGE_AND_CREATE, shm::perms::owner_all)
+                 .create();
+
+  ASSERT_FALSE(!sut.has_value());
+  EXPECT_TRUE(sut->getMemoryInfo() == MemoryInfo());
+}
+
+TEST_F(SharedMemoryObject_Test, PrefaultedAndLockedMemoryIsUsable) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "f4cd68bf-e2c2-4885-8c68-d19204b71e3e");
+  constexpr uint64_t MEMORY_SIZE = 1024U * 1024U;
+  MemoryInfo memoryInfo;
+  memoryInfo.prefault = true;
+  memoryInfo.lockMemory = true;
+  auto sut = SharedMemoryObjectBuilder(
+                 "shmAllocate", MEMORY_SIZE, shm::AccessMode::READ_WRITE,
+                 shm::OpenMode::PURGE_AND_CREATE, shm::perms::owner_all)
+                 .memoryInfo(memoryInfo)
+                 .create();
+
+  ASSERT_FALSE(!sut.has_value());
+  EXPECT_TRUE(sut->getMemoryInfo().prefault);
+  // mlock is bound to RLIMIT_MEMLOCK, the object is usable either way
+  auto* data_ptr = static_cast<uint8_t*>(sut->getBaseAddress());
+  /// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  data_ptr[MEMORY_SIZE - 1U] = 42U;
+
+  auto sut2 = SharedMemoryObjectBuilder(
+                  "shmAllocate", MEMORY_SIZE, shm::AccessMode::READ_ONLY,
+                  shm::OpenMode::OPEN_EXISTING, shm::perms::none)
+                  .memoryInfo(memoryInfo)
+                  .create();
+
+  ASSERT_FALSE(!sut2.has_value());
+  auto* data_ptr2 = static_cast<const uint8_t*>(sut2->getBaseAddress());
+  /// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  EXPECT_THAT(data_ptr2[MEMORY_SIZE - 1U], Eq(42U));
+}
+
+TEST_F(SharedMemoryObject_Test, TransparentHugePagesAreAdvisedOrFallBack) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "44ea7ef3-3a65-4aa3-91f3-900a12219baa");
+  constexpr uint64_t MEMORY_SIZE = 4U * 1024U * 1024U;
+  MemoryInfo memoryInfo;
+  memoryInfo.hugePages = HugePages::TRANSPARENT;
+  memoryInfo.prefault = true;
+  auto sut = SharedMemoryObjectBuilder(
+                 "shmAllocate", MEMORY_SIZE, shm::AccessMode::READ_WRITE,
+                 shm::OpenMode::PURGE_AND_CREATE, shm::perms::owner_all)
+                 .memoryInfo(memoryInfo)
+                 .create();
+
+  ASSERT_FALSE(!sut.has_value());
+  EXPECT_THAT(sut->getMemoryInfo().hugePages,
+              AnyOf(Eq(HugePages::TRANSPARENT), Eq(HugePages::NONE)));
+  auto* data_ptr = static_cast<uint8_t*>(sut->getBaseAddress());
+  /// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  data_ptr[MEMORY_SIZE - 1U] = 7U;
+  /// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  EXPECT_THAT(data_ptr[MEMORY_SIZE - 1U], Eq(7U));
+}
+
+TEST_F(SharedMemoryObject_Test, HugetlbfsFallsBackWhenItIsNotAvailable) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "d44aefb4-4493-4734-bf9d-034f12e73f1c");
+  constexpr uint64_t MEMORY_SIZE = 1024U;
+  MemoryInfo memoryInfo;
+  memoryInfo.hugePages = HugePages::HUGETLBFS;
+  auto sut = SharedMemoryObjectBuilder(
+                 "shmAllocate", MEMORY_SIZE, shm::AccessMode::READ_WRITE,
+                 shm::OpenMode::PURGE_AND_CREATE, shm::perms::owner_all)
+                 .memoryInfo(memoryInfo)
+                 .create();
+
+  ASSERT_FALSE(!sut.has_value());
+  if (!SharedMemory::isHugetlbfsAvailable()) {
+    EXPECT_THAT(sut->getMemoryInfo().hugePages, Ne(HugePages::HUGETLBFS));
+  }
+  EXPECT_THAT(*sut->get_size(), Ge(MEMORY_SIZE));
+  auto* data_ptr = static_cast<uint8_t*>(sut->getBaseAddress());
+  /// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  data_ptr[0] = 13U;
+
+  // an opener with the same options finds the memory wherever it was placed
+  auto sut2 = SharedMemoryObjectBuilder(
+                  "shmAllocate", MEMORY_SIZE, shm::AccessMode::READ_ONLY,
+                  shm::OpenMode::OPEN_EXISTING, shm::perms::none)
+                  .memoryInfo(memoryInfo)
+                  .create();
+
+  ASSERT_FALSE(!sut2.has_value());
+  EXPECT_THAT(sut2->getMemoryInfo().hugePages,
+              Eq(sut->getMemoryInfo().hugePages));
+  EXPECT_THAT(*static_cast<const uint8_t*>(sut2->getBaseAddress()), Eq(13U));
+}
+
+TEST_F(SharedMemoryObject_Test,
+       HugetlbfsSegmentIsOnlyOpenedWithTheMemoryInfoItWasCreatedWith) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "7c2e9b41-5fd3-4a86-b0e7-1d84a6c3f259");
+  constexpr uint64_t MEMORY_SIZE = 2U * 1024U * 1024U;
+  MemoryInfo memoryInfo;
+  memoryInfo.hugePages = HugePages::HUGETLBFS;
+  auto segment = SharedMemoryObjectBuilder(
+                     "hugetlbfsSegment", MEMORY_SIZE,
+                     shm::AccessMode::READ_WRITE,
+                     shm::OpenMode::PURGE_AND_CREATE, shm::perms::owner_all)
+                     .memoryInfo(memoryInfo)
+                     .create();
+  ASSERT_FALSE(!segment.has_value());
+  static_cast<uint8_t*>(segment->getBaseAddress())[0] = 21U;
+
+  // what SharedMemoryUser does with the MemoryInfo of a segment mapping
+  auto consumer = SharedMemoryObjectBuilder(
+                      "hugetlbfsSegment", MEMORY_SIZE,
+                      shm::AccessMode::READ_WRITE, shm::OpenMode::OPEN_EXISTING,
+                      shm::perms::none)
+                      .memoryInfo(memoryInfo)
+                      .create();
+
+  ASSERT_FALSE(!consumer.has_value());
+  EXPECT_THAT(consumer->getMemoryInfo().hugePages,
+              Eq(segment->getMemoryInfo().hugePages));
+  EXPECT_THAT(*static_cast<const uint8_t*>(consumer->getBaseAddress()),
+              Eq(21U));
+
+  // a segment on hugetlbfs is not in /dev/shm
+  if (segment->getMemoryInfo().hugePages == HugePages::HUGETLBFS) {
+    auto defaultConsumer =
+        SharedMemoryObjectBuilder("hugetlbfsSegment", MEMORY_SIZE,
+                                  shm::AccessMode::READ_WRITE,
+                                  shm::OpenMode::OPEN_EXISTING,
+                                  shm::perms::none)
+            .create();
+    EXPECT_FALSE(defaultConsumer.has_value());
+  }
+}
+
+TEST_F(SharedMemoryObject_Test, NumaPolicyIsAppliedOrFallsBackToFirstTouch) {
+  ::testing::Test::RecordProperty("TEST_ID",
+                                  "50e5207d-b351-465e-9e6f-9e6d81c2a2d0");
+  constexpr uint64_t MEMORY_SIZE = 1024U * 1024U;
+  MemoryInfo memoryInfo;
+  memoryInfo.numaPolicy = NumaPolicy::BIND;
+  memoryInfo.numaNode = 0U;
+  memoryInfo.prefault = true;
+  auto sut = SharedMemoryObjectBuilder(
+                 "shmAllocate", MEMORY_SIZE, shm::AccessMode::READ_WRITE,
+                 shm::OpenMode::PURGE_AND_CREATE, shm::perms::owner_all)
+                 .memoryInfo(memoryInfo)
+                 .create();
+
+  ASSERT_FALSE(!sut.has_value());
+  EXPECT_THAT(sut->getMemoryInfo().numaPolicy,
+              AnyOf(Eq(NumaPolicy::BIND), Eq(NumaPolicy::DEFAULT)));
+
+  // a node which does not exist leaves the placement to first touch
+  memoryInfo.numaNode = MAX_NUMBER_OF_NUMA_NODES - 1U;
+  auto sut2 = SharedMemoryObjectBuilder(
+                  "shmAllocate2", MEMORY_SIZE, shm::AccessMode::READ_WRITE,
+                  shm::OpenMode::PURGE_AND_CREATE, shm::perms::owner_all)
+                  .memoryInfo(memoryInfo)
+                  .create();
+
+  ASSERT_FALSE(!sut2.has_value());
+  EXPECT_THAT(sut2->getMemoryInfo().numaPolicy, Eq(NumaPolicy::DEFAULT));
+  auto* data_ptr = static_cast<uint8_t*>(sut2->getBaseAddress());
+  /// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  data_ptr[MEMORY_SIZE - 1U] = 3U;
+  /// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  EXPECT_THAT(data_ptr[MEMORY_SIZE - 1U], Eq(3U));
+}
+
 }  // namespace shm_test
\ No newline at end of file
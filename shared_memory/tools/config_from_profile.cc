@@ -0,0 +1,78 @@
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "memory/allocation_profile.hpp"
+#include "memory/memory_manager.hpp"
+
+namespace {
+void printUsage(const char* const program) {
+  std::cerr << "usage: " << program
+            << " <profile> [headroom = 1.25] [max number of mempools = "
+            << shm::memory::Config::MAX_NUMBER_OF_MEMPOOLS << "]" << std::endl;
+}
+}  // namespace
+
+/// turns a profile written by AllocationProfile::write into the mempool
+/// configuration which serves it with the least memory
+///   shm-config-from-profile <profile> [headroom] [max number of mempools]
+int main(int argc, char** argv) {
+  using namespace shm::memory;
+
+  if (argc < 2 || argc > 4) {
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream file(argv[1]);
+  if (!file) {
+    std::cerr << "can't open " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+  auto entries = AllocationProfile::read(file);
+  if (!entries.has_value()) {
+    std::cerr << argv[1] << " is not an allocation profile" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  double headroom{1.25};
+  uint32_t maxNumberOfMemPools{Config::MAX_NUMBER_OF_MEMPOOLS};
+  try {
+    if (argc > 2) {
+      headroom = std::stod(argv[2]);
+    }
+    if (argc > 3) {
+      maxNumberOfMemPools = static_cast<uint32_t>(std::stoul(argv[3]));
+    }
+  } catch (const std::exception&) {
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (headroom < 1.0 || maxNumberOfMemPools == 0U) {
+    std::cerr << "the headroom must be at least 1.0 and at least one mempool "
+                 "is required"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto config = AllocationProfile::toConfig(entries.value(), headroom,
+                                                  maxNumberOfMemPools);
+  std::cout << "# chunk-payload size, chunk count" << std::endl;
+  for (const auto& entry : config.m_mempoolConfig) {
+    std::cout << entry.m_size << ' ' << entry.m_chunkCount << std::endl;
+  }
+
+  Config defaults;
+  defaults.setDefaults();
+  std::cout << "# required memory: "
+            << MemoryManager::requiredFullMemorySize(config)
+            << " bytes, default config: "
+            << MemoryManager::requiredFullMemorySize(defaults) << " bytes"
+            << std::endl;
+  return EXIT_SUCCESS;
+}